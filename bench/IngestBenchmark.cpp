@@ -0,0 +1,207 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PathIngest.h"
+#include "SvgScanner.h"
+
+// ingest benchmark
+
+// Writes a corpus of small path and SVG files to a temporary directory, reads
+// and parses it once file by file as a baseline, then through PathIngest, and
+// reports both. Usage: IngestBenchmark [file count] [parser threads]
+
+namespace {
+
+const std::string randomPath(
+    std::mt19937& random)
+{
+    std::uniform_real_distribution<float> coordinate(0, 100);
+
+    std::ostringstream path;
+
+    const auto contours = 1 + random() % 4;
+
+    for (size_t contour = 0; contour < contours; ++contour) {
+
+        path << "M" << coordinate(random) << " " << coordinate(random);
+
+        const auto segments = 4 + random() % 24;
+
+        for (size_t segment = 0; segment < segments; ++segment) {
+
+            if (random() % 2 == 0) {
+
+                path << " L" << coordinate(random) << "," << coordinate(random);
+            } else {
+
+                path << " C" << coordinate(random) << " " << coordinate(random) << " " << coordinate(random) << " " << coordinate(random) << " " << coordinate(random) << " " << coordinate(random);
+            }
+        }
+
+        path << " Z ";
+    }
+
+    return path.str();
+}
+
+const std::vector<std::string> writeCorpus(
+    const std::filesystem::path& directory,
+    size_t count)
+{
+    std::mt19937 random(7);
+
+    std::vector<std::string> files;
+
+    files.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+
+        const auto svg = i % 2 == 0;
+
+        const auto file = (directory / ("icon" + std::to_string(i) + (svg ? ".svg" : ".path"))).string();
+
+        std::ofstream out(file, std::ios::binary);
+
+        if (svg) {
+
+            out << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 100 100\">\n";
+
+            const auto paths = 1 + random() % 3;
+
+            for (size_t path = 0; path < paths; ++path) {
+
+                out << "  <path fill-rule=\"evenodd\" d=\"" << randomPath(random) << "\"/>\n";
+            }
+
+            out << "</svg>\n";
+        } else {
+
+            out << randomPath(random);
+        }
+
+        files.push_back(file);
+    }
+
+    return files;
+}
+
+// the way the nightly job worked: read a file, parse it, repeat
+
+const size_t parseSerially(
+    const std::vector<std::string>& files)
+{
+    size_t paths = 0;
+
+    for (const auto& file : files) {
+
+        std::ifstream in(file, std::ios::binary);
+
+        std::ostringstream contents;
+
+        contents << in.rdbuf();
+
+        const auto source = contents.str();
+
+        const auto parse = [&](std::string_view data) {
+            const auto [subPaths, error] = PathParser::parsePathFromSource(data);
+
+            paths += subPaths ? 1 : 0;
+        };
+
+        if (file.ends_with(".svg")) {
+
+            SvgScanner::scanDocument(source, [&](const SvgPathElement& element) { parse(element.data); });
+        } else {
+
+            parse(source);
+        }
+    }
+
+    return paths;
+}
+
+const double secondsSince(
+    std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(
+    int argc,
+    char** argv)
+{
+    const auto count = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : size_t(20000);
+
+    PathIngestOptions options;
+
+    options.parserThreads = argc > 2 ? size_t(std::strtoull(argv[2], nullptr, 10)) : 0;
+
+    const auto directory = std::filesystem::temp_directory_path() / ("sarlacc-ingest-" + std::to_string(std::random_device()()));
+
+    std::filesystem::create_directories(directory);
+
+    const auto files = writeCorpus(directory, count);
+
+    size_t bytes = 0;
+
+    for (const auto& file : files) {
+
+        bytes += std::filesystem::file_size(file);
+    }
+
+    const std::string_view build = SARLACC_BUILD_TYPE;
+
+    if (build.empty() || build == "Debug") {
+
+        std::fprintf(stderr, "warning: not an optimised build, configure with -DCMAKE_BUILD_TYPE=Release\n");
+    }
+
+    std::printf("build:  %s\n", build.empty() ? "unspecified" : SARLACC_BUILD_TYPE);
+
+    std::printf("corpus: %zu files, %.1f MB in %s\n", files.size(), bytes / 1e6, directory.c_str());
+
+    ///
+
+    auto start = std::chrono::steady_clock::now();
+
+    const auto serialPaths = parseSerially(files);
+
+    const auto serialSeconds = secondsSince(start);
+
+    std::printf("serial:   %zu paths in %.3f s, %.0f files/s, %.1f MB/s\n", serialPaths, serialSeconds, files.size() / serialSeconds, bytes / 1e6 / serialSeconds);
+
+    start = std::chrono::steady_clock::now();
+
+    size_t ingestPaths = 0, failures = 0;
+
+    {
+        PathIngest ingest(files, options);
+
+        while (const auto result = ingest.next()) {
+
+            ingestPaths += result->paths.size();
+
+            failures += result->error ? 1 : 0;
+        }
+
+        const auto ingestSeconds = secondsSince(start);
+
+        std::printf("pipeline: %zu paths in %.3f s, %.0f files/s, %.1f MB/s (%s, %zu failed)\n", ingestPaths, ingestSeconds, files.size() / ingestSeconds, bytes / 1e6 / ingestSeconds, ingest.usesIoUring() ? "io_uring" : "pread", failures);
+
+        std::printf("speedup:  %.2fx\n", serialSeconds / ingestSeconds);
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return ingestPaths == serialPaths && failures == 0 ? 0 : 1;
+}
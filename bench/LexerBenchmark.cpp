@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "KeywordTrie.h"
+#include "Parsing.h"
+#include "Path.h"
+#include "PathCorpus.h"
+#include "PerfCounters.h"
+
+// lexer benchmark
+
+// Cycles per byte for Lexer<T> over small DSL inputs of the kind it is used
+// for, with a large keyword set matched both as a list and as a KeywordTrie,
+// and for PathLexer over generated path data, both the hand-written lexer and
+// the table generated from its rules. Cycles come from the hardware counters
+// where the machine allows them, otherwise from the time stamp counter, whose
+// reference cycles run at a fixed rate rather than the core clock.
+// Usage: LexerBenchmark [seconds per case]
+
+namespace {
+
+struct DslToken {
+    enum class Kind {
+        Keyword,
+        Identifier,
+        Number,
+        String,
+        Operator,
+    };
+
+    Kind kind;
+    std::string_view value;
+};
+
+const bool isIdentifierHead(
+    char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+const bool isIdentifierTail(
+    char c)
+{
+    return isIdentifierHead(c) || (c >= '0' && c <= '9');
+}
+
+const bool isDigit(
+    char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+const std::vector<std::string> languageKeywords = { "let", "if", "else", "return", "fn", "true", "false" };
+
+// a query language's worth of keywords, where trying each in turn starts to
+// show
+
+constexpr std::string_view queryKeywords[] = {
+    "add", "all", "alter", "and", "any", "as", "asc", "between", "by", "case",
+    "check", "column", "constraint", "create", "cross", "default", "delete", "desc", "distinct", "drop",
+    "else", "end", "exists", "foreign", "from", "full", "group", "having", "in", "index",
+    "inner", "insert", "into", "is", "join", "key", "left", "like", "limit", "not",
+    "null", "on", "or", "order", "outer", "primary", "references", "right", "select", "set",
+    "table", "then", "union", "unique", "update", "values", "view", "when", "where", "with",
+};
+
+constexpr auto queryKeywordTrie = makeKeywordTrie<queryKeywords>();
+
+// longest first, since a list match takes the first name that fits
+
+const std::vector<std::string> queryKeywordList = []() {
+    std::vector<std::string> list(std::begin(queryKeywords), std::end(queryKeywords));
+
+    std::stable_sort(list.begin(), list.end(), [](const auto& a, const auto& b) { return a.size() > b.size(); });
+
+    return list;
+}();
+
+// A lexer for a small expression and configuration language, written against
+// Lexer<T> the way a DSL front end in this library would be. `keywords` is
+// anything Lexer<T>::match takes a keyword set as.
+
+template <typename Keywords>
+void lexDsl(
+    std::string_view source,
+    std::vector<DslToken>& tokens,
+    const Keywords& keywords)
+{
+    Lexer<DslToken> lexer(source);
+
+    tokens.clear();
+
+    while (!lexer.isEof()) {
+
+        const auto start = size_t(lexer.position());
+
+        if (lexer.match([](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; })) {
+
+            lexer.increment();
+
+            continue;
+        }
+
+        if (lexer.match('#')) {
+
+            while (!lexer.isEof() && !lexer.match('\n')) {
+
+                lexer.increment();
+            }
+
+            continue;
+        }
+
+        if (lexer.match(isIdentifierHead)) {
+
+            const auto keyword = lexer.match(keywords);
+
+            do {
+
+                lexer.increment();
+            } while (lexer.match(isIdentifierTail));
+
+            const auto value = source.substr(start, size_t(lexer.position()) - start);
+
+            tokens.push_back({ keyword && keyword->size() == value.size() ? DslToken::Kind::Keyword : DslToken::Kind::Identifier, value });
+
+            continue;
+        }
+
+        if (lexer.match(isDigit)) {
+
+            while (lexer.match(isDigit) || (lexer.match('.') && lexer.match(isDigit, 1))) {
+
+                lexer.increment();
+            }
+
+            tokens.push_back({ DslToken::Kind::Number, source.substr(start, size_t(lexer.position()) - start) });
+
+            continue;
+        }
+
+        if (lexer.match('"')) {
+
+            lexer.increment();
+
+            while (!lexer.isEof() && !lexer.match('"')) {
+
+                lexer.increment(lexer.match('\\') ? 2 : 1);
+            }
+
+            lexer.increment();
+
+            tokens.push_back({ DslToken::Kind::String, source.substr(start, std::min(size_t(lexer.position()), source.size()) - start) });
+
+            continue;
+        }
+
+        const auto length = lexer.match("==") || lexer.match("!=") || lexer.match("<=") || lexer.match(">=") || lexer.match("->") ? 2 : 1;
+
+        lexer.increment(length);
+
+        tokens.push_back({ DslToken::Kind::Operator, source.substr(start, std::min(size_t(length), source.size() - start)) });
+    }
+}
+
+const std::string configInput()
+{
+    std::string out;
+
+    for (auto i = 0; i < 4000; ++i) {
+
+        out += "# section " + std::to_string(i) + "\n";
+
+        out += "name_" + std::to_string(i) + " = \"value \\\"" + std::to_string(i * 7) + "\\\"\"\n";
+
+        out += "width = " + std::to_string(i % 640) + "." + std::to_string(i % 10) + "\n";
+
+        out += "enabled = " + std::string(i % 3 == 0 ? "true" : "false") + "\n";
+    }
+
+    return out;
+}
+
+const std::string queryInput()
+{
+    std::string out;
+
+    size_t word = 0;
+
+    for (auto i = 0; i < 4000; ++i) {
+
+        // identifiers that share prefixes with keywords, as column names do
+
+        out += "select " + std::string(queryKeywords[word++ % std::size(queryKeywords)]) + "_id, total from orders_" + std::to_string(i);
+
+        out += " where " + std::string(queryKeywords[word++ % std::size(queryKeywords)]) + " is not null and total between 10 and 20";
+
+        out += " group by " + std::string(queryKeywords[word++ % std::size(queryKeywords)]) + " order by total desc limit 5;\n";
+    }
+
+    return out;
+}
+
+const std::string expressionInput()
+{
+    std::string out;
+
+    for (auto i = 0; i < 4000; ++i) {
+
+        out += "fn step" + std::to_string(i) + "(x, y) -> {\n";
+
+        out += "    let d = x * x + y * y - " + std::to_string(i) + ".5;\n";
+
+        out += "    if d <= 0 { return x; } else { return (y != d) == false; }\n";
+
+        out += "}\n";
+    }
+
+    return out;
+}
+
+///
+
+// Times `body` over `bytes` until `seconds` pass and returns cycles and
+// nanoseconds per byte.
+
+template <typename Body>
+const std::pair<double, double> perByte(
+    const PerfCounters& counters,
+    size_t bytes,
+    double seconds,
+    const Body& body)
+{
+    PerfCounterSample sample;
+
+    size_t iterations = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+#if defined(__x86_64__) || defined(__i386__)
+    const auto tscStart = __rdtsc();
+#endif
+
+    double elapsed = 0;
+
+    do {
+
+        {
+            PerfCounterScope scope(counters, sample);
+
+            body();
+        }
+
+        ++iterations;
+
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+
+    const auto total = double(bytes) * double(iterations);
+
+    auto cycles = -1.0;
+
+    if (const auto counted = sample.get(PerfCounter::Cycles)) {
+
+        cycles = double(*counted) / total;
+    } else {
+
+#if defined(__x86_64__) || defined(__i386__)
+        cycles = double(__rdtsc() - tscStart) / total;
+#endif
+    }
+
+    return { cycles, elapsed * 1e9 / total };
+}
+
+}
+
+int main(
+    int argc,
+    char** argv)
+{
+    const auto seconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+
+    PerfCounters counters;
+
+    const std::string_view build = SARLACC_BUILD_TYPE;
+
+    if (build.empty() || build == "Debug") {
+
+        std::fprintf(stderr, "warning: not an optimised build, configure with -DCMAKE_BUILD_TYPE=Release\n");
+    }
+
+    std::printf("build: %s\n", build.empty() ? "unspecified" : SARLACC_BUILD_TYPE);
+
+    std::printf("cycles from %s\n\n", counters.has(PerfCounter::Cycles) ? "hardware counters" : "the time stamp counter (reference cycles)");
+
+    std::printf("%-52s %10s %12s %10s\n", "input", "bytes", "cycles/B", "ns/B");
+
+    const auto report = [](const char* name, size_t bytes, std::pair<double, double> result) {
+        std::printf("%-52s %10zu %12.2f %10.3f\n", name, bytes, result.first, result.second);
+    };
+
+    std::vector<DslToken> tokens;
+
+    const auto config = configInput();
+
+    report("dsl/config", config.size(), perByte(counters, config.size(), seconds, [&]() { lexDsl(config, tokens, languageKeywords); }));
+
+    const auto expressions = expressionInput();
+
+    report("dsl/expressions", expressions.size(), perByte(counters, expressions.size(), seconds, [&]() { lexDsl(expressions, tokens, languageKeywords); }));
+
+    const auto query = queryInput();
+
+    report("dsl/query, keyword list", query.size(), perByte(counters, query.size(), seconds, [&]() { lexDsl(query, tokens, queryKeywordList); }));
+
+    report("dsl/query, keyword trie", query.size(), perByte(counters, query.size(), seconds, [&]() { lexDsl(query, tokens, queryKeywordTrie); }));
+
+    ///
+
+    for (const auto& benchmark : PathCorpus::standardCases()) {
+
+        if (benchmark.options.commands < 1000) {
+
+            continue;
+        }
+
+        const auto source = PathCorpus::generate(benchmark.options);
+
+        const auto name = "path/" + benchmark.name;
+
+        report(name.c_str(), source.size(), perByte(counters, source.size(), seconds, [&]() {
+            const auto lexed = PathLexer::lexFromSource(source);
+        }));
+
+        const auto tableName = name + ", table";
+
+        report(tableName.c_str(), source.size(), perByte(counters, source.size(), seconds, [&]() {
+            const auto lexed = PathLexer::lexFromSourceWithTable(source);
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "Path.h"
+#include "PathCorpus.h"
+#include "PerfCounters.h"
+
+// parse benchmark
+
+// Lexing, parsing and end-to-end throughput over the synthetic corpus, in MB of
+// path data per second.
+//
+// Usage: ParseBenchmark [--filter text] [--time seconds] [--save file]
+//                       [--baseline file] [--counters]
+//
+// --save writes the results as a baseline; --baseline reads one back and shows
+// each result against it. --counters adds hardware counters per input byte for
+// the lex and parse phases, where the machine allows them.
+//
+// Configure with -DCMAKE_BUILD_TYPE=Release: the build type is printed and
+// saved with the results, and comparing across build types is warned about.
+
+namespace {
+
+struct Result {
+    double lex = 0;
+    double parse = 0;
+    double endToEnd = 0;
+};
+
+// Runs `body` until `seconds` have passed, at least once, and returns MB/s.
+
+template <typename Body>
+const double throughput(
+    size_t bytes,
+    double seconds,
+    const Body& body)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    size_t iterations = 0;
+
+    double elapsed = 0;
+
+    do {
+
+        body();
+
+        ++iterations;
+
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+
+    return double(bytes) * double(iterations) / elapsed / 1e6;
+}
+
+// The results by case name, and the build type they were measured with.
+
+const std::tuple<std::map<std::string, Result>, std::string> readBaseline(
+    const std::string& file)
+{
+    std::map<std::string, Result> baseline;
+
+    std::string build;
+
+    std::ifstream in(file);
+
+    std::string line;
+
+    while (std::getline(in, line)) {
+
+        std::istringstream fields(line);
+
+        std::string name;
+
+        Result result;
+
+        if (line.starts_with("build ")) {
+
+            build = line.substr(6);
+        } else if (fields >> name >> result.lex >> result.parse >> result.endToEnd) {
+
+            baseline[name] = result;
+        }
+    }
+
+    return { baseline, build };
+}
+
+const std::string change(
+    double value,
+    const Result* baseline,
+    double Result::*field)
+{
+    if (baseline == nullptr || baseline->*field <= 0) {
+
+        return "";
+    }
+
+    char buffer[32];
+
+    std::snprintf(buffer, sizeof(buffer), " (%+.1f%%)", (value / (baseline->*field) - 1) * 100);
+
+    return buffer;
+}
+
+}
+
+int main(
+    int argc,
+    char** argv)
+{
+    std::string filter, save, baselineFile;
+
+    auto seconds = 0.25;
+
+    auto counters = false;
+
+    for (auto i = 1; i < argc; ++i) {
+
+        const std::string option = argv[i];
+
+        const auto hasValue = i + 1 < argc;
+
+        if (option == "--filter" && hasValue) {
+
+            filter = argv[++i];
+        } else if (option == "--time" && hasValue) {
+
+            seconds = std::atof(argv[++i]);
+        } else if (option == "--save" && hasValue) {
+
+            save = argv[++i];
+        } else if (option == "--baseline" && hasValue) {
+
+            baselineFile = argv[++i];
+        } else if (option == "--counters") {
+
+            counters = true;
+        } else {
+
+            std::fprintf(stderr, "unknown option %s\n", option.c_str());
+
+            return 2;
+        }
+    }
+
+    const std::string_view build = SARLACC_BUILD_TYPE;
+
+    std::printf("build: %s\n\n", build.empty() ? "unspecified" : SARLACC_BUILD_TYPE);
+
+    if (build.empty() || build == "Debug") {
+
+        std::fprintf(stderr, "warning: not an optimised build, configure with -DCMAKE_BUILD_TYPE=Release\n");
+    }
+
+    const auto [baseline, baselineBuild] = baselineFile.empty() ? std::tuple<std::map<std::string, Result>, std::string> { } : readBaseline(baselineFile);
+
+    if (!baselineFile.empty() && baselineBuild != build) {
+
+        std::fprintf(stderr, "warning: the baseline was measured in a %s build\n", baselineBuild.empty() ? "unknown" : baselineBuild.c_str());
+    }
+
+    std::ofstream saved;
+
+    if (!save.empty()) {
+
+        saved.open(save);
+
+        saved << "build " << build << "\n";
+    }
+
+    std::optional<PerfCounters> perf;
+
+    if (counters) {
+
+        perf.emplace();
+
+        if (!perf->available()) {
+
+            std::fprintf(stderr, "hardware counters are unavailable here, check perf_event_paranoid\n");
+        }
+    }
+
+    std::printf("%-40s %10s %18s %18s %18s\n", "case", "bytes", "lex MB/s", "parse MB/s", "end-to-end MB/s");
+
+    auto failed = false;
+
+    for (const auto& benchmark : PathCorpus::standardCases()) {
+
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+
+            continue;
+        }
+
+        const auto source = PathCorpus::generate(benchmark.options);
+
+        // a corpus the parser rejects would only measure how fast it fails
+
+        const auto [checked, error] = PathParser::parsePathFromSource(source);
+
+        if (error || !checked) {
+
+            const auto message = error ? error->message() : std::string_view("no paths");
+
+            std::fprintf(stderr, "%s: %.*s\n", benchmark.name.c_str(), int(message.size()), message.data());
+
+            failed = true;
+
+            continue;
+        }
+
+        ///
+
+        Result result;
+
+        result.lex = throughput(source.size(), seconds, [&]() {
+            const auto lexed = PathLexer::lexFromSource(source);
+        });
+
+        const auto lexed = PathLexer::lexFromSource(source);
+
+        const auto& tokens = std::get<0>(lexed);
+
+        result.parse = throughput(source.size(), seconds, [&]() {
+            const auto parsed = PathParser::parsePathFromTokens(source, tokens);
+        });
+
+        result.endToEnd = throughput(source.size(), seconds, [&]() {
+            const auto parsed = PathParser::parsePathFromSource(source);
+        });
+
+        ///
+
+        const auto found = baseline.find(benchmark.name);
+
+        const auto* previous = found != baseline.end() ? &found->second : nullptr;
+
+        std::printf("%-40s %10zu %8.1f%-10s %8.1f%-10s %8.1f%-10s\n",
+            benchmark.name.c_str(),
+            source.size(),
+            result.lex,
+            change(result.lex, previous, &Result::lex).c_str(),
+            result.parse,
+            change(result.parse, previous, &Result::parse).c_str(),
+            result.endToEnd,
+            change(result.endToEnd, previous, &Result::endToEnd).c_str());
+
+        if (perf && perf->available()) {
+
+            // enough repeats to cover a few megabytes, so small cases are not
+            // all setup
+
+            const auto repeats = std::max<size_t>(1, (4 << 20) / source.size());
+
+            PerfCounterSample lexSample, parseSample;
+
+            for (size_t i = 0; i < repeats; ++i) {
+
+                PerfCounterScope scope(*perf, lexSample);
+
+                const auto relexed = PathLexer::lexFromSource(source);
+            }
+
+            for (size_t i = 0; i < repeats; ++i) {
+
+                PerfCounterScope scope(*perf, parseSample);
+
+                const auto parsed = PathParser::parsePathFromTokens(source, tokens);
+            }
+
+            std::printf("    lex    %s\n", lexSample.summary(source.size() * repeats).c_str());
+
+            std::printf("    parse  %s\n", parseSample.summary(source.size() * repeats).c_str());
+        }
+
+        if (saved) {
+
+            saved << benchmark.name << " " << result.lex << " " << result.parse << " " << result.endToEnd << "\n";
+        }
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,388 @@
+#include "PathCorpus.h"
+
+#include <cmath>
+#include <cstdlib>
+
+// synthetic corpus
+
+namespace {
+
+// Numbers are generated and written as whole millionths in integers, so no
+// floating point rounding, contraction or printf behaviour can make one
+// platform's corpus differ from another's.
+
+constexpr int64_t unit = 1'000'000;
+
+constexpr int64_t powerOfTen(
+    int exponent)
+{
+    int64_t value = 1;
+
+    for (auto i = 0; i < exponent; ++i) {
+        value *= 10;
+    }
+
+    return value;
+}
+
+// splitmix64, for the same sequence everywhere
+
+class Random {
+public:
+    explicit Random(
+        uint64_t seed)
+        : m_state(seed)
+    {
+    }
+
+    uint64_t next()
+    {
+        auto z = (m_state += 0x9e3779b97f4a7c15ull);
+
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+        return z ^ (z >> 31);
+    }
+
+    size_t below(
+        size_t count)
+    {
+        return size_t(next() % count);
+    }
+
+    // [low, high), or low for an empty range
+
+    int64_t between(
+        int64_t low,
+        int64_t high)
+    {
+        return high > low ? low + int64_t(next() % uint64_t(high - low)) : low;
+    }
+
+private:
+    uint64_t m_state;
+};
+
+class Writer {
+public:
+    Writer(
+        const PathCorpusOptions& options,
+        Random& random,
+        std::string& out)
+        : m_options(options)
+        , m_random(random)
+        , m_out(out)
+    {
+    }
+
+    void command(
+        char letter)
+    {
+        switch (m_options.spacing) {
+        case PathCorpusSpacing::Compact:
+            break;
+
+        case PathCorpusSpacing::Commas:
+            if (!m_out.empty()) {
+
+                m_out += ' ';
+            }
+            break;
+
+        case PathCorpusSpacing::Loose:
+            if (!m_out.empty()) {
+
+                m_out += "\n\t";
+            }
+            break;
+        }
+
+        m_out += letter;
+
+        m_first = true;
+    }
+
+    // the parser only takes a comma between the two numbers of a pair; values
+    // are in millionths
+
+    void number(
+        int64_t value,
+        bool pairSecond = false)
+    {
+        if (!m_first) {
+
+            switch (m_options.spacing) {
+            case PathCorpusSpacing::Compact:
+                m_out += ' ';
+                break;
+
+            case PathCorpusSpacing::Commas:
+                m_out += pairSecond ? "," : " ";
+                break;
+
+            case PathCorpusSpacing::Loose:
+                m_out += pairSecond && m_random.below(2) == 0 ? " , " : "  ";
+                break;
+            }
+        } else if (m_options.spacing != PathCorpusSpacing::Compact) {
+
+            m_out += m_options.spacing == PathCorpusSpacing::Loose ? "  " : " ";
+        }
+
+        m_first = false;
+
+        format(value);
+    }
+
+    void point(
+        int64_t x,
+        int64_t y)
+    {
+        number(x);
+
+        number(y, true);
+    }
+
+    void flag(
+        bool value)
+    {
+        number(value ? unit : 0);
+    }
+
+private:
+    void format(
+        int64_t value)
+    {
+        switch (m_options.numbers) {
+        case PathCorpusNumbers::Integers:
+            fixed(value, 0);
+            break;
+
+        case PathCorpusNumbers::Decimals:
+            fixed(value, 2);
+            break;
+
+        case PathCorpusNumbers::Precise:
+            fixed(value, 6);
+            break;
+
+        case PathCorpusNumbers::Scientific: {
+            // no '+' in positive exponents, which path data allows but the
+            // lexer does not take
+            const auto exponent = int(m_random.below(5)) - 2;
+
+            fixed(value, 3, exponent);
+
+            m_out += 'e';
+
+            m_out += std::to_string(exponent);
+            break;
+        }
+        }
+    }
+
+    // `value` millionths over 10^exponent, rounded half away from zero to
+    // `decimals` places; zero is written unsigned.
+
+    void fixed(
+        int64_t value,
+        int decimals,
+        int exponent = 0)
+    {
+        const auto divisor = powerOfTen(6 - decimals + exponent);
+
+        const auto magnitude = (std::abs(value) + divisor / 2) / divisor;
+
+        if (value < 0 && magnitude != 0) {
+
+            m_out += '-';
+        }
+
+        const auto scale = powerOfTen(decimals);
+
+        m_out += std::to_string(magnitude / scale);
+
+        if (decimals == 0) {
+
+            return;
+        }
+
+        const auto fraction = std::to_string(magnitude % scale);
+
+        m_out += '.';
+
+        m_out.append(size_t(decimals) - fraction.size(), '0');
+
+        m_out += fraction;
+    }
+
+    const PathCorpusOptions& m_options;
+
+    Random& m_random;
+
+    std::string& m_out;
+
+    bool m_first = true;
+};
+
+}
+
+const std::string PathCorpus::generate(
+    const PathCorpusOptions& options)
+{
+    Random random(options.seed);
+
+    std::string out;
+
+    out.reserve(options.commands * 24);
+
+    Writer writer(options, random, out);
+
+    const auto extent = int64_t(std::llround(options.extent * unit));
+
+    const auto step = extent / 20;
+
+    int64_t x = 0, y = 0;
+
+    // new contours every so often, as real outlines have
+
+    size_t contourLeft = 0;
+
+    const auto coordinate = [&]() { return random.between(0, extent); };
+
+    const auto delta = [&]() { return random.between(-step, step); };
+
+    const auto absolutePoint = [&]() {
+        x = coordinate();
+
+        y = coordinate();
+
+        writer.point(x, y);
+    };
+
+    for (size_t i = 0; i < options.commands; ++i) {
+
+        if (contourLeft == 0) {
+
+            if (i > 0) {
+
+                writer.command(random.below(2) == 0 ? 'Z' : 'z');
+
+                if (++i >= options.commands) {
+
+                    break;
+                }
+            }
+
+            writer.command('M');
+
+            absolutePoint();
+
+            contourLeft = 8 + random.below(32);
+
+            continue;
+        }
+
+        --contourLeft;
+
+        ///
+
+        const auto relative = options.mix == PathCorpusMix::Mixed && random.below(2) == 0;
+
+        const auto pick = random.below(100);
+
+        char letter;
+
+        if (options.mix == PathCorpusMix::Lines) {
+
+            letter = pick < 70 ? 'L' : pick < 85 ? 'H' : 'V';
+        } else if (options.mix == PathCorpusMix::Curves) {
+
+            letter = pick < 40 ? 'C' : pick < 60 ? 'S' : pick < 80 ? 'Q' : pick < 90 ? 'T' : 'L';
+        } else {
+
+            letter = "LLHVCCSQTA"[pick % 10];
+        }
+
+        writer.command(relative ? char(letter + ('a' - 'A')) : letter);
+
+        // lines and curves sometimes carry a second segment on one letter
+
+        const auto segments = (letter == 'L' || letter == 'C' || letter == 'Q') && random.below(4) == 0 ? 2 : 1;
+
+        for (auto segment = 0; segment < segments; ++segment) {
+
+            const auto point = [&]() {
+                if (relative) {
+
+                    writer.point(delta(), delta());
+                } else {
+
+                    absolutePoint();
+                }
+            };
+
+            switch (letter) {
+            case 'L':
+                point();
+                break;
+
+            // the parser takes smooth quadratics two points at a time
+            case 'T':
+                point();
+                point();
+                break;
+
+            case 'H':
+                writer.number(relative ? delta() : (x = coordinate()));
+                break;
+
+            case 'V':
+                writer.number(relative ? delta() : (y = coordinate()));
+                break;
+
+            case 'C':
+                point();
+                point();
+                point();
+                break;
+
+            case 'S':
+            case 'Q':
+                point();
+                point();
+                break;
+
+            case 'A':
+                writer.number(random.between(unit, step));
+                writer.number(random.between(unit, step));
+                writer.number(random.between(0, 360 * unit));
+                writer.flag(random.below(2) == 0);
+                writer.flag(random.below(2) == 0);
+                point();
+                break;
+            }
+        }
+    }
+
+    return out;
+}
+
+const std::vector<PathCorpusCase> PathCorpus::standardCases()
+{
+    const auto make = [](const char* name, uint64_t seed, size_t commands, PathCorpusMix mix, PathCorpusNumbers numbers, PathCorpusSpacing spacing) {
+        return PathCorpusCase { name, { seed, commands, mix, numbers, spacing, 1000 } };
+    };
+
+    return {
+        make("icon/mixed/decimals/commas", 1, 24, PathCorpusMix::Mixed, PathCorpusNumbers::Decimals, PathCorpusSpacing::Commas),
+        make("glyph/curves/integers/compact", 2, 120, PathCorpusMix::Curves, PathCorpusNumbers::Integers, PathCorpusSpacing::Compact),
+        make("glyph/curves/decimals/compact", 3, 120, PathCorpusMix::Curves, PathCorpusNumbers::Decimals, PathCorpusSpacing::Compact),
+        make("illustration/mixed/precise/commas", 4, 4000, PathCorpusMix::Mixed, PathCorpusNumbers::Precise, PathCorpusSpacing::Commas),
+        make("illustration/mixed/scientific/loose", 5, 4000, PathCorpusMix::Mixed, PathCorpusNumbers::Scientific, PathCorpusSpacing::Loose),
+        make("map/lines/precise/compact", 6, 150000, PathCorpusMix::Lines, PathCorpusNumbers::Precise, PathCorpusSpacing::Compact),
+        make("map/lines/decimals/loose", 7, 150000, PathCorpusMix::Lines, PathCorpusNumbers::Decimals, PathCorpusSpacing::Loose),
+    };
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// synthetic corpus
+
+enum class PathCorpusMix {
+    // absolute lines, as exported outlines and simplified maps are
+    Lines,
+    // cubics and quadratics with their smooth forms, as fonts and icons are
+    Curves,
+    // every command in both cases, arcs included
+    Mixed,
+};
+
+enum class PathCorpusNumbers {
+    Integers,
+    // two decimal places, the common export precision
+    Decimals,
+    // six decimal places
+    Precise,
+    // mantissa and exponent
+    Scientific,
+};
+
+enum class PathCorpusSpacing {
+    // a single space between numbers, command letters unspaced
+    Compact,
+    // "x,y" pairs and spaces around commands
+    Commas,
+    // several spaces, tabs and a newline per command
+    Loose,
+};
+
+struct PathCorpusOptions {
+    uint64_t seed = 1;
+    size_t commands = 64;
+    PathCorpusMix mix = PathCorpusMix::Mixed;
+    PathCorpusNumbers numbers = PathCorpusNumbers::Decimals;
+    PathCorpusSpacing spacing = PathCorpusSpacing::Commas;
+    // coordinates stay within [0, extent)
+    double extent = 1000;
+};
+
+// A named corpus entry for the benchmarks.
+
+struct PathCorpusCase {
+    std::string name;
+    PathCorpusOptions options;
+};
+
+class PathCorpus final {
+public:
+    // The same options give the same bytes on every platform: the generator
+    // uses its own random numbers rather than the standard library's
+    // distributions, whose output is implementation-defined, and draws and
+    // formats numbers as integers rather than through floating point and
+    // printf.
+    //
+    // Numbers are always separated by whitespace or a comma within a pair,
+    // never by a sign alone, and keep their leading zero, since the lexer and
+    // parser need all three.
+
+    static const std::string generate(
+        const PathCorpusOptions& options);
+
+    // Icon, glyph, illustration and map sized inputs across the command mixes,
+    // number formats and spacings.
+
+    static const std::vector<PathCorpusCase> standardCases();
+};
@@ -0,0 +1,198 @@
+#include <bit>
+#include <cstdio>
+#include <string>
+
+#include "AllocationTracking.h"
+#include "Path.h"
+
+// allocation check
+
+// Lexing must cost one allocation per token, and parsing a few more per
+// command and sub path, plus the logarithmic growth of their vectors. Each
+// case is measured untracked first, for its token, command and sub path
+// counts, then run again under an AllocationScope holding it to that budget,
+// which aborts on the first allocation past it.
+//
+// A parse given too small a budget the usual way, failing rather than
+// aborting, must stop with a LimitExceeded error and leave the process fine.
+
+namespace {
+
+const char* const paths[] = {
+    "M 0 0 L 10 10 Z",
+    "M 0 0 Q 100 100 100 0 Q 0 100 0 0 Z",
+    "M 50 0 A 50 50 0 1 1 50 100 A 50 50 0 1 1 50 0 Z M 50 20 A 30 30 0 1 0 50 80 A 30 30 0 1 0 50 20 Z",
+    "M 10 90 C 10 40 40 10 70 10 C 90 10 95 30 80 40 L 60 50 C 80 55 95 70 90 85 C 85 98 60 98 40 90 Z",
+    // one command repeating its arguments
+    "M 0 0 L 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24",
+};
+
+const std::string repeated(
+    const char* part,
+    int count)
+{
+    std::string source;
+
+    for (auto i = 0; i < count; ++i) {
+
+        source += part;
+    }
+
+    return source;
+}
+
+// the check mode: stop on the allocation that broke the budget
+
+const AllocationLimits abortingBudget(
+    uint64_t allocations)
+{
+    return { allocations, std::nullopt, std::nullopt, AllocationOverBudget::Abort };
+}
+
+const uint64_t growth(
+    size_t count)
+{
+    return 2 * std::bit_width(count);
+}
+
+const bool check(
+    const std::string& name,
+    std::string_view source)
+{
+    const auto [tokens, lexError] = PathLexer::lexFromSource(source);
+
+    const auto [subPaths, parseError] = PathParser::parsePathFromSource(source);
+
+    if (lexError || parseError) {
+
+        std::printf("%s: does not parse\n", name.c_str());
+
+        return false;
+    }
+
+    size_t commands = 0;
+
+    for (const auto& subPath : *subPaths) {
+
+        commands += subPath.size();
+    }
+
+    ///
+
+    const auto lexBudget = tokens.size() + growth(tokens.size()) + 4;
+
+    const auto parseBudget = lexBudget + 4 * commands + 3 * subPaths->size() + 16;
+
+    AllocationStats lexStats;
+
+    {
+        AllocationScope scope(lexStats, abortingBudget(lexBudget));
+
+        PathLexer::lexFromSource(source);
+    }
+
+    AllocationStats parseStats;
+
+    {
+        AllocationScope scope(parseStats, abortingBudget(parseBudget));
+
+        PathParser::parsePathFromSource(source);
+    }
+
+    std::printf("%s: lexed in %llu of %llu allocations, parsed in %llu of %llu\n",
+        name.c_str(),
+        (unsigned long long)lexStats.allocations,
+        (unsigned long long)lexBudget,
+        (unsigned long long)parseStats.allocations,
+        (unsigned long long)parseBudget);
+
+    // a scope that counted nothing would pass any budget
+
+    return lexStats.allocations >= tokens.size() && parseStats.allocations >= lexStats.allocations;
+}
+
+const bool checkLimitExceeded(
+    const std::string& source)
+{
+    const auto [fullPaths, fullError, fullStats] = PathParser::parsePathWithAllocations(source);
+
+    if (fullError || !fullStats) {
+
+        std::printf("unlimited parse failed\n");
+
+        return false;
+    }
+
+    const auto needed = fullStats->allocations;
+
+    AllocationLimits limits;
+
+    limits.allocations = needed / 2;
+
+    const auto [paths, error, stats] = PathParser::parsePathWithAllocations(source, limits);
+
+    if (paths || !error || error->code() != ErrorCode::LimitExceeded || !stats || stats->allocations > needed / 2) {
+
+        std::printf("a parse over budget did not stop with LimitExceeded\n");
+
+        return false;
+    }
+
+    limits.allocations = needed;
+
+    const auto [retriedPaths, retriedError, retriedStats] = PathParser::parsePathWithAllocations(source, limits);
+
+    if (!retriedPaths || retriedError) {
+
+        std::printf("a parse within budget failed\n");
+
+        return false;
+    }
+
+    std::printf("over budget: stopped after %llu of %llu allocations\n",
+        (unsigned long long)stats->allocations,
+        (unsigned long long)needed);
+
+    return true;
+}
+
+}
+
+int main()
+{
+    auto failures = 0;
+
+    auto index = 0;
+
+    for (const auto* path : paths) {
+
+        if (!check("path " + std::to_string(index++), path)) {
+
+            ++failures;
+        }
+    }
+
+    if (!check("1000 sub paths", repeated("M 1 2 L 3 4 5 6 C 1 2 3 4 5 6 Z ", 1000))) {
+
+        ++failures;
+    }
+
+    if (!check("1000 commands", "M 0 0" + repeated(" L 1 2", 1000))) {
+
+        ++failures;
+    }
+
+    if (!check("1000 repeated arguments", "M 0 0 L" + repeated(" 1 2", 1000))) {
+
+        ++failures;
+    }
+
+    if (!checkLimitExceeded(repeated("M 1 2 L 3 4 5 6 C 1 2 3 4 5 6 Z ", 100))) {
+
+        ++failures;
+    }
+
+    std::printf("%d allocation cases failed\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <string>
+
+#include "FlattenedWinding.h"
+#include "Path.h"
+#include "PathBuffer.h"
+#include "PathClipper.h"
+#include "PathFlattener.h"
+
+// clipper check
+
+// Clipping must not change the fill anywhere inside the clip rect. Each case
+// clips a path and compares nonzero insideness of the original and clipped
+// outlines on a grid of points within the rect.
+
+namespace {
+
+struct ClipCase {
+    const char* path;
+    PathRect rect;
+};
+
+const ClipCase cases[] = {
+    // radii too small for the chord, which the arc code scales to 5 and 500:
+    // the drawn half reaches y = 500, far beyond the stated radii
+    { "M 0 0 A 1 100 0 0 1 10 0 Z", { 4, 300, 6, 310 } },
+    { "M 0 0 A 1 100 0 0 1 10 0 Z", { 4, -310, 6, -300 } },
+    { "M 0 0 A 1 100 0 0 1 10 0 Z", { 4, 100, 6, 110 } },
+    { "M 0 0 A 1 100 0 0 0 10 0 Z", { 4, 300, 6, 310 } },
+    { "M 0 0 A 1 100 0 0 0 10 0 Z", { 4, -310, 6, -300 } },
+    // the same, rotated
+    { "M 0 0 A 1 100 30 0 1 10 0 Z", { -300, -300, 300, 300 } },
+    { "M 0 0 A 1 100 30 0 1 10 0 Z", { 200, -400, 260, -300 } },
+    { "M 0 0 A 1 100 30 0 1 10 0 Z", { -260, 300, -200, 400 } },
+    // an arc that fits, and one that leaves by a side
+    { "M 10 10 A 20 20 0 1 1 50 10 Z", { -100, -100, 100, 100 } },
+    { "M 10 10 A 20 20 0 1 1 50 10 Z", { 20, -30, 40, -20 } },
+};
+
+}
+
+int main()
+{
+    auto failures = 0;
+
+    for (const auto& clipCase : cases) {
+
+        const auto [subPaths, error] = PathParser::parsePathFromSource(std::string_view(clipCase.path));
+
+        if (error) {
+
+            const auto message = error->message();
+
+            std::printf("%s: %.*s\n", clipCase.path, int(message.size()), message.data());
+
+            ++failures;
+
+            continue;
+        }
+
+        const auto buffer = PathBufferBuilder::fromSubPaths(*subPaths);
+
+        const auto clipped = PathClipper::clip(buffer, clipCase.rect);
+
+        const auto original = PathFlattener::flatten(buffer, 0.001f);
+
+        const auto result = PathFlattener::flatten(clipped, 0.001f);
+
+        const auto& rect = clipCase.rect;
+
+        auto mismatches = 0;
+
+        // offset from round numbers so no sample lands on a vertex
+
+        for (auto i = 0; i < 15; ++i) {
+
+            for (auto j = 0; j < 15; ++j) {
+
+                const auto x = rect.minX + rect.width() * (i + 0.4142) / 15.0;
+
+                const auto y = rect.minY + rect.height() * (j + 0.5773) / 15.0;
+
+                if ((flattenedWinding(original, x, y) != 0) != (flattenedWinding(result, x, y) != 0)) {
+
+                    ++mismatches;
+                }
+            }
+        }
+
+        if (mismatches != 0) {
+
+            std::printf("%s clipped to [%g, %g] x [%g, %g]: fill differs at %d of 225 points\n", clipCase.path, rect.minX, rect.maxX, rect.minY, rect.maxY, mismatches);
+
+            ++failures;
+        }
+    }
+
+    std::printf("%d of %zu clip cases failed\n", failures, std::size(cases));
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "FlattenedWinding.h"
+#include "Path.h"
+#include "PathBounds.h"
+#include "PathBuffer.h"
+#include "PathCurves.h"
+#include "PathFlattener.h"
+
+// curve data check
+
+// The mesh and band data PathCurves emits for the GPU, shaded by their CPU
+// models, must give the same winding number as a finely flattened copy of the
+// path. Points closer to the outline than the approximations are allowed to
+// stray are skipped. The mesh's curve triangles must also be disjoint, as
+// drawing them directly with antialiasing needs.
+
+namespace {
+
+const char* const paths[] = {
+    // two quadratics that cross, whose triangles never stop overlapping
+    "M 0 0 Q 100 100 100 0 Q 0 100 0 0 Z",
+    "M 0 0 C 100 100 0 100 100 0 C 0 -100 100 -100 0 0 Z",
+    // a ring, as arcs, with its hole wound the other way
+    "M 50 0 A 50 50 0 1 1 50 100 A 50 50 0 1 1 50 0 Z M 50 20 A 30 30 0 1 0 50 80 A 30 30 0 1 0 50 20 Z",
+    // a glyph-like outline of cubics and lines
+    "M 10 90 C 10 40 40 10 70 10 C 90 10 95 30 80 40 L 60 50 C 80 55 95 70 90 85 C 85 98 60 98 40 90 Z",
+    // self-intersecting star of lines
+    "M 50 0 L 79 90 L 2 35 L 98 35 L 21 90 Z",
+    // overlapping contours wound the same way
+    "M 0 0 Q 60 -40 120 0 Q 60 40 0 0 Z M 30 -30 Q 70 0 30 30 Q -10 0 30 -30 Z",
+};
+
+const double distanceToOutline(
+    const PathPolylines& polylines,
+    double x,
+    double y)
+{
+    auto nearest = double(INFINITY);
+
+    for (size_t contour = 0; contour < polylines.contourCount(); ++contour) {
+
+        const auto start = polylines.contourStart(contour);
+
+        const auto end = polylines.contourEnds[contour];
+
+        for (auto i = start; i < end; ++i) {
+
+            const auto next = i + 1 < end ? i + 1 : start;
+
+            const double x0 = polylines.points[i * 2], y0 = polylines.points[i * 2 + 1];
+
+            const double dx = polylines.points[next * 2] - x0, dy = polylines.points[next * 2 + 1] - y0;
+
+            const auto length = dx * dx + dy * dy;
+
+            const auto t = length > 0 ? std::clamp(((x - x0) * dx + (y - y0) * dy) / length, 0.0, 1.0) : 0.0;
+
+            nearest = std::min(nearest, std::hypot(x0 + t * dx - x, y0 + t * dy - y));
+        }
+    }
+
+    return nearest;
+}
+
+// Separating axis test, counting shared vertices and edges as apart.
+
+const bool trianglesOverlap(
+    const double* a,
+    const double* b)
+{
+    for (const auto* triangle : { a, b }) {
+
+        for (auto edge = 0; edge < 3; ++edge) {
+
+            const auto next = (edge + 1) % 3;
+
+            const auto nx = triangle[edge * 2 + 1] - triangle[next * 2 + 1];
+
+            const auto ny = triangle[next * 2] - triangle[edge * 2];
+
+            const auto length = std::hypot(nx, ny);
+
+            if (length == 0) {
+
+                continue;
+            }
+
+            double minA = INFINITY, maxA = -INFINITY, minB = INFINITY, maxB = -INFINITY;
+
+            for (auto i = 0; i < 3; ++i) {
+
+                const auto projectionA = (a[i * 2] * nx + a[i * 2 + 1] * ny) / length;
+
+                const auto projectionB = (b[i * 2] * nx + b[i * 2 + 1] * ny) / length;
+
+                minA = std::min(minA, projectionA);
+
+                maxA = std::max(maxA, projectionA);
+
+                minB = std::min(minB, projectionB);
+
+                maxB = std::max(maxB, projectionB);
+            }
+
+            const auto epsilon = 1e-5 * std::max({ std::abs(minA), std::abs(maxA), 1.0 });
+
+            if (maxA <= minB + epsilon || maxB <= minA + epsilon) {
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+const int overlappingCurveTriangles(
+    const PathCurveMesh& mesh)
+{
+    const auto triangle = [&](size_t index, double* points) {
+        for (auto corner = 0; corner < 3; ++corner) {
+
+            const auto& vertex = mesh.vertices[mesh.indices[index * 3 + corner]];
+
+            points[corner * 2] = vertex.x;
+
+            points[corner * 2 + 1] = vertex.y;
+        }
+    };
+
+    auto pairs = 0;
+
+    const auto count = mesh.indices.size() / 3;
+
+    for (auto i = mesh.solidTriangleCount; i < count; ++i) {
+
+        double a[6];
+
+        triangle(i, a);
+
+        for (auto j = i + 1; j < count; ++j) {
+
+            double b[6];
+
+            triangle(j, b);
+
+            pairs += trianglesOverlap(a, b);
+        }
+    }
+
+    return pairs;
+}
+
+}
+
+int main()
+{
+    constexpr auto tolerance = 0.01f;
+
+    constexpr auto grid = 96;
+
+    auto failures = 0;
+
+    for (const auto* path : paths) {
+
+        const auto [subPaths, error] = PathParser::parsePathFromSource(std::string_view(path));
+
+        if (error) {
+
+            const auto message = error->message();
+
+            std::printf("%s: %.*s\n", path, int(message.size()), message.data());
+
+            ++failures;
+
+            continue;
+        }
+
+        const auto buffer = PathBufferBuilder::fromSubPaths(*subPaths);
+
+        const auto reference = PathFlattener::flatten(buffer, tolerance / 10);
+
+        const auto quadratics = PathCurves::toQuadratics(buffer, tolerance);
+
+        const auto mesh = PathCurves::buildMesh(quadratics, tolerance);
+
+        const auto bands = PathCurves::buildBands(quadratics, 8);
+
+        const auto bounds = PathBounds::compute(buffer);
+
+        auto meshMismatches = 0;
+
+        auto bandMismatches = 0;
+
+        auto samples = 0;
+
+        for (auto i = 0; i < grid; ++i) {
+
+            for (auto j = 0; j < grid; ++j) {
+
+                // a margin around the bounds, and off round numbers
+
+                const auto x = bounds.minX - 5 + (bounds.width() + 10) * (i + 0.4142) / grid;
+
+                const auto y = bounds.minY - 5 + (bounds.height() + 10) * (j + 0.5773) / grid;
+
+                if (distanceToOutline(reference, x, y) < 4 * tolerance) {
+
+                    continue;
+                }
+
+                const auto expected = flattenedWinding(reference, x, y);
+
+                meshMismatches += PathCurves::meshWinding(mesh, float(x), float(y)) != expected;
+
+                bandMismatches += PathCurves::bandWinding(bands, float(x), float(y)) != expected;
+
+                ++samples;
+            }
+        }
+
+        const auto overlapping = overlappingCurveTriangles(mesh);
+
+        if (meshMismatches != 0 || bandMismatches != 0 || overlapping != 0) {
+
+            std::printf("%s: winding differs at %d mesh and %d band points of %d, %d curve triangle pairs overlap\n", path, meshMismatches, bandMismatches, samples, overlapping);
+
+            ++failures;
+        }
+    }
+
+    std::printf("%d of %zu curve cases failed\n", failures, std::size(paths));
+
+    return failures == 0 ? 0 : 1;
+}
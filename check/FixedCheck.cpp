@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <cstdio>
+
+#include "PathScalar.h"
+
+// fixed point check
+
+// Arithmetic past either end of the range must saturate there rather than
+// wrap, for every operator, and stay exact inside it.
+
+namespace {
+
+struct FixedCase {
+    const char* name;
+    int32_t result;
+    int32_t expected;
+};
+
+template <int FractionBits>
+const int checkOverflow(
+    const char* type)
+{
+    using F = Fixed<FractionBits>;
+
+    const auto max = F::fromRaw(INT32_MAX);
+
+    const auto min = F::fromRaw(INT32_MIN);
+
+    const auto ulp = F::fromRaw(1);
+
+    const auto half = F::fromRaw(INT32_MAX / 2 + 1);
+
+    const auto two = F::fromRaw(2 * F::one);
+
+    const FixedCase cases[] = {
+        { "max + ulp", (max + ulp).raw(), INT32_MAX },
+        { "max + max", (max + max).raw(), INT32_MAX },
+        { "min - ulp", (min - ulp).raw(), INT32_MIN },
+        { "min + min", (min + min).raw(), INT32_MIN },
+        { "max - min", (max - min).raw(), INT32_MAX },
+        { "min - max", (min - max).raw(), INT32_MIN },
+        { "-min", (-min).raw(), INT32_MAX },
+        { "-max", (-max).raw(), -INT32_MAX },
+        { "half + half", (half + half).raw(), INT32_MAX },
+        { "max * 2", (max * two).raw(), INT32_MAX },
+        { "min * 2", (min * two).raw(), INT32_MIN },
+        { "max / ulp", (max / ulp).raw(), INT32_MAX },
+        // inside the range, exact
+        { "max - ulp", (max - ulp).raw(), INT32_MAX - 1 },
+        { "min + ulp", (min + ulp).raw(), INT32_MIN + 1 },
+        { "max + min", (max + min).raw(), -1 },
+        { "two * two", (two * two).raw(), 4 * F::one },
+    };
+
+    auto failures = 0;
+
+    for (const auto& fixedCase : cases) {
+
+        if (fixedCase.result != fixedCase.expected) {
+
+            std::printf("%s: %s is raw %d, not %d\n", type, fixedCase.name, fixedCase.result, fixedCase.expected);
+
+            ++failures;
+        }
+    }
+
+    return failures;
+}
+
+}
+
+int main()
+{
+    const auto failures = checkOverflow<16>("Fixed16_16") + checkOverflow<8>("Fixed24_8");
+
+    std::printf("%d fixed point cases failed\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PathFlattener.h"
+
+// flattened winding
+
+// The winding number of (x, y) against flattened contours, each closed as
+// filling closes it: a plain crossing count, as a reference that shares no
+// code with the renderers it checks.
+
+inline int flattenedWinding(
+    const PathPolylines& polylines,
+    double x,
+    double y)
+{
+    auto winding = 0;
+
+    for (size_t contour = 0; contour < polylines.contourCount(); ++contour) {
+
+        const auto start = polylines.contourStart(contour);
+
+        const auto end = polylines.contourEnds[contour];
+
+        for (auto i = start; i < end; ++i) {
+
+            const auto next = i + 1 < end ? i + 1 : start;
+
+            const double x0 = polylines.points[i * 2], y0 = polylines.points[i * 2 + 1];
+
+            const double x1 = polylines.points[next * 2], y1 = polylines.points[next * 2 + 1];
+
+            const auto side = (x1 - x0) * (y - y0) - (x - x0) * (y1 - y0);
+
+            if (y0 <= y && y1 > y && side > 0) {
+
+                ++winding;
+            } else if (y1 <= y && y0 > y && side < 0) {
+
+                --winding;
+            }
+        }
+    }
+
+    return winding;
+}
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Path.h"
+#include "PathDiff.h"
+
+// path diff check
+
+// A patch from one path to another must turn the first into the second, and
+// must be refused by a path that differs from the first in anything the patch
+// deletes or edits, even where the two have the same shape.
+
+namespace {
+
+struct DiffCase {
+    const char* from;
+    const char* to;
+    // same shape as `from`, different in what the patch touches
+    const char* other;
+};
+
+const DiffCase cases[] = {
+    // a changed number
+    { "M 0 0 L 10 10 L 20 20 Z", "M 0 0 L 10 11 L 20 20 Z", "M 0 0 L 10 12 L 20 20 Z" },
+    // a deleted command
+    { "M 0 0 L 10 10 L 20 20 Z", "M 0 0 L 20 20 Z", "M 0 0 L 10 15 L 20 20 Z" },
+    // a deleted sub path
+    { "M 0 0 L 1 1 Z M 5 5 L 6 6 Z M 9 9 L 8 8 Z", "M 0 0 L 1 1 Z M 9 9 L 8 8 Z", "M 0 0 L 1 1 Z M 5 5 L 6 7 Z M 9 9 L 8 8 Z" },
+    // a command replaced by one of another shape
+    { "M 0 0 L 10 10 Z", "M 0 0 Q 5 5 10 10 Z", "M 0 0 L 10 20 Z" },
+};
+
+const std::vector<std::vector<BasicPathCommand<float>>> parse(
+    const char* source)
+{
+    return *std::get<0>(PathParser::parsePathFromSource(std::string_view(source)));
+}
+
+}
+
+int main()
+{
+    auto failures = 0;
+
+    for (const auto& diffCase : cases) {
+
+        const auto to = parse(diffCase.to);
+
+        const auto patch = PathDiff::diff(parse(diffCase.from), to);
+
+        auto patched = parse(diffCase.from);
+
+        if (const auto error = PathDiff::apply(patched, patch)) {
+
+            const auto message = error->message();
+
+            std::printf("%s: %.*s\n", diffCase.from, int(message.size()), message.data());
+
+            ++failures;
+        } else if (PathDiff::diff(patched, to) != PathDiff::diff(to, to)) {
+
+            std::printf("%s: patched path is not %s\n", diffCase.from, diffCase.to);
+
+            ++failures;
+        }
+
+        auto other = parse(diffCase.other);
+
+        const auto error = PathDiff::apply(other, patch);
+
+        if (!error || error->code() != ErrorCode::InvalidPatch) {
+
+            std::printf("%s: patch for %s applied\n", diffCase.other, diffCase.from);
+
+            ++failures;
+        }
+    }
+
+    std::printf("%d of %zu diff cases failed\n", failures, std::size(cases));
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Path.h"
+#include "PathCorpus.h"
+
+// streaming check
+
+// Parsing while lexing, holding only a few tokens, must give the same sub
+// paths, or the same error at the same place, as parsing the whole token list.
+// A streaming parser frees each token as it moves past, so run this under
+// AddressSanitizer to catch the parser reading one it already passed.
+
+namespace {
+
+const char* const paths[] = {
+    "M 10,20 L 30 40 C 1 2 3 4 5 6 A 5 5 0 1 0 10 10 Z",
+    "M 0 0 H 10 V 20 h 1 v 2 S 1 2 3 4 Q 1 2 3 4 T 1 2 3 4 z m 1 1 l 2 2",
+    "M 0 0 Q 100 100 100 0 Q 0 100 0 0 Z",
+    "M 0 0 C 100 100 0 100 100 0 C 0 -100 100 -100 0 0 Z",
+    "M 50 0 A 50 50 0 1 1 50 100 A 50 50 0 1 1 50 0 Z M 50 20 A 30 30 0 1 0 50 80 A 30 30 0 1 0 50 20 Z",
+    "M 10 90 C 10 40 40 10 70 10 C 90 10 95 30 80 40 L 60 50 C 80 55 95 70 90 85 C 85 98 60 98 40 90 Z",
+    "M 50 0 L 79 90 L 2 35 L 98 35 L 21 90 Z",
+    "M 0 0 A 1 100 30 0 1 10 0 Z",
+    // errors, which must come out the same too
+    "M 10,20 L 30",
+    "M 10,20 L 30,",
+    "M 1e99 2 L 3 4",
+    "M 1 2 X 3 4",
+    "L",
+    "",
+};
+
+const bool sameNumber(
+    const PathNumber& a,
+    const PathNumber& b)
+{
+    return a.value == b.value && a.source == b.source;
+}
+
+const bool samePoint(
+    const PathPoint& a,
+    const PathPoint& b)
+{
+    return sameNumber(a.x, b.x) && sameNumber(a.y, b.y);
+}
+
+const bool sameArc(
+    const PathArc& a,
+    const PathArc& b)
+{
+    return samePoint(std::get<0>(a), std::get<0>(b))
+        && sameNumber(std::get<1>(a), std::get<1>(b))
+        && samePoint(std::get<2>(a), std::get<2>(b))
+        && samePoint(std::get<3>(a), std::get<3>(b));
+}
+
+template <typename List, typename Same>
+const bool sameList(
+    const std::optional<List>& a,
+    const std::optional<List>& b,
+    const Same& same)
+{
+    if (a.has_value() != b.has_value()) {
+
+        return false;
+    }
+
+    return !a || std::equal(a->begin(), a->end(), b->begin(), b->end(), same);
+}
+
+const bool sameCommand(
+    const PathCommand& a,
+    const PathCommand& b)
+{
+    return a.type == b.type
+        && a.position == b.position
+        && sameList(a.points, b.points, samePoint)
+        && sameList(a.numbers, b.numbers, sameNumber)
+        && sameList(a.arcs, b.arcs, sameArc);
+}
+
+const bool sameResult(
+    const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::optional<Error>>& a,
+    const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::optional<Error>>& b)
+{
+    const auto& [aPaths, aError] = a;
+
+    const auto& [bPaths, bError] = b;
+
+    if (aError.has_value() != bError.has_value()) {
+
+        return false;
+    }
+
+    if (aError) {
+
+        const auto& aLocation = aError->location();
+
+        const auto& bLocation = bError->location();
+
+        if (aLocation.has_value() != bLocation.has_value()) {
+
+            return false;
+        }
+
+        return aError->code() == bError->code()
+            && (!aLocation || (aLocation->start == bLocation->start && aLocation->end == bLocation->end));
+    }
+
+    return sameList(aPaths, bPaths, [](const auto& x, const auto& y) {
+        return std::equal(x.begin(), x.end(), y.begin(), y.end(), sameCommand);
+    });
+}
+
+const bool check(
+    const std::string& name,
+    std::string_view source)
+{
+    const auto batch = PathParser::parsePathFromSource(source);
+
+    auto passed = true;
+
+    for (const auto lookahead : { 1, 2, 3, 8 }) {
+
+        if (!sameResult(PathParser::parsePathStreaming(source, lookahead), batch)) {
+
+            std::printf("%s: streaming with lookahead %d differs\n", name.c_str(), lookahead);
+
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+}
+
+int main()
+{
+    auto failures = 0;
+
+    auto cases = 0;
+
+    for (const auto* path : paths) {
+
+        ++cases;
+
+        if (!check(std::string("\"") + path + "\"", path)) {
+
+            ++failures;
+        }
+    }
+
+    for (auto options : PathCorpus::standardCases()) {
+
+        ++cases;
+
+        options.options.commands = std::min<size_t>(options.options.commands, 2000);
+
+        if (!check(options.name, PathCorpus::generate(options.options))) {
+
+            ++failures;
+        }
+    }
+
+    std::printf("%d of %d streaming cases failed\n", failures, cases);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,390 @@
+#include "AllocationTracking.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(SARLACC_ALLOCATION_TRACKING)
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+#endif
+
+// allocation tracking
+
+namespace {
+
+thread_local AllocationScope* currentScope = nullptr;
+
+}
+
+// Reached from the replaced allocation functions below, with the scope's
+// internals.
+
+class AllocationHooks final {
+public:
+    // Counts an allocation; false if it breaks a budget that fails, in which
+    // case it is left uncounted for the caller to free.
+
+    static bool allocated(
+        void* pointer,
+        size_t size)
+    {
+        auto* scope = currentScope;
+
+        if (scope == nullptr || pointer == nullptr) {
+
+            return true;
+        }
+
+        auto stats = scope->m_stats;
+
+        stats.allocations += 1;
+
+        stats.bytesAllocated += size;
+
+        stats.liveBytes += int64_t(usableSize(pointer));
+
+        stats.peakLiveBytes = std::max(stats.peakLiveBytes, stats.liveBytes);
+
+        if (scope->m_limits && over(stats, *scope->m_limits)) {
+
+            if (scope->m_limits->overBudget == AllocationOverBudget::Fail) {
+
+                return false;
+            }
+
+            scope->m_stats = stats;
+
+            reportAndAbort(stats);
+        }
+
+        scope->m_stats = stats;
+
+        return true;
+    }
+
+    static void freed(
+        void* pointer)
+    {
+        auto* scope = currentScope;
+
+        if (scope == nullptr || pointer == nullptr) {
+
+            return;
+        }
+
+        scope->m_stats.deallocations += 1;
+
+        scope->m_stats.liveBytes -= int64_t(usableSize(pointer));
+    }
+
+    static size_t usableSize(
+        [[maybe_unused]] void* pointer)
+    {
+#if !defined(SARLACC_ALLOCATION_TRACKING)
+        return 0;
+#elif defined(__APPLE__)
+        return malloc_size(pointer);
+#else
+        return malloc_usable_size(pointer);
+#endif
+    }
+
+private:
+    static bool over(
+        const AllocationStats& stats,
+        const AllocationLimits& limits)
+    {
+        return (limits.allocations && stats.allocations > *limits.allocations)
+            || (limits.bytesAllocated && stats.bytesAllocated > *limits.bytesAllocated)
+            || (limits.peakLiveBytes && stats.peakLiveBytes > *limits.peakLiveBytes);
+    }
+
+    [[noreturn]] static void reportAndAbort(
+        const AllocationStats& stats)
+    {
+        // stop counting first, in case reporting allocates
+
+        currentScope = nullptr;
+
+        std::fprintf(stderr, "allocation budget exceeded: %llu allocations, %llu bytes, %lld peak live bytes\n",
+            static_cast<unsigned long long>(stats.allocations),
+            static_cast<unsigned long long>(stats.bytesAllocated),
+            static_cast<long long>(stats.peakLiveBytes));
+
+        std::abort();
+    }
+};
+
+///
+
+AllocationScope::AllocationScope(
+    AllocationStats& stats,
+    std::optional<AllocationLimits> limits)
+    : m_stats(stats)
+    , m_limits(limits)
+    , m_previous(currentScope)
+{
+    currentScope = this;
+}
+
+AllocationScope::~AllocationScope()
+{
+    currentScope = m_previous;
+
+    if (m_previous == nullptr) {
+
+        return;
+    }
+
+    auto& outer = m_previous->m_stats;
+
+    outer.allocations += m_stats.allocations;
+
+    outer.deallocations += m_stats.deallocations;
+
+    outer.bytesAllocated += m_stats.bytesAllocated;
+
+    outer.peakLiveBytes = std::max(outer.peakLiveBytes, outer.liveBytes + m_stats.peakLiveBytes);
+
+    outer.liveBytes += m_stats.liveBytes;
+}
+
+///
+
+#if defined(SARLACC_ALLOCATION_TRACKING)
+
+// Every replaceable form goes through malloc and free, so the usable size is
+// known on both sides without a header of our own.
+
+namespace {
+
+// Null when malloc fails or the allocation breaks a budget that fails, which
+// `overBudget` tells apart for the throwing forms.
+
+void* counted(
+    void* pointer,
+    size_t size,
+    bool& overBudget)
+{
+    overBudget = !AllocationHooks::allocated(pointer, size);
+
+    if (overBudget) {
+
+        std::free(pointer);
+
+        return nullptr;
+    }
+
+    return pointer;
+}
+
+void* allocate(
+    size_t size,
+    bool& overBudget)
+{
+    return counted(std::malloc(size == 0 ? 1 : size), size, overBudget);
+}
+
+void* allocateAligned(
+    size_t size,
+    std::align_val_t alignment,
+    bool& overBudget)
+{
+    const auto align = std::max(size_t(alignment), sizeof(void*));
+
+    // aligned_alloc wants a multiple of the alignment
+
+    return counted(std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align), size, overBudget);
+}
+
+[[noreturn]] void failAllocation(
+    bool overBudget)
+{
+    if (overBudget) {
+
+        throw AllocationBudgetExceeded();
+    }
+
+    throw std::bad_alloc();
+}
+
+void release(
+    void* pointer)
+{
+    AllocationHooks::freed(pointer);
+
+    std::free(pointer);
+}
+
+}
+
+void* operator new(
+    size_t size)
+{
+    auto overBudget = false;
+
+    if (auto* pointer = allocate(size, overBudget)) {
+
+        return pointer;
+    }
+
+    failAllocation(overBudget);
+}
+
+void* operator new[](
+    size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(
+    size_t size,
+    const std::nothrow_t&) noexcept
+{
+    auto overBudget = false;
+
+    return allocate(size, overBudget);
+}
+
+void* operator new[](
+    size_t size,
+    const std::nothrow_t&) noexcept
+{
+    auto overBudget = false;
+
+    return allocate(size, overBudget);
+}
+
+void* operator new(
+    size_t size,
+    std::align_val_t alignment)
+{
+    auto overBudget = false;
+
+    if (auto* pointer = allocateAligned(size, alignment, overBudget)) {
+
+        return pointer;
+    }
+
+    failAllocation(overBudget);
+}
+
+void* operator new[](
+    size_t size,
+    std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept
+{
+    auto overBudget = false;
+
+    return allocateAligned(size, alignment, overBudget);
+}
+
+void* operator new[](
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept
+{
+    auto overBudget = false;
+
+    return allocateAligned(size, alignment, overBudget);
+}
+
+void operator delete(
+    void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](
+    void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(
+    void* pointer,
+    size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](
+    void* pointer,
+    size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(
+    void* pointer,
+    const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](
+    void* pointer,
+    const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(
+    void* pointer,
+    std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](
+    void* pointer,
+    std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(
+    void* pointer,
+    size_t,
+    std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](
+    void* pointer,
+    size_t,
+    std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(
+    void* pointer,
+    std::align_val_t,
+    const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](
+    void* pointer,
+    std::align_val_t,
+    const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+#endif
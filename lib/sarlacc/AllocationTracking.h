@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+
+// allocation tracking
+
+// Heap traffic on one thread while an AllocationScope is open. Live bytes
+// count what the allocator actually reserved, so they can run a little above
+// the bytes asked for; memory freed in the scope but allocated before it
+// pushes them below zero.
+
+struct AllocationStats {
+    uint64_t allocations = 0;
+
+    uint64_t deallocations = 0;
+
+    // as requested
+    uint64_t bytesAllocated = 0;
+
+    int64_t liveBytes = 0;
+
+    int64_t peakLiveBytes = 0;
+};
+
+// What the first allocation over a scope's budget does.
+
+enum class AllocationOverBudget : uint8_t {
+    // Fails as if memory ran out, without being counted: the throwing forms
+    // of operator new throw AllocationBudgetExceeded and the nothrow forms
+    // return null, so the work in the scope unwinds and its caller can report
+    // the failure.
+    Fail,
+    // Prints the counts and aborts, so a debugger or core dump stops on the
+    // call that broke the budget; for checks guarding hot paths, not for
+    // production.
+    Abort,
+};
+
+// Budgets for a scope; an unset limit is not checked.
+
+struct AllocationLimits {
+    std::optional<uint64_t> allocations = std::nullopt;
+    std::optional<uint64_t> bytesAllocated = std::nullopt;
+    std::optional<int64_t> peakLiveBytes = std::nullopt;
+    AllocationOverBudget overBudget = AllocationOverBudget::Fail;
+};
+
+class AllocationBudgetExceeded final : public std::bad_alloc {
+public:
+    const char* what() const noexcept override
+    {
+        return "allocation budget exceeded";
+    }
+};
+
+// Counts every operator new and delete on this thread into `stats` until
+// destroyed, whether from the lexer's tokens, the parser's command vectors,
+// an Error's message or anything they call. Scopes nest, and an inner scope's
+// counts are added to the outer one's when it closes.
+//
+// With `limits`, the first allocation over budget fails or aborts, as their
+// `overBudget` says.
+//
+// Counting replaces the global allocation functions, so it is only compiled in
+// with SARLACC_ALLOCATION_TRACKING. Without it scopes record nothing.
+
+class AllocationScope final {
+public:
+    explicit AllocationScope(
+        AllocationStats& stats,
+        std::optional<AllocationLimits> limits = std::nullopt);
+
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    static constexpr bool enabled()
+    {
+#if defined(SARLACC_ALLOCATION_TRACKING)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    friend class AllocationHooks;
+
+    AllocationStats& m_stats;
+
+    std::optional<AllocationLimits> m_limits;
+
+    AllocationScope* m_previous;
+};
@@ -1,67 +1,177 @@
-
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "SourceLocation.h"
+#include "SourceMap.h"
 
-enum class ErrorType {
+enum class ErrorType : uint8_t {
     Unknown,
     Lexer,
     Parser,
 };
 
+// What went wrong, for callers that handle failures without reading the
+// message.
+
+enum class ErrorCode : uint8_t {
+    Unspecified,
+    UnexpectedEof,
+    // a token other than the one the grammar needed
+    UnexpectedToken,
+    // the right tokens, in a count the command cannot take
+    InvalidArgumentCount,
+    NumberOutOfRange,
+    UnknownCommand,
+    Io,
+    LimitExceeded,
+    // a PathDiff patch that is malformed or made against another path
+    InvalidPatch,
+};
+
+// Errors are small values: a type, a code, a static message and where in the
+// source it happened. Failures in the lexer and parser allocate nothing; the
+// message is only built into a string when asked for, and only errors that
+// carry runtime detail, like a file name, hold a string of their own. The
+// message is a view into the error, valid while the error or a copy lives.
+
 class Error {
 public:
+    // `message` must be a string literal or otherwise outlive the error.
+
     Error(
-        const ErrorType& type,
-        const std::optional<std::string>& message)
-        : m_type(type)
-        , m_message(message)
+        ErrorType type,
+        const char* message)
+        : m_text(message)
+        , m_type(type)
     {
     }
 
     Error(
-        ErrorType&& type,
-        std::optional<std::string>&& message)
-        : m_type(std::move(type))
-        , m_message(std::move(message))
+        ErrorType type,
+        ErrorCode code,
+        const char* message,
+        std::optional<SourceLocation> location = std::nullopt)
+        : m_text(message)
+        , m_location(location)
+        , m_type(type)
+        , m_code(code)
+    {
+    }
+
+    // A message built at runtime.
+
+    Error(
+        ErrorType type,
+        ErrorCode code,
+        std::string message)
+        : m_detail(std::make_shared<const std::string>(std::move(message)))
+        , m_type(type)
+        , m_code(code)
+    {
+    }
+
+    Error(
+        ErrorType type,
+        std::string message)
+        : Error(type, ErrorCode::Unspecified, std::move(message))
     {
     }
 
     const ErrorType type() const { return m_type; }
 
-    const std::optional<std::string> message() const { return m_message; }
+    const ErrorCode code() const { return m_code; }
+
+    const std::string_view message() const
+    {
+        if (m_detail) {
+            return *m_detail;
+        }
+
+        return m_text != nullptr ? m_text : "";
+    }
+
+    const std::optional<SourceLocation>& location() const { return m_location; }
 
 private:
-    const ErrorType m_type;
+    const char* m_text = nullptr;
+
+    std::shared_ptr<const std::string> m_detail;
+
+    std::optional<SourceLocation> m_location;
 
-    const std::optional<std::string> m_message;
+    ErrorType m_type;
+
+    ErrorCode m_code = ErrorCode::Unspecified;
 };
 
+// An error that can say where it happened in lines and columns, through the
+// source map of the input it came from.
+
 class SourceError : public Error {
 public:
     SourceError(
-        const ErrorType& type,
-        const std::optional<std::string>& message,
-        const SourceLocation& location)
-        : Error(type, message)
-        , m_location(location)
+        ErrorType type,
+        ErrorCode code,
+        const char* message,
+        const SourceLocation& location,
+        std::shared_ptr<const SourceMap> sourceMap = nullptr)
+        : Error(type, code, message, location)
+        , m_sourceMap(std::move(sourceMap))
     {
     }
 
-    SourceError(
-        ErrorType&& type,
-        std::optional<std::string>&& message,
-        SourceLocation&& location)
-        : Error(std::move(type), std::move(message))
-        , m_location(std::move(location))
+    // Nothing for an error without a location, which has no place to point.
+
+    static const std::optional<SourceError> fromError(
+        const Error& error,
+        std::shared_ptr<const SourceMap> sourceMap)
+    {
+        if (!error.location()) {
+            return std::nullopt;
+        }
+
+        return SourceError(error, std::move(sourceMap));
+    }
+
+    // Always present: both ways of making a SourceError require one.
+
+    const SourceLocation& sourceLocation() const { return *location(); }
+
+    const std::shared_ptr<const SourceMap>& sourceMap() const { return m_sourceMap; }
+
+    const std::optional<SourcePosition> position() const
     {
+        if (!m_sourceMap) {
+            return std::nullopt;
+        }
+
+        return m_sourceMap->position(sourceLocation().start);
     }
 
-    const SourceLocation& location() const { return m_location; }
+    // "line:column: message", or just the message without a source map.
+
+    const std::string describe() const
+    {
+        if (!m_sourceMap) {
+            return std::string(message());
+        }
+
+        return m_sourceMap->describe(*this);
+    }
 
 private:
-    const SourceLocation m_location;
-};
\ No newline at end of file
+    SourceError(
+        const Error& error,
+        std::shared_ptr<const SourceMap> sourceMap)
+        : Error(error)
+        , m_sourceMap(std::move(sourceMap))
+    {
+    }
+
+    std::shared_ptr<const SourceMap> m_sourceMap;
+};
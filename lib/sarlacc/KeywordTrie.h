@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+// keyword trie
+
+struct KeywordMatch {
+    // index into the keyword list the trie was built from
+    size_t keyword;
+    size_t length;
+};
+
+// Node count for a trie over `keywords`: the root plus one per character,
+// which is what a list with no shared prefixes needs.
+
+template <typename Keywords>
+constexpr size_t keywordTrieNodes(
+    const Keywords& keywords)
+{
+    size_t nodes = 1;
+
+    for (const auto& keyword : keywords) {
+
+        nodes += std::string_view(keyword).size();
+    }
+
+    return nodes;
+}
+
+// A packed trie built at compile time from a keyword list. Each node's
+// outgoing edges are stored together and sorted by character, so matching
+// walks the input once, scanning a few bytes per character, however many
+// keywords there are. Build one with makeKeywordTrie.
+
+template <size_t Count, size_t NodeCapacity>
+class KeywordTrie final {
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    template <typename Keywords>
+    constexpr explicit KeywordTrie(
+        const Keywords& keywords)
+    {
+        // first build a linked trie, children kept in character order
+
+        std::array<uint32_t, NodeCapacity> firstChild { };
+
+        std::array<uint32_t, NodeCapacity> nextSibling { };
+
+        std::array<char, NodeCapacity> label { };
+
+        std::array<uint32_t, NodeCapacity> keyword { };
+
+        firstChild.fill(none);
+
+        nextSibling.fill(none);
+
+        keyword.fill(none);
+
+        uint32_t nodes = 1;
+
+        uint32_t index = 0;
+
+        for (const auto& entry : keywords) {
+
+            const auto text = std::string_view(entry);
+
+            uint32_t node = 0;
+
+            for (const auto c : text) {
+
+                auto* link = &firstChild[node];
+
+                while (*link != none && label[*link] < c) {
+
+                    link = &nextSibling[*link];
+                }
+
+                if (*link == none || label[*link] != c) {
+
+                    label[nodes] = c;
+
+                    nextSibling[nodes] = *link;
+
+                    *link = nodes;
+
+                    ++nodes;
+                }
+
+                node = *link;
+            }
+
+            // the first of any duplicates wins
+
+            if (keyword[node] == none) {
+
+                keyword[node] = index;
+            }
+
+            ++index;
+        }
+
+        ///
+
+        // then lay nodes out breadth first, so each node's children, and so its
+        // edges, are contiguous
+
+        std::array<uint32_t, NodeCapacity> order { };
+
+        uint32_t ordered = 1;
+
+        for (uint32_t position = 0; position < ordered; ++position) {
+
+            const auto old = order[position];
+
+            m_firstEdge[position] = ordered - 1;
+
+            m_keyword[position] = keyword[old];
+
+            for (auto child = firstChild[old]; child != none; child = nextSibling[child]) {
+
+                m_edgeLabel[ordered - 1] = label[child];
+
+                order[ordered] = child;
+
+                ++ordered;
+            }
+
+            m_edgeCount[position] = ordered - 1 - m_firstEdge[position];
+        }
+
+        m_nodes = ordered;
+
+        // breadth first order makes edge i lead to node i + 1
+    }
+
+    // The longest keyword `text` starts with.
+
+    constexpr const std::optional<KeywordMatch> match(
+        std::string_view text) const
+    {
+        std::optional<KeywordMatch> longest;
+
+        uint32_t node = 0;
+
+        for (size_t i = 0; i < text.size(); ++i) {
+
+            node = child(node, text[i]);
+
+            if (node == none) {
+
+                break;
+            }
+
+            if (m_keyword[node] != none) {
+
+                longest = KeywordMatch { m_keyword[node], i + 1 };
+            }
+        }
+
+        return longest;
+    }
+
+    // The keyword `word` is exactly, if any.
+
+    constexpr const std::optional<size_t> find(
+        std::string_view word) const
+    {
+        uint32_t node = 0;
+
+        for (const auto c : word) {
+
+            node = child(node, c);
+
+            if (node == none) {
+
+                return std::nullopt;
+            }
+        }
+
+        if (m_keyword[node] == none) {
+
+            return std::nullopt;
+        }
+
+        return m_keyword[node];
+    }
+
+    constexpr size_t nodes() const
+    {
+        return m_nodes;
+    }
+
+    static constexpr size_t keywords()
+    {
+        return Count;
+    }
+
+private:
+    constexpr uint32_t child(
+        uint32_t node,
+        char c) const
+    {
+        const auto first = m_firstEdge[node];
+
+        const auto last = first + m_edgeCount[node];
+
+        for (auto edge = first; edge < last; ++edge) {
+
+            const auto edgeLabel = m_edgeLabel[edge];
+
+            if (edgeLabel == c) {
+
+                return edge + 1;
+            }
+
+            if (edgeLabel > c) {
+
+                break;
+            }
+        }
+
+        return none;
+    }
+
+    std::array<uint32_t, NodeCapacity> m_firstEdge { };
+
+    std::array<uint16_t, NodeCapacity> m_edgeCount { };
+
+    std::array<uint32_t, NodeCapacity> m_keyword { };
+
+    std::array<char, NodeCapacity> m_edgeLabel { };
+
+    size_t m_nodes = 0;
+};
+
+// Builds the trie for a constexpr keyword array, sized to fit:
+//
+//     constexpr std::string_view keywords[] = { "if", "else", "return" };
+//
+//     constexpr auto trie = makeKeywordTrie<keywords>();
+
+template <const auto& Keywords>
+constexpr auto makeKeywordTrie()
+{
+    return KeywordTrie<std::size(Keywords), keywordTrieNodes(Keywords)>(Keywords);
+}
@@ -0,0 +1,802 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "Parsing.h"
+#include "SourceLocation.h"
+
+// lexer generator
+
+// One token rule: a pattern and the token id matches report. Patterns are a
+// small regular expression language:
+//
+//     abc        literal characters
+//     [a-z_]     a class, with ranges; [^...] negates
+//     .          any byte
+//     \t \n \r   control characters; \ before anything else takes it literally
+//     ( | )      grouping and alternation
+//     * + ?      repetition
+//
+// Matching takes the longest match, and rules earlier in the list win ties.
+
+struct LexerRule {
+    std::string_view pattern;
+    int token;
+};
+
+struct LexerTableMatch {
+    // LexerTable::noMatch when no rule takes even one byte
+    int token;
+    size_t length;
+};
+
+// Generation limits: the DFA is built in scratch space of this size before
+// being packed to fit.
+
+constexpr size_t lexerGeneratorMaxStates = 256;
+
+constexpr size_t lexerGeneratorMaxClasses = 256;
+
+// Thompson construction bound for a rule list: two states per atom or
+// operator, plus the splits joining the rules.
+
+template <typename Rules>
+constexpr size_t lexerNfaCapacity(
+    const Rules& rules)
+{
+    size_t capacity = 1;
+
+    for (const auto& rule : rules) {
+
+        capacity += 4 * rule.pattern.size() + 4;
+    }
+
+    return capacity;
+}
+
+///
+
+// The generator, run at compile time. Each step is the textbook one: regular
+// expressions to a Thompson NFA, bytes grouped into classes no pattern tells
+// apart, then subset construction over classes rather than bytes.
+
+template <size_t NfaCapacity>
+class LexerGenerator final {
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    static constexpr size_t words = (NfaCapacity + 63) / 64;
+
+    using ByteSet = std::array<uint64_t, 4>;
+
+    using StateSet = std::array<uint64_t, words>;
+
+    ///
+
+    template <typename Rules>
+    constexpr explicit LexerGenerator(
+        const Rules& rules)
+    {
+        m_charSet.fill({ });
+
+        m_charNext.fill(none);
+
+        m_epsilon0.fill(none);
+
+        m_epsilon1.fill(none);
+
+        m_accept.fill(-1);
+
+        ///
+
+        auto root = addState();
+
+        size_t index = 0;
+
+        for (const auto& rule : rules) {
+
+            m_pattern = rule.pattern;
+
+            m_position = 0;
+
+            const auto fragment = parseAlternation();
+
+            if (m_position != m_pattern.size()) {
+
+                fail("unbalanced parenthesis in lexer rule");
+            }
+
+            m_accept[fragment.end] = int(index);
+
+            // chain the rules off the root through splits
+
+            if (index + 1 < std::size(rules)) {
+
+                const auto split = addState();
+
+                m_epsilon0[root] = fragment.start;
+
+                m_epsilon1[root] = split;
+
+                root = split;
+            } else {
+
+                m_epsilon0[root] = fragment.start;
+            }
+
+            ++index;
+        }
+
+        buildClasses();
+
+        buildDfa();
+    }
+
+    constexpr size_t states() const
+    {
+        return m_dfaStates;
+    }
+
+    constexpr size_t classes() const
+    {
+        return m_classes;
+    }
+
+    constexpr uint8_t classOf(
+        unsigned char byte) const
+    {
+        return m_classOf[byte];
+    }
+
+    constexpr uint16_t transition(
+        size_t state,
+        size_t byteClass) const
+    {
+        return m_transitions[state * lexerGeneratorMaxClasses + byteClass];
+    }
+
+    // The winning rule's index in an accepting state, otherwise -1.
+
+    constexpr int accept(
+        size_t state) const
+    {
+        return m_dfaAccept[state];
+    }
+
+private:
+    struct Fragment {
+        uint32_t start;
+        uint32_t end;
+    };
+
+    // Reaching this during constant evaluation stops compilation, with the
+    // message in the diagnostic.
+
+    static constexpr void fail(
+        const char* message)
+    {
+        throw message;
+    }
+
+    constexpr uint32_t addState()
+    {
+        if (m_states >= NfaCapacity) {
+
+            fail("lexer rules need more NFA states than estimated");
+        }
+
+        return m_states++;
+    }
+
+    constexpr Fragment charSet(
+        const ByteSet& set)
+    {
+        const auto start = addState();
+
+        const auto end = addState();
+
+        m_charSet[start] = set;
+
+        m_charNext[start] = end;
+
+        return { start, end };
+    }
+
+    ///
+
+    constexpr bool atEnd() const
+    {
+        return m_position >= m_pattern.size();
+    }
+
+    constexpr Fragment parseAlternation()
+    {
+        auto left = parseConcatenation();
+
+        while (!atEnd() && m_pattern[m_position] == '|') {
+
+            ++m_position;
+
+            const auto right = parseConcatenation();
+
+            const auto start = addState();
+
+            const auto end = addState();
+
+            m_epsilon0[start] = left.start;
+
+            m_epsilon1[start] = right.start;
+
+            m_epsilon0[left.end] = end;
+
+            m_epsilon0[right.end] = end;
+
+            left = { start, end };
+        }
+
+        return left;
+    }
+
+    constexpr Fragment parseConcatenation()
+    {
+        std::optional<Fragment> result;
+
+        while (!atEnd() && m_pattern[m_position] != '|' && m_pattern[m_position] != ')') {
+
+            const auto next = parseRepetition();
+
+            if (result) {
+
+                m_epsilon0[result->end] = next.start;
+
+                result->end = next.end;
+            } else {
+
+                result = next;
+            }
+        }
+
+        if (!result) {
+
+            const auto empty = addState();
+
+            return { empty, empty };
+        }
+
+        return *result;
+    }
+
+    constexpr Fragment parseRepetition()
+    {
+        auto fragment = parseAtom();
+
+        while (!atEnd()) {
+
+            const auto op = m_pattern[m_position];
+
+            if (op == '*') {
+
+                const auto start = addState();
+
+                const auto end = addState();
+
+                m_epsilon0[start] = fragment.start;
+
+                m_epsilon1[start] = end;
+
+                m_epsilon0[fragment.end] = fragment.start;
+
+                m_epsilon1[fragment.end] = end;
+
+                fragment = { start, end };
+            } else if (op == '+') {
+
+                const auto end = addState();
+
+                m_epsilon0[fragment.end] = fragment.start;
+
+                m_epsilon1[fragment.end] = end;
+
+                fragment = { fragment.start, end };
+            } else if (op == '?') {
+
+                const auto start = addState();
+
+                m_epsilon0[start] = fragment.start;
+
+                m_epsilon1[start] = fragment.end;
+
+                fragment = { start, fragment.end };
+            } else {
+
+                break;
+            }
+
+            ++m_position;
+        }
+
+        return fragment;
+    }
+
+    constexpr Fragment parseAtom()
+    {
+        const auto c = m_pattern[m_position++];
+
+        if (c == '(') {
+
+            const auto inner = parseAlternation();
+
+            if (atEnd() || m_pattern[m_position] != ')') {
+
+                fail("unbalanced parenthesis in lexer rule");
+            }
+
+            ++m_position;
+
+            return inner;
+        }
+
+        if (c == '[') {
+
+            return charSet(parseClass());
+        }
+
+        ByteSet set { };
+
+        if (c == '.') {
+
+            set.fill(~uint64_t(0));
+        } else if (c == '\\') {
+
+            add(set, parseEscape());
+        } else if (c == '*' || c == '+' || c == '?') {
+
+            fail("repetition with nothing to repeat in lexer rule");
+        } else {
+
+            add(set, static_cast<unsigned char>(c));
+        }
+
+        return charSet(set);
+    }
+
+    constexpr ByteSet parseClass()
+    {
+        ByteSet set { };
+
+        auto negate = false;
+
+        if (!atEnd() && m_pattern[m_position] == '^') {
+
+            negate = true;
+
+            ++m_position;
+        }
+
+        auto first = true;
+
+        while (!atEnd() && (first || m_pattern[m_position] != ']')) {
+
+            first = false;
+
+            auto low = static_cast<unsigned char>(m_pattern[m_position++]);
+
+            if (low == '\\' && !atEnd()) {
+
+                low = parseEscape();
+            }
+
+            auto high = low;
+
+            // a '-' first or last is literal
+
+            if (m_position + 1 < m_pattern.size() && m_pattern[m_position] == '-' && m_pattern[m_position + 1] != ']') {
+
+                ++m_position;
+
+                high = static_cast<unsigned char>(m_pattern[m_position++]);
+
+                if (high == '\\' && !atEnd()) {
+
+                    high = parseEscape();
+                }
+            }
+
+            for (unsigned byte = low; byte <= high; ++byte) {
+
+                add(set, byte);
+            }
+        }
+
+        if (atEnd()) {
+
+            fail("unterminated class in lexer rule");
+        }
+
+        ++m_position;
+
+        if (negate) {
+
+            for (auto& word : set) {
+
+                word = ~word;
+            }
+        }
+
+        return set;
+    }
+
+    constexpr unsigned char parseEscape()
+    {
+        if (atEnd()) {
+
+            fail("trailing backslash in lexer rule");
+        }
+
+        const auto c = m_pattern[m_position++];
+
+        switch (c) {
+        case 't':
+            return '\t';
+
+        case 'n':
+            return '\n';
+
+        case 'r':
+            return '\r';
+
+        default:
+            return static_cast<unsigned char>(c);
+        }
+    }
+
+    static constexpr void add(
+        ByteSet& set,
+        unsigned byte)
+    {
+        set[byte >> 6] |= uint64_t(1) << (byte & 63);
+    }
+
+    static constexpr bool contains(
+        const ByteSet& set,
+        unsigned byte)
+    {
+        return (set[byte >> 6] >> (byte & 63)) & 1;
+    }
+
+    ///
+
+    // Splits byte classes on each character edge in turn, so two bytes share
+    // a class exactly when every edge takes both or neither.
+
+    constexpr void buildClasses()
+    {
+        m_classOf.fill(0);
+
+        m_classes = 1;
+
+        for (uint32_t state = 0; state < m_states; ++state) {
+
+            if (m_charNext[state] == none) {
+
+                continue;
+            }
+
+            std::array<int, lexerGeneratorMaxClasses * 2> renumber { };
+
+            renumber.fill(-1);
+
+            size_t classes = 0;
+
+            for (unsigned byte = 0; byte < 256; ++byte) {
+
+                const auto key = m_classOf[byte] * 2 + (contains(m_charSet[state], byte) ? 1 : 0);
+
+                if (renumber[key] < 0) {
+
+                    renumber[key] = int(classes++);
+                }
+
+                m_classOf[byte] = uint8_t(renumber[key]);
+            }
+
+            m_classes = classes;
+        }
+
+        m_representative.fill(0);
+
+        for (int byte = 255; byte >= 0; --byte) {
+
+            m_representative[m_classOf[byte]] = uint8_t(byte);
+        }
+    }
+
+    constexpr void closure(
+        StateSet& set) const
+    {
+        std::array<uint32_t, NfaCapacity> stack { };
+
+        size_t depth = 0;
+
+        for (uint32_t state = 0; state < m_states; ++state) {
+
+            if ((set[state >> 6] >> (state & 63)) & 1) {
+
+                stack[depth++] = state;
+            }
+        }
+
+        while (depth > 0) {
+
+            const auto state = stack[--depth];
+
+            for (const auto next : { m_epsilon0[state], m_epsilon1[state] }) {
+
+                if (next != none && !((set[next >> 6] >> (next & 63)) & 1)) {
+
+                    set[next >> 6] |= uint64_t(1) << (next & 63);
+
+                    stack[depth++] = next;
+                }
+            }
+        }
+    }
+
+    constexpr void buildDfa()
+    {
+        m_transitions.fill(0);
+
+        m_dfaAccept.fill(-1);
+
+        // state 0 is dead, with every transition to itself; state 1 starts
+
+        m_dfaSets[0] = { };
+
+        StateSet start { };
+
+        start[0] = 1;
+
+        closure(start);
+
+        m_dfaSets[1] = start;
+
+        m_dfaStates = 2;
+
+        for (size_t current = 1; current < m_dfaStates; ++current) {
+
+            const auto set = m_dfaSets[current];
+
+            for (uint32_t state = 0; state < m_states; ++state) {
+
+                if (((set[state >> 6] >> (state & 63)) & 1) && m_accept[state] >= 0
+                    && (m_dfaAccept[current] < 0 || m_accept[state] < m_dfaAccept[current])) {
+
+                    m_dfaAccept[current] = m_accept[state];
+                }
+            }
+
+            for (size_t byteClass = 0; byteClass < m_classes; ++byteClass) {
+
+                const auto byte = m_representative[byteClass];
+
+                StateSet next { };
+
+                for (uint32_t state = 0; state < m_states; ++state) {
+
+                    if (((set[state >> 6] >> (state & 63)) & 1) && m_charNext[state] != none && contains(m_charSet[state], byte)) {
+
+                        const auto target = m_charNext[state];
+
+                        next[target >> 6] |= uint64_t(1) << (target & 63);
+                    }
+                }
+
+                closure(next);
+
+                size_t found = 0;
+
+                while (found < m_dfaStates && m_dfaSets[found] != next) {
+
+                    ++found;
+                }
+
+                if (found == m_dfaStates) {
+
+                    if (m_dfaStates >= lexerGeneratorMaxStates) {
+
+                        fail("lexer rules need more DFA states than the generator allows");
+                    }
+
+                    m_dfaSets[m_dfaStates++] = next;
+                }
+
+                m_transitions[current * lexerGeneratorMaxClasses + byteClass] = uint16_t(found);
+            }
+        }
+    }
+
+    ///
+
+    std::array<ByteSet, NfaCapacity> m_charSet { };
+
+    std::array<uint32_t, NfaCapacity> m_charNext { };
+
+    std::array<uint32_t, NfaCapacity> m_epsilon0 { };
+
+    std::array<uint32_t, NfaCapacity> m_epsilon1 { };
+
+    std::array<int, NfaCapacity> m_accept { };
+
+    uint32_t m_states = 0;
+
+    std::string_view m_pattern;
+
+    size_t m_position = 0;
+
+    std::array<uint8_t, 256> m_classOf { };
+
+    std::array<uint8_t, lexerGeneratorMaxClasses> m_representative { };
+
+    size_t m_classes = 0;
+
+    std::array<StateSet, lexerGeneratorMaxStates> m_dfaSets { };
+
+    std::array<uint16_t, lexerGeneratorMaxStates * lexerGeneratorMaxClasses> m_transitions { };
+
+    std::array<int, lexerGeneratorMaxStates> m_dfaAccept { };
+
+    size_t m_dfaStates = 0;
+};
+
+///
+
+// The generated DFA, packed to its real size: a byte-to-class map, a
+// transition row per state and each state's token.
+//
+// Matching is one table load per byte with the accepting position tracked by
+// selects rather than branches, so the only data-dependent branch is the one
+// leaving the loop at the end of each token. Build one with makeLexerTable.
+
+template <size_t States, size_t Classes>
+class LexerTable final {
+public:
+    static constexpr int noMatch = -1;
+
+    template <size_t NfaCapacity, typename Rules>
+    constexpr LexerTable(
+        const LexerGenerator<NfaCapacity>& generator,
+        const Rules& rules)
+    {
+        for (unsigned byte = 0; byte < 256; ++byte) {
+
+            m_classOf[byte] = generator.classOf(static_cast<unsigned char>(byte));
+        }
+
+        for (size_t state = 0; state < States; ++state) {
+
+            for (size_t byteClass = 0; byteClass < Classes; ++byteClass) {
+
+                m_transitions[state * Classes + byteClass] = generator.transition(state, byteClass);
+            }
+
+            const auto rule = generator.accept(state);
+
+            m_token[state] = rule < 0 ? noMatch : std::data(rules)[rule].token;
+        }
+    }
+
+    // The longest match at `position`; its length is 1 with noMatch when no
+    // rule takes the byte there, so callers can report it and move on.
+
+    const LexerTableMatch match(
+        std::string_view source,
+        size_t position) const
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(source.data());
+
+        uint32_t state = 1;
+
+        auto token = noMatch;
+
+        size_t length = 1;
+
+        for (auto i = position; i < source.size(); ++i) {
+
+            state = m_transitions[state * Classes + m_classOf[bytes[i]]];
+
+            if (state == 0) {
+
+                break;
+            }
+
+            const auto accepted = m_token[state];
+
+            const auto accepting = accepted != noMatch;
+
+            token = accepting ? accepted : token;
+
+            length = accepting ? i + 1 - position : length;
+        }
+
+        return { token, length };
+    }
+
+    static constexpr size_t states()
+    {
+        return States;
+    }
+
+    static constexpr size_t classes()
+    {
+        return Classes;
+    }
+
+private:
+    std::array<uint8_t, 256> m_classOf { };
+
+    std::array<uint16_t, States * Classes> m_transitions { };
+
+    std::array<int, States> m_token { };
+};
+
+// Generates the table for a constexpr rule array, sized to fit:
+//
+//     constexpr LexerRule rules[] = {
+//         { "[a-z_][a-z0-9_]*", Identifier },
+//         { "[0-9]+", Number },
+//         { "[ \t\n]+", Whitespace },
+//     };
+//
+//     constexpr auto table = makeLexerTable<rules>();
+
+template <const auto& Rules>
+constexpr auto makeLexerTable()
+{
+    constexpr LexerGenerator<lexerNfaCapacity(Rules)> generator(Rules);
+
+    return LexerTable<generator.states(), generator.classes()>(generator, Rules);
+}
+
+///
+
+// Lexes all of `source` with `table` into tokens for Parser<T>. `makeToken`
+// is called as makeToken(token, location, text) for each match, with noMatch
+// and a single byte where no rule applies, and returns the token or nullptr
+// to skip it, as for whitespace. Appending an end-of-file token, if the
+// grammar wants one, is left to the caller.
+
+template <typename T, size_t States, size_t Classes, typename MakeToken>
+const std::vector<std::unique_ptr<T>> lexWithTable(
+    std::string_view source,
+    const LexerTable<States, Classes>& table,
+    const MakeToken& makeToken)
+{
+    std::vector<std::unique_ptr<T>> tokens;
+
+    Lexer<T> lexer(source);
+
+    while (!lexer.isEof()) {
+
+        const auto start = lexer.position();
+
+        const auto found = table.match(source, size_t(start));
+
+        lexer.increment(int(found.length));
+
+        auto token = makeToken(found.token, SourceLocation(start, lexer.position()), source.substr(size_t(start), found.length));
+
+        if (token) {
+
+            tokens.push_back(std::move(token));
+        }
+    }
+
+    return tokens;
+}
@@ -0,0 +1,73 @@
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// parallel loops
+
+void Parallel::forEach(
+    size_t count,
+    size_t grain,
+    const std::function<void(size_t, size_t)>& body)
+{
+    if (count == 0) {
+
+        return;
+    }
+
+    ///
+
+    const auto chunk = std::max(size_t(1), grain);
+
+    const auto chunks = (count + chunk - 1) / chunk;
+
+    const auto workers = std::min(Parallel::threadCount(), chunks);
+
+    if (workers <= 1) {
+
+        body(0, count);
+
+        return;
+    }
+
+    ///
+
+    std::atomic<size_t> next = 0;
+
+    const auto work = [&]() {
+        while (true) {
+
+            const auto begin = next.fetch_add(chunk, std::memory_order_relaxed);
+
+            if (begin >= count) {
+
+                return;
+            }
+
+            body(begin, std::min(begin + chunk, count));
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    threads.reserve(workers - 1);
+
+    for (size_t i = 1; i < workers; ++i) {
+
+        threads.emplace_back(work);
+    }
+
+    work();
+
+    for (auto& thread : threads) {
+
+        thread.join();
+    }
+}
+
+const size_t Parallel::threadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// parallel loops
+
+class Parallel final {
+public:
+    // Splits [0, count) into chunks of `grain` and runs `body(begin, end)` on every
+    // hardware thread until the chunks run out. The calling thread takes part, and
+    // the call returns once every chunk has finished.
+
+    static void forEach(
+        size_t count,
+        size_t grain,
+        const std::function<void(size_t, size_t)>& body);
+
+    static const size_t threadCount();
+};
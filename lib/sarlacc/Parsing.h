@@ -1,21 +1,39 @@
 
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include "Error.h"
+#include "KeywordTrie.h"
+#include "SourceMap.h"
 
 template <typename T>
 class Lexer {
 public:
-    Lexer(const std::string& source)
+    // Lexers view their source rather than copy it, so it must outlive them.
+
+    Lexer(std::string_view source)
         : m_source(source)
     {
     }
 
+    Lexer(std::span<const std::byte> source)
+        : m_source(reinterpret_cast<const char*>(source.data()), source.size())
+    {
+    }
+
     Lexer(const Lexer&) = delete;
 
     Lexer& operator=(const Lexer&) = delete;
@@ -38,19 +56,19 @@ public:
     const std ::tuple<std::optional<char>, std::optional<Error>> peek() const
     {
         if (isEof()) {
-            return { std::nullopt, Error(ErrorType::Lexer, "Unexpected end of file") };
+            return { std::nullopt, Error(ErrorType::Lexer, ErrorCode::UnexpectedEof, "Unexpected end of file", SourceLocation(m_position)) };
         }
 
         return { m_source[m_position], std::nullopt };
     }
 
-    const std::tuple<std::optional<std::string>, std::optional<Error>> peek(
+    const std::tuple<std::optional<std::string_view>, std::optional<Error>> peek(
         int length) const
     {
         const auto end = m_position + length;
 
         if (end > m_source.size()) {
-            return { std::nullopt, Error(ErrorType::Lexer, "eof reached") };
+            return { std::nullopt, Error(ErrorType::Lexer, ErrorCode::UnexpectedEof, "eof reached", SourceLocation(m_position)) };
         }
 
         return { m_source.substr(m_position, length), std::nullopt };
@@ -58,169 +76,112 @@ public:
 
     ///
 
+    // Matching reads the source in place: no copies, no allocation, and
+    // predicates are template parameters so they inline into the caller's
+    // loop rather than going through std::function.
+
     const bool match(
         char equals,
         int distance = 0) const
     {
-        if (isEof()) {
-            return false;
-        }
-
-        ///
-
-        const auto length = 1 + distance;
-
-        ///
-
-        const auto end = m_position + length;
-
-        if (end > m_source.size()) {
-            return false;
-        }
-
-        ///
-
-        const auto& peekTuple = peek(length);
-
-        const auto& peekOrNull = std::get<std::optional<std::string>>(peekTuple);
-
-        const auto& peekError = std::get<std::optional<Error>>(peekTuple);
+        const auto index = size_t(m_position) + size_t(distance);
 
-        if (peekError.has_value()) {
-            return false;
-        }
-
-        if (!peekOrNull.has_value()) {
-            return false;
-        }
-
-        const auto& peek = peekOrNull.value();
-
-        if (peek.size() != length) {
-            return false;
-        }
-
-        ///
-
-        return peek[distance] == equals;
+        return index < m_source.size() && m_source[index] == equals;
     }
 
+    template <typename Predicate>
+        requires(std::predicate<const Predicate&, char>)
     const bool match(
-        std::function<bool(char)> equals,
+        const Predicate& equals,
         int distance = 0) const
     {
-        if (isEof()) {
-            return false;
-        }
-
-        ///
-
-        const auto length = 1 + distance;
-
-        ///
-
-        const auto end = m_position + length;
-
-        if (end > m_source.size()) {
-            return false;
-        }
-
-        ///
-
-        const auto& peekTuple = peek(length);
-
-        const auto& peekOrNull = std::get<std::optional<std::string>>(peekTuple);
-
-        const auto& peekError = std::get<std::optional<Error>>(peekTuple);
+        const auto index = size_t(m_position) + size_t(distance);
 
-        if (peekError.has_value()) {
-            return false;
-        }
-
-        if (!peekOrNull.has_value()) {
-            return false;
-        }
-
-        const auto& peek = peekOrNull.value();
-
-        if (peek.size() != length) {
-            return false;
-        }
-
-        ///
-
-        return equals(peek[distance]);
+        return index < m_source.size() && equals(m_source[index]);
     }
 
     const bool match(
-        const std::string& equals,
+        std::string_view equals,
         int distance = 0) const
     {
-        if (isEof()) {
+        const auto index = size_t(m_position) + size_t(distance);
+
+        if (index > m_source.size() || m_source.size() - index < equals.size()) {
             return false;
         }
 
-        ///
-
-        const auto length = equals.size() + distance;
+        return m_source.compare(index, equals.size(), equals) == 0;
+    }
 
-        ///
+    ///
 
-        const auto end = m_position + length;
+    // The first of `reservedNames` at the current position, as a view of the
+    // source. This tries each name in turn; larger sets belong in a
+    // KeywordTrie.
 
-        if (end > m_source.size()) {
-            return false;
+    template <typename Names>
+        requires(!std::is_convertible_v<const Names&, std::string_view> && !std::predicate<const Names&, char>)
+    const std::optional<std::string_view> match(
+        const Names& reservedNames) const
+    {
+        for (const auto& reservedName : reservedNames) {
+            if (match(std::string_view(reservedName))) {
+                return m_source.substr(m_position, std::string_view(reservedName).size());
+            }
         }
 
-        ///
-
-        const auto& peekTuple = peek(length);
+        return std::nullopt;
+    }
 
-        const auto& peekOrNull = std::get<std::optional<std::string>>(peekTuple);
+    const std::optional<std::string_view> match(
+        std::initializer_list<std::string_view> reservedNames) const
+    {
+        return match<std::initializer_list<std::string_view>>(reservedNames);
+    }
 
-        const auto& peekError = std::get<std::optional<Error>>(peekTuple);
+    // The longest keyword in `keywords` at the current position, in one pass.
 
-        if (peekError.hasValue()) {
-            return false;
+    template <size_t Count, size_t NodeCapacity>
+    const std::optional<std::string_view> match(
+        const KeywordTrie<Count, NodeCapacity>& keywords) const
+    {
+        if (isEof()) {
+            return std::nullopt;
         }
 
-        if (!peekOrNull.hasValue() || peekOrNull.value().size() != length) {
-            return false;
+        const auto found = keywords.match(m_source.substr(m_position));
+
+        if (!found.has_value()) {
+            return std::nullopt;
         }
 
-        ///
+        return m_source.substr(m_position, found->length);
+    }
 
-        const auto sub = peekOrNull.value().substr(distance, equals.size());
+    ///
 
-        ///
+    const std::string_view source() const { return m_source; }
 
-        return sub == equals;
-    }
+    const int& position() const { return m_position; }
 
-    ///
+    // Line and column lookups for this source, made on first use and meant to
+    // be handed on to the parser and to errors rather than rebuilt by each.
 
-    const std::optional<std::string> match(
-        const std::vector<std::string> reservedNames) const
+    const std::shared_ptr<const SourceMap>& sourceMap() const
     {
-        for (const auto& reservedName : reservedNames) {
-            if (match(reservedName)) {
-                return reservedName;
-            }
+        if (!m_sourceMap) {
+            m_sourceMap = std::make_shared<const SourceMap>(m_source);
         }
 
-        return std::nullopt;
+        return m_sourceMap;
     }
 
-    ///
-
-    const std::string& source() const { return m_source; }
-
-    const int& position() const { return m_position; }
-
 private:
-    const std::string& m_source;
+    const std::string_view m_source;
 
     int m_position = 0;
+
+    mutable std::shared_ptr<const SourceMap> m_sourceMap;
 };
 
 ///
@@ -228,11 +189,38 @@ private:
 template <typename T>
 class Parser {
 public:
+    // Yields the next token, or nullptr once there are no more.
+
+    using TokenSource = std::function<std::unique_ptr<T>()>;
+
+    // `sourceMap`, if given, must be over the same source, typically the
+    // lexer's.
+
+    Parser(
+        std::string_view source,
+        const std::vector<std::unique_ptr<T>>& tokens,
+        std::shared_ptr<const SourceMap> sourceMap = nullptr)
+        : m_source(source)
+        , m_tokens(&tokens)
+        , m_sourceMap(std::move(sourceMap))
+    {
+    }
+
+    // Streaming: tokens are pulled from `next` as the parser reaches them and
+    // dropped once it moves past, so at most `lookahead` are held at a time
+    // instead of the whole source's worth, and lexing overlaps parsing. Dropped
+    // tokens are freed, so references from peek() die with the increment past
+    // them; negative increments are ignored, and tokens() is empty.
+
     Parser(
-        const std::string& source,
-        const std::vector<std::unique_ptr<T>>& tokens)
+        std::string_view source,
+        TokenSource next,
+        size_t lookahead = 2,
+        std::shared_ptr<const SourceMap> sourceMap = nullptr)
         : m_source(source)
-        , m_tokens(tokens)
+        , m_sourceMap(std::move(sourceMap))
+        , m_next(std::move(next))
+        , m_ring(std::max<size_t>(lookahead, 1))
     {
     }
 
@@ -244,7 +232,14 @@ public:
 
     const std::vector<std::unique_ptr<T>>& tokens() const
     {
-        return m_tokens;
+        static const std::vector<std::unique_ptr<T>> none;
+
+        return isStreaming() ? none : *m_tokens;
+    }
+
+    const bool isStreaming() const
+    {
+        return m_tokens == nullptr;
     }
 
     const int& position() const
@@ -254,66 +249,170 @@ public:
 
     const bool isEof() const
     {
-        return m_position >= m_tokens.size();
+        return at(0) == nullptr;
     }
 
     void increment(
         int amount = 1)
     {
-        m_position += amount;
+        if (!isStreaming()) {
+            m_position += amount;
+
+            return;
+        }
+
+        // the position counts tokens consumed, never ones the source did not
+        // produce
+
+        for (auto i = 0; i < amount; ++i) {
+            if (at(0) == nullptr) {
+                break;
+            }
+
+            m_lastEnd = m_ring[m_ringStart]->location().end;
+
+            m_ring[m_ringStart].reset();
+
+            m_ringStart = (m_ringStart + 1) % m_ring.size();
+
+            --m_ringCount;
+
+            ++m_position;
+        }
     }
 
     const SourceLocation location() const
     {
-        if (isEof()) {
+        const auto* token = at(0);
+
+        if (token == nullptr) {
             return SourceLocation(m_position);
         }
 
-        return m_tokens[m_position]->location();
+        return token->location();
     }
 
     const SourceLocation location(
         int start) const
     {
-        if (tokens().empty()) {
-            return { 0, 0 };
-        }
+        const auto* token = at(0);
 
-        if (m_position >= tokens().size()) {
-            return { start, tokens().end()->get()->location().end };
+        if (token == nullptr) {
+            return { start, lastEnd() };
         }
 
-        return { start, tokens().at(m_position).get()->location().end };
+        return { start, token->location().end };
     }
 
     const int start() const
     {
-        if (tokens()->empty()) {
-            return 0;
-        }
+        const auto* token = at(0);
 
-        if (m_position >= tokens()->size()) {
-            return tokens()->end()->get()->location().start;
+        if (token == nullptr) {
+            return lastEnd();
         }
 
-        return tokens().at(m_position).get()->location().start;
+        return token->location().start;
     }
 
     ///
 
-    const std::optional<std::reference_wrapper<const T>> peek() const
+    const std::optional<std::reference_wrapper<const T>> peek(
+        size_t distance = 0) const
     {
-        if (isEof()) {
+        const auto* token = at(distance);
+
+        if (token == nullptr) {
             return std::nullopt;
         }
 
-        return std::cref(*tokens().at(m_position));
+        return std::cref(*token);
+    }
+
+    // One more than the farthest distance peek can see past the current
+    // token: the ring's size when streaming, unbounded otherwise.
+
+    const size_t lookahead() const
+    {
+        return isStreaming() ? m_ring.size() : SIZE_MAX;
+    }
+
+    const std::shared_ptr<const SourceMap>& sourceMap() const
+    {
+        if (!m_sourceMap) {
+            m_sourceMap = std::make_shared<const SourceMap>(m_source);
+        }
+
+        return m_sourceMap;
     }
 
 private:
-    const std::string& m_source;
+    // The token `distance` past the current one, pulling from the source as
+    // needed; nullptr past the end, or past the lookahead when streaming.
+
+    const T* at(
+        size_t distance) const
+    {
+        if (!isStreaming()) {
+            const auto index = size_t(m_position) + distance;
+
+            return index < m_tokens->size() ? (*m_tokens)[index].get() : nullptr;
+        }
+
+        if (distance >= m_ring.size()) {
+            return nullptr;
+        }
+
+        while (m_ringCount <= distance && !m_sourceDone) {
+            auto token = m_next();
+
+            if (!token) {
+                m_sourceDone = true;
+
+                break;
+            }
+
+            m_ring[(m_ringStart + m_ringCount) % m_ring.size()] = std::move(token);
 
-    const std::vector<std::unique_ptr<T>>& m_tokens;
+            ++m_ringCount;
+        }
+
+        if (distance >= m_ringCount) {
+            return nullptr;
+        }
+
+        return m_ring[(m_ringStart + distance) % m_ring.size()].get();
+    }
+
+    const int lastEnd() const
+    {
+        if (!isStreaming()) {
+            return m_tokens->empty() ? 0 : m_tokens->back()->location().end;
+        }
+
+        return m_lastEnd;
+    }
+
+    const std::string_view m_source;
+
+    const std::vector<std::unique_ptr<T>>* m_tokens = nullptr;
+
+    mutable std::shared_ptr<const SourceMap> m_sourceMap;
 
     int m_position = 0;
-};
\ No newline at end of file
+
+    // streaming state; pulling ahead is not a change the parser can see, so
+    // const accessors may do it
+
+    TokenSource m_next;
+
+    mutable std::vector<std::unique_ptr<T>> m_ring;
+
+    mutable size_t m_ringStart = 0;
+
+    mutable size_t m_ringCount = 0;
+
+    mutable bool m_sourceDone = false;
+
+    int m_lastEnd = 0;
+};
@@ -1,11 +1,25 @@
 
 #include "Path.h"
 
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LexerGenerator.h"
+
 // path lexing
 
 const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>> PathLexer::lexFromSource(
-    const std::string& source)
+    std::string_view source)
 {
+    SARLACC_STATS_PHASE("lex", lexNanoseconds);
+
+    SARLACC_STATS_ADD(bytesLexed, source.size());
+
     std::optional<Error> error = std::nullopt;
 
     ///
@@ -33,16 +47,18 @@ const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>>
             break;
         }
 
+        SARLACC_STATS_COUNT(tokenCounts, token->type());
+
         tokens.push_back(std::move(token));
     }
 
     ///
 
-    const auto& last = tokens.back();
-
-    if (last->type() != PathTokenType::Eof) {
+    if (tokens.empty() || tokens.back()->type() != PathTokenType::Eof) {
         tokens.push_back(std::make_unique<PathEofToken>(
             SourceLocation(lexer.position())));
+
+        SARLACC_STATS_COUNT(tokenCounts, PathTokenType::Eof);
     }
 
     ///
@@ -50,6 +66,105 @@ const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>>
     return { std::move(tokens), error };
 }
 
+const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>> PathLexer::lexFromSource(
+    std::span<const std::byte> source)
+{
+    return PathLexer::lexFromSource(std::string_view(reinterpret_cast<const char*>(source.data()), source.size()));
+}
+
+namespace {
+
+enum class PathRule {
+    Command,
+    Number,
+    Whitespace,
+    Comma,
+};
+
+// the hand-written lexer's rules: a number's tail takes '-' and exponents, and
+// a '.' only when more of the number follows
+
+constexpr LexerRule pathRules[] = {
+    { "[AaCcHhLlMmQqSsTtVvZz]", int(PathRule::Command) },
+    { "-?[0-9]([-0-9eE]|\\.[-0-9eE])*", int(PathRule::Number) },
+    { "[ \t\n\r]+", int(PathRule::Whitespace) },
+    { ",", int(PathRule::Comma) },
+};
+
+constexpr auto pathTable = makeLexerTable<pathRules>();
+
+}
+
+const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>> PathLexer::lexFromSourceWithTable(
+    std::string_view source)
+{
+    SARLACC_STATS_PHASE("lex", lexNanoseconds);
+
+    SARLACC_STATS_ADD(bytesLexed, source.size());
+
+    // single character tokens sit at their end, as lexToken places them
+
+    auto tokens = lexWithTable<PathToken>(source, pathTable, [](int rule, SourceLocation location, std::string_view text) -> std::unique_ptr<PathToken> {
+        switch (rule) {
+        case int(PathRule::Command):
+            return std::make_unique<PathCommandToken>(SourceLocation(location.end), text[0]);
+
+        case int(PathRule::Number):
+            return std::make_unique<PathNumberToken>(std::move(location), std::string(text));
+
+        case int(PathRule::Comma):
+            return std::make_unique<PathPuncToken>(SourceLocation(location.end), PathPuncType::Comma, ",");
+
+        case int(PathRule::Whitespace):
+            return nullptr;
+
+        default:
+            return std::make_unique<PathUnknownToken>(SourceLocation(location.end), text[0]);
+        }
+    });
+
+    tokens.push_back(std::make_unique<PathEofToken>(SourceLocation(int(source.size()))));
+
+#if defined(SARLACC_PARSE_STATS)
+    for (const auto& token : tokens) {
+
+        SARLACC_STATS_COUNT(tokenCounts, token->type());
+    }
+#endif
+
+    return { std::move(tokens), std::nullopt };
+}
+
+const Parser<PathToken>::TokenSource PathLexer::tokenStream(
+    std::string_view source)
+{
+    // std::function wants a copyable callable, and the lexer is not
+
+    auto lexer = std::make_shared<Lexer<PathToken>>(source);
+
+    auto done = std::make_shared<bool>(false);
+
+    return [lexer, done]() -> std::unique_ptr<PathToken> {
+        if (*done) {
+
+            return nullptr;
+        }
+
+        auto tokenTuple = PathLexer::lexToken(*lexer);
+
+        auto& token = std::get<std::unique_ptr<PathToken>>(tokenTuple);
+
+        if (std::get<std::optional<Error>>(tokenTuple).has_value() || token->type() == PathTokenType::Eof) {
+
+            *done = true;
+        }
+
+        SARLACC_STATS_COUNT(tokenCounts, token->type());
+
+        return std::move(token);
+    };
+}
+
 const bool PathLexer::isDigit(
     const char& c)
 {
@@ -180,12 +295,12 @@ const std::tuple<std::unique_ptr<PathToken>, std::optional<Error>> PathLexer::le
 
                 const auto len = lexer.position() - start + (lexer.isEof() ? 1 : 0);
 
-                const auto& source = lexer.source().substr(start, len);
+                const auto source = lexer.source().substr(start, len);
 
                 return {
                     std::make_unique<PathNumberToken>(
                         SourceLocation(start, lexer.position()),
-                        source),
+                        std::string(source)),
                     error
                 };
             } else if (peek == ' '
@@ -239,8 +354,9 @@ const std::tuple<std::unique_ptr<PathToken>, std::optional<Error>> PathLexer::le
 
 // path parsing
 
-const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::optional<Error>> PathParser::parsePathFromSource(
-    const std::string& source)
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> BasicPathParser<T>::parsePathFromSource(
+    std::string_view source)
 {
     const auto lexedTuple = PathLexer::lexFromSource(source);
 
@@ -255,19 +371,287 @@ const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::opti
 
     ///
 
-    Parser<PathToken> parser(source, lexedTokens);
+    return BasicPathParser<T>::parsePathFromTokens(source, lexedTokens);
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> BasicPathParser<T>::parsePathFromTokens(
+    std::string_view source,
+    const std::vector<std::unique_ptr<PathToken>>& tokens)
+{
+    Parser<PathToken> parser(source, tokens);
+
+    ///
+
+    return BasicPathParser<T>::parseSubPaths(parser);
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> BasicPathParser<T>::parsePathStreaming(
+    std::string_view source,
+    size_t lookahead)
+{
+    Parser<PathToken> parser(source, PathLexer::tokenStream(source), lookahead);
 
     ///
 
-    return PathParser::parseSubPaths(parser);
+    return BasicPathParser<T>::parseSubPaths(parser);
 }
 
-const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::parsePoint(
+template <typename T>
+const std::tuple<std::vector<std::vector<BasicPathCommand<T>>>, std::vector<Error>> BasicPathParser<T>::parsePathRecovering(
+    std::string_view source,
+    size_t maxErrors)
+{
+    const auto lexedTuple = PathLexer::lexFromSource(source);
+
+    const auto& tokens = std::get<std::vector<std::unique_ptr<PathToken>>>(lexedTuple);
+
+    std::vector<std::vector<BasicPathCommand<T>>> subPaths;
+
+    std::vector<Error> errors;
+
+    if (const auto& lexError = std::get<std::optional<Error>>(lexedTuple)) {
+
+        errors.push_back(lexError.value());
+    }
+
+    ///
+
+    Parser<PathToken> parser(source, tokens);
+
+    std::vector<BasicPathCommand<T>> commands;
+
+    while (!parser.isEof() && errors.size() < maxErrors) {
+
+        const auto position = parser.position();
+
+        auto commandTuple = BasicPathParser<T>::parseCommand(parser);
+
+        auto& command = std::get<std::optional<BasicPathCommand<T>>>(commandTuple);
+
+        const auto& commandError = std::get<std::optional<Error>>(commandTuple);
+
+        if (commandError.has_value()) {
+
+            errors.push_back(commandError.value());
+
+            // always make progress, even when the error is at a command
+
+            if (parser.position() == position) {
+
+                parser.increment();
+            }
+
+            BasicPathParser<T>::skipToCommand(parser);
+
+            continue;
+        }
+
+        if (!command.has_value()) {
+
+            break;
+        }
+
+        const auto closes = command->type == PathCommandType::ClosePath;
+
+        commands.push_back(std::move(command.value()));
+
+        if (closes) {
+
+            subPaths.push_back(std::move(commands));
+
+            commands.clear();
+        }
+    }
+
+    if (!commands.empty()) {
+
+        subPaths.push_back(std::move(commands));
+    }
+
+    ///
+
+    return { std::move(subPaths), std::move(errors) };
+}
+
+template <typename T>
+void BasicPathParser<T>::skipToCommand(
+    Parser<PathToken>& parser)
+{
+    while (!parser.isEof()) {
+
+        const auto type = parser.peek()->get().type();
+
+        if (type == PathTokenType::Command || type == PathTokenType::Eof) {
+
+            break;
+        }
+
+        parser.increment();
+    }
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> BasicPathParser<T>::parsePathFromSource(
+    std::span<const std::byte> source)
+{
+    return BasicPathParser<T>::parsePathFromSource(std::string_view(reinterpret_cast<const char*>(source.data()), source.size()));
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> BasicPathParser<T>::parsePathFromFile(
+    const std::string& path)
+{
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+
+        return { std::nullopt, Error(ErrorType::Unknown, ErrorCode::Io, "cannot open " + path + ": " + std::strerror(errno)) };
+    }
+
+    struct stat status;
+
+    if (::fstat(fd, &status) != 0) {
+
+        const auto error = errno;
+
+        ::close(fd);
+
+        return { std::nullopt, Error(ErrorType::Unknown, ErrorCode::Io, "cannot stat " + path + ": " + std::strerror(error)) };
+    }
+
+    const auto size = size_t(status.st_size);
+
+    // an empty file cannot be mapped, and has nothing to map
+
+    if (size == 0) {
+
+        ::close(fd);
+
+        return BasicPathParser<T>::parsePathFromSource(std::string_view());
+    }
+
+    auto* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    const auto mapError = errno;
+
+    // the mapping holds its own reference to the file
+
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+
+        return { std::nullopt, Error(ErrorType::Unknown, ErrorCode::Io, "cannot map " + path + ": " + std::strerror(mapError)) };
+    }
+
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+
+    auto result = BasicPathParser<T>::parsePathFromSource(std::string_view(static_cast<const char*>(mapping), size));
+
+    ::munmap(mapping, size);
+
+    return result;
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>, std::optional<PathParseStats>> BasicPathParser<T>::parsePathWithStats(
+    std::string_view source,
+    [[maybe_unused]] bool recordEvents)
+{
+#if defined(SARLACC_PARSE_STATS)
+    PathParseStats stats;
+
+    stats.recordEvents = recordEvents;
+
+    PathParseStatsScope scope(stats);
+
+    auto result = BasicPathParser<T>::parsePathFromSource(source);
+
+    return { std::move(std::get<0>(result)), std::move(std::get<1>(result)), std::move(stats) };
+#else
+    auto result = BasicPathParser<T>::parsePathFromSource(source);
+
+    return { std::move(std::get<0>(result)), std::move(std::get<1>(result)), std::nullopt };
+#endif
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>, std::optional<AllocationStats>> BasicPathParser<T>::parsePathWithAllocations(
+    std::string_view source,
+    std::optional<AllocationLimits> limits)
+{
+    if (!AllocationScope::enabled()) {
+
+        auto result = BasicPathParser<T>::parsePathFromSource(source);
+
+        return { std::move(std::get<0>(result)), std::move(std::get<1>(result)), std::nullopt };
+    }
+
+    ///
+
+    AllocationStats stats;
+
+    std::optional<std::vector<std::vector<BasicPathCommand<T>>>> paths;
+
+    std::optional<Error> error;
+
+    auto exceeded = false;
+
+    {
+        AllocationScope scope(stats, limits);
+
+        try {
+            auto result = BasicPathParser<T>::parsePathFromSource(source);
+
+            paths = std::move(std::get<0>(result));
+
+            if (std::get<1>(result).has_value()) {
+
+                error.emplace(std::move(std::get<1>(result).value()));
+            }
+        } catch (const AllocationBudgetExceeded&) {
+
+            exceeded = true;
+        }
+    }
+
+    // built outside the scope, which would refuse its allocations
+
+    if (exceeded) {
+
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::LimitExceeded, "parse exceeded its allocation budget"), stats };
+    }
+
+    return { std::move(paths), std::move(error), stats };
+}
+
+template <typename T>
+const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>> BasicPathParser<T>::parseNumberToken(
+    const PathNumberToken& token)
+{
+    const auto value = PathScalar<T>::fromChars(token.value());
+
+    if (!value.has_value()) {
+
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::NumberOutOfRange, "number out of range when parsing number", token.location()) };
+    }
+
+    ///
+
+    return {
+        BasicPathNumber<T> { value.value(), token.value() },
+        std::nullopt
+    };
+}
+
+template <typename T>
+const std::tuple<std::optional<BasicPathPoint<T>>, std::optional<Error>> BasicPathParser<T>::parsePoint(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
@@ -276,7 +660,7 @@ const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::par
 
     if (!peekXOrNull.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected token when parsing point") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected token when parsing point", parser.location()) };
     }
 
     ///
@@ -285,10 +669,10 @@ const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::par
 
     if (peekX.type() != PathTokenType::Number) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected number when parsing point") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected number when parsing point", parser.location()) };
     }
 
-    const auto& x = static_cast<const PathNumberToken&>(peekX);
+    const auto x = BasicPathParser<T>::parseNumberToken(static_cast<const PathNumberToken&>(peekX));
 
     parser.increment();
 
@@ -298,7 +682,7 @@ const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::par
 
     if (!peekNextOrNull.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected token when parsing point") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected token when parsing point", parser.location()) };
     }
 
     ///
@@ -307,23 +691,18 @@ const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::par
 
     if (peekNext.type() == PathTokenType::Number) {
 
-        const auto& y = static_cast<const PathNumberToken&>(peekNext);
+        const auto y = BasicPathParser<T>::parseNumberToken(static_cast<const PathNumberToken&>(peekNext));
 
         parser.increment();
 
-        return {
-            PathPoint {
-                PathNumber { std::stof(x.value()), x.value() },
-                PathNumber { std::stof(y.value()), y.value() } },
-            std::nullopt
-        };
+        return BasicPathParser<T>::makePoint(x, y);
     }
 
     ///
 
     if (peekNext.type() != PathTokenType::Punc) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected number or comma delimiter when parsing point") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected number or comma delimiter when parsing point", parser.location()) };
     }
 
     parser.increment();
@@ -334,7 +713,7 @@ const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::par
 
     if (!peekYOrNull.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected token when parsing point") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected token when parsing point", parser.location()) };
     }
 
     ///
@@ -343,34 +722,63 @@ const std::tuple<std::optional<PathPoint>, std::optional<Error>> PathParser::par
 
     if (peekY.type() != PathTokenType::Number) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected number when parsing point") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected number when parsing point", parser.location()) };
     }
 
     ///
 
-    const auto& y = static_cast<const PathNumberToken&>(peekY);
+    const auto y = BasicPathParser<T>::parseNumberToken(static_cast<const PathNumberToken&>(peekY));
 
     parser.increment();
 
+    return BasicPathParser<T>::makePoint(x, y);
+}
+
+template <typename T>
+const std::tuple<std::optional<BasicPathPoint<T>>, std::optional<Error>> BasicPathParser<T>::makePoint(
+    const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>>& xTuple,
+    const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>>& yTuple)
+{
+    const auto& xNumber = std::get<std::optional<BasicPathNumber<T>>>(xTuple);
+
+    const auto& xError = std::get<std::optional<Error>>(xTuple);
+
+    if (xError.has_value()) {
+
+        return { std::nullopt, xError };
+    }
+
+    ///
+
+    const auto& yNumber = std::get<std::optional<BasicPathNumber<T>>>(yTuple);
+
+    const auto& yError = std::get<std::optional<Error>>(yTuple);
+
+    if (yError.has_value()) {
+
+        return { std::nullopt, yError };
+    }
+
+    ///
+
     return {
-        PathPoint {
-            PathNumber { std::stof(x.value()), x.value() },
-            PathNumber { std::stof(y.value()), y.value() } },
+        BasicPathPoint<T> { xNumber.value(), yNumber.value() },
         std::nullopt
     };
 }
 
-const std::tuple<std::optional<std::vector<PathPoint>>, std::optional<Error>> PathParser::parsePoints(
+template <typename T>
+const std::tuple<std::optional<std::vector<BasicPathPoint<T>>>, std::optional<Error>> BasicPathParser<T>::parsePoints(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
 
-    std::vector<PathPoint> points;
+    std::vector<BasicPathPoint<T>> points;
 
     ///
 
@@ -396,9 +804,9 @@ const std::tuple<std::optional<std::vector<PathPoint>>, std::optional<Error>> Pa
 
         ///
 
-        const auto pointTuple = PathParser::parsePoint(parser);
+        const auto pointTuple = BasicPathParser<T>::parsePoint(parser);
 
-        const auto& point = std::get<std::optional<PathPoint>>(pointTuple);
+        const auto& point = std::get<std::optional<BasicPathPoint<T>>>(pointTuple);
 
         const auto& pointError = std::get<std::optional<Error>>(pointTuple);
 
@@ -420,12 +828,13 @@ const std::tuple<std::optional<std::vector<PathPoint>>, std::optional<Error>> Pa
     return { std::move(points), std::nullopt };
 }
 
-const std::tuple<std::optional<PathNumber>, std::optional<Error>> PathParser::parseNumber(
+template <typename T>
+const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>> BasicPathParser<T>::parseNumber(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
@@ -434,7 +843,7 @@ const std::tuple<std::optional<PathNumber>, std::optional<Error>> PathParser::pa
 
     if (!peekOrNull.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected token when parsing number") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected token when parsing number", parser.location()) };
     }
 
     ///
@@ -443,34 +852,34 @@ const std::tuple<std::optional<PathNumber>, std::optional<Error>> PathParser::pa
 
     if (peek.type() != PathTokenType::Number) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected number when parsing number") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected number when parsing number", parser.location()) };
     }
 
     ///
 
-    const auto& number = static_cast<const PathNumberToken&>(peek);
+    // converted first: a streaming parser frees the token on increment
+
+    auto number = BasicPathParser<T>::parseNumberToken(static_cast<const PathNumberToken&>(peek));
 
     parser.increment();
 
     ///
 
-    return {
-        PathNumber { std::stof(number.value()), number.value() },
-        std::nullopt
-    };
+    return number;
 }
 
-const std::tuple<std::optional<std::vector<PathNumber>>, std::optional<Error>> PathParser::parseNumbers(
+template <typename T>
+const std::tuple<std::optional<std::vector<BasicPathNumber<T>>>, std::optional<Error>> BasicPathParser<T>::parseNumbers(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
 
-    std::vector<PathNumber> numbers;
+    std::vector<BasicPathNumber<T>> numbers;
 
     ///
 
@@ -498,16 +907,25 @@ const std::tuple<std::optional<std::vector<PathNumber>>, std::optional<Error>> P
 
         if (peek.type() != PathTokenType::Number) {
 
-            return { std::nullopt, Error(ErrorType::Parser, "expected number when parsing numbers") };
+            return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected number when parsing numbers", parser.location()) };
         }
 
         ///
 
-        const auto& number = static_cast<const PathNumberToken&>(peek);
+        const auto valueTuple = BasicPathParser<T>::parseNumberToken(static_cast<const PathNumberToken&>(peek));
 
         parser.increment();
 
-        numbers.push_back(PathNumber { std::stof(number.value()), number.value() });
+        const auto& value = std::get<std::optional<BasicPathNumber<T>>>(valueTuple);
+
+        const auto& valueError = std::get<std::optional<Error>>(valueTuple);
+
+        if (valueError.has_value()) {
+
+            return { std::nullopt, valueError };
+        }
+
+        numbers.push_back(value.value());
     }
 
     ///
@@ -515,14 +933,17 @@ const std::tuple<std::optional<std::vector<PathNumber>>, std::optional<Error>> P
     return { std::move(numbers), std::nullopt };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandMoveTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandMoveTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::MoveTo);
+
     if (command.value() != 'M'
         && command.value() != 'm') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected move to command when parsing move to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected move to command when parsing move to command", parser.location()) };
     }
 
     const auto position = command.value() == 'M'
@@ -533,9 +954,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto pointsTuple = PathParser::parsePoints(parser);
+    const auto pointsTuple = BasicPathParser<T>::parsePoints(parser);
 
-    const auto& points = std::get<std::optional<std::vector<PathPoint>>>(pointsTuple);
+    const auto& points = std::get<std::optional<std::vector<BasicPathPoint<T>>>>(pointsTuple);
 
     const auto& pointsError = std::get<std::optional<Error>>(pointsTuple);
 
@@ -546,13 +967,13 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!points.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points when parsing move to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected points when parsing move to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::MoveTo,
             position,
             points.value(),
@@ -562,14 +983,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandLineTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandLineTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::LineTo);
+
     if (command.value() != 'L'
         && command.value() != 'l') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected line to command when parsing line to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected line to command when parsing line to command", parser.location()) };
     }
 
     const auto position = command.value() == 'L'
@@ -580,9 +1004,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto pointsTuple = PathParser::parsePoints(parser);
+    const auto pointsTuple = BasicPathParser<T>::parsePoints(parser);
 
-    const auto& points = std::get<std::optional<std::vector<PathPoint>>>(pointsTuple);
+    const auto& points = std::get<std::optional<std::vector<BasicPathPoint<T>>>>(pointsTuple);
 
     const auto& pointsError = std::get<std::optional<Error>>(pointsTuple);
 
@@ -593,13 +1017,13 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!points.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points when parsing line to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected points when parsing line to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::LineTo,
             position,
             points.value(),
@@ -609,14 +1033,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandHLineTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandHLineTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::HorizontalLineTo);
+
     if (command.value() != 'H'
         && command.value() != 'h') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected horizontal line to command when parsing horizontal line to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected horizontal line to command when parsing horizontal line to command", parser.location()) };
     }
 
     const auto position = command.value() == 'H'
@@ -627,9 +1054,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto numbersTuple = PathParser::parseNumbers(parser);
+    const auto numbersTuple = BasicPathParser<T>::parseNumbers(parser);
 
-    const auto& numbers = std::get<std::optional<std::vector<PathNumber>>>(numbersTuple);
+    const auto& numbers = std::get<std::optional<std::vector<BasicPathNumber<T>>>>(numbersTuple);
 
     const auto& numbersError = std::get<std::optional<Error>>(numbersTuple);
 
@@ -640,13 +1067,13 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!numbers.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected numbers when parsing horizontal line to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected numbers when parsing horizontal line to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::HorizontalLineTo,
             position,
             std::nullopt,
@@ -656,14 +1083,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandVLineTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandVLineTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::VerticalLineTo);
+
     if (command.value() != 'V'
         && command.value() != 'v') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected vertical line to command when parsing vertical line to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected vertical line to command when parsing vertical line to command", parser.location()) };
     }
 
     const auto position = command.value() == 'V'
@@ -674,9 +1104,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto numbersTuple = PathParser::parseNumbers(parser);
+    const auto numbersTuple = BasicPathParser<T>::parseNumbers(parser);
 
-    const auto& numbers = std::get<std::optional<std::vector<PathNumber>>>(numbersTuple);
+    const auto& numbers = std::get<std::optional<std::vector<BasicPathNumber<T>>>>(numbersTuple);
 
     const auto& numbersError = std::get<std::optional<Error>>(numbersTuple);
 
@@ -687,13 +1117,13 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!numbers.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected numbers when parsing vertical line to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected numbers when parsing vertical line to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::VerticalLineTo,
             position,
             std::nullopt,
@@ -703,14 +1133,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandCurveTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandCurveTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::CurveTo);
+
     if (command.value() != 'C'
         && command.value() != 'c') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected curve to command when parsing curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected curve to command when parsing curve to command", parser.location()) };
     }
 
     const auto position = command.value() == 'C'
@@ -721,9 +1154,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto pointsTuple = PathParser::parsePoints(parser);
+    const auto pointsTuple = BasicPathParser<T>::parsePoints(parser);
 
-    const auto& points = std::get<std::optional<std::vector<PathPoint>>>(pointsTuple);
+    const auto& points = std::get<std::optional<std::vector<BasicPathPoint<T>>>>(pointsTuple);
 
     const auto& pointsError = std::get<std::optional<Error>>(pointsTuple);
 
@@ -734,20 +1167,20 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!points.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points when parsing curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected points when parsing curve to command", parser.location()) };
     }
 
     ///
 
     if (points.value().size() % 3 != 0) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points in multiples of 3 when parsing curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::InvalidArgumentCount, "expected points in multiples of 3 when parsing curve to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::CurveTo,
             position,
             points.value(),
@@ -757,14 +1190,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandSmoothCurveTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandSmoothCurveTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::SmoothCurveTo);
+
     if (command.value() != 'S'
         && command.value() != 's') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected smooth curve to command when parsing smooth curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected smooth curve to command when parsing smooth curve to command", parser.location()) };
     }
 
     const auto position = command.value() == 'S'
@@ -775,9 +1211,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto pointsTuple = PathParser::parsePoints(parser);
+    const auto pointsTuple = BasicPathParser<T>::parsePoints(parser);
 
-    const auto& points = std::get<std::optional<std::vector<PathPoint>>>(pointsTuple);
+    const auto& points = std::get<std::optional<std::vector<BasicPathPoint<T>>>>(pointsTuple);
 
     const auto& pointsError = std::get<std::optional<Error>>(pointsTuple);
 
@@ -788,20 +1224,20 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!points.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points when parsing smooth curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected points when parsing smooth curve to command", parser.location()) };
     }
 
     ///
 
     if (points.value().size() % 2 != 0) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points in multiples of 2 when parsing smooth curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::InvalidArgumentCount, "expected points in multiples of 2 when parsing smooth curve to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::SmoothCurveTo,
             position,
             points.value(),
@@ -811,14 +1247,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandQuadraticBezierCurveTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandQuadraticBezierCurveTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::QuadraticBezierCurveTo);
+
     if (command.value() != 'Q'
         && command.value() != 'q') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected quadratic bezier curve to command when parsing quadratic bezier curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected quadratic bezier curve to command when parsing quadratic bezier curve to command", parser.location()) };
     }
 
     const auto position = command.value() == 'Q'
@@ -829,9 +1268,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto pointsTuple = PathParser::parsePoints(parser);
+    const auto pointsTuple = BasicPathParser<T>::parsePoints(parser);
 
-    const auto& points = std::get<std::optional<std::vector<PathPoint>>>(pointsTuple);
+    const auto& points = std::get<std::optional<std::vector<BasicPathPoint<T>>>>(pointsTuple);
 
     const auto& pointsError = std::get<std::optional<Error>>(pointsTuple);
 
@@ -842,20 +1281,20 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!points.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points when parsing quadratic bezier curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected points when parsing quadratic bezier curve to command", parser.location()) };
     }
 
     ///
 
     if (points.value().size() % 2 != 0) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points in multiples of 2 when parsing quadratic bezier curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::InvalidArgumentCount, "expected points in multiples of 2 when parsing quadratic bezier curve to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::QuadraticBezierCurveTo,
             position,
             points.value(),
@@ -865,14 +1304,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandSmoothQuadraticBezierCurveTo(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandSmoothQuadraticBezierCurveTo(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::SmoothQuadraticBezierCurveTo);
+
     if (command.value() != 'T'
         && command.value() != 't') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected smooth quadratic bezier curve to command when parsing smooth quadratic bezier curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected smooth quadratic bezier curve to command when parsing smooth quadratic bezier curve to command", parser.location()) };
     }
 
     const auto position = command.value() == 'T'
@@ -883,9 +1325,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    const auto pointsTuple = PathParser::parsePoints(parser);
+    const auto pointsTuple = BasicPathParser<T>::parsePoints(parser);
 
-    const auto& points = std::get<std::optional<std::vector<PathPoint>>>(pointsTuple);
+    const auto& points = std::get<std::optional<std::vector<BasicPathPoint<T>>>>(pointsTuple);
 
     const auto& pointsError = std::get<std::optional<Error>>(pointsTuple);
 
@@ -896,20 +1338,20 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!points.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points when parsing smooth quadratic bezier curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected points when parsing smooth quadratic bezier curve to command", parser.location()) };
     }
 
     ///
 
     if (points.value().size() % 2 != 0) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected points in multiples of 2 when parsing smooth quadratic bezier curve to command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::InvalidArgumentCount, "expected points in multiples of 2 when parsing smooth quadratic bezier curve to command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::SmoothQuadraticBezierCurveTo,
             position,
             points.value(),
@@ -919,19 +1361,20 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, PathPoint>>, std::optional<Error>> PathParser::parseEllipticalArc(
+template <typename T>
+const std::tuple<std::optional<BasicPathArc<T>>, std::optional<Error>> BasicPathParser<T>::parseEllipticalArc(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
 
-    const auto radTuple = PathParser::parsePoint(parser);
+    const auto radTuple = BasicPathParser<T>::parsePoint(parser);
 
-    const auto& rad = std::get<std::optional<PathPoint>>(radTuple);
+    const auto& rad = std::get<std::optional<BasicPathPoint<T>>>(radTuple);
 
     const auto& radError = std::get<std::optional<Error>>(radTuple);
 
@@ -942,14 +1385,14 @@ const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, Path
 
     if (!rad.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected radius/point when parsing elliptical arc") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected radius/point when parsing elliptical arc", parser.location()) };
     }
 
     ///
 
-    const auto xRotationTuple = PathParser::parseNumber(parser);
+    const auto xRotationTuple = BasicPathParser<T>::parseNumber(parser);
 
-    const auto& xRotation = std::get<std::optional<PathNumber>>(xRotationTuple);
+    const auto& xRotation = std::get<std::optional<BasicPathNumber<T>>>(xRotationTuple);
 
     const auto& xRotationError = std::get<std::optional<Error>>(xRotationTuple);
 
@@ -960,14 +1403,14 @@ const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, Path
 
     if (!xRotation.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected x-axis-rotation when parsing elliptical arc") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected x-axis-rotation when parsing elliptical arc", parser.location()) };
     }
 
     ///
 
-    const auto flagsTuple = PathParser::parsePoint(parser);
+    const auto flagsTuple = BasicPathParser<T>::parsePoint(parser);
 
-    const auto& flags = std::get<std::optional<PathPoint>>(flagsTuple);
+    const auto& flags = std::get<std::optional<BasicPathPoint<T>>>(flagsTuple);
 
     const auto& flagsError = std::get<std::optional<Error>>(flagsTuple);
 
@@ -978,14 +1421,14 @@ const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, Path
 
     if (!flags.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected flags when parsing elliptical arc") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected flags when parsing elliptical arc", parser.location()) };
     }
 
     ///
 
-    const auto endTuple = PathParser::parsePoint(parser);
+    const auto endTuple = BasicPathParser<T>::parsePoint(parser);
 
-    const auto& end = std::get<std::optional<PathPoint>>(endTuple);
+    const auto& end = std::get<std::optional<BasicPathPoint<T>>>(endTuple);
 
     const auto& endError = std::get<std::optional<Error>>(endTuple);
 
@@ -996,7 +1439,7 @@ const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, Path
 
     if (!end.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected end point when parsing elliptical arc") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected end point when parsing elliptical arc", parser.location()) };
     }
 
     ///
@@ -1007,14 +1450,17 @@ const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, Path
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandEllipticalArc(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandEllipticalArc(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::EllipticalArc);
+
     if (command.value() != 'A'
         && command.value() != 'a') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected elliptical arc command when parsing elliptical arc command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected elliptical arc command when parsing elliptical arc command", parser.location()) };
     }
 
     const auto position = command.value() == 'A'
@@ -1025,7 +1471,7 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     ///
 
-    std::vector<std::tuple<PathPoint, PathNumber, PathPoint, PathPoint>> arcs;
+    std::vector<BasicPathArc<T>> arcs;
 
     ///
 
@@ -1052,9 +1498,9 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
         ///
 
-        const auto arcTuple = PathParser::parseEllipticalArc(parser);
+        const auto arcTuple = BasicPathParser<T>::parseEllipticalArc(parser);
 
-        const auto& arc = std::get<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, PathPoint>>>(arcTuple);
+        const auto& arc = std::get<std::optional<BasicPathArc<T>>>(arcTuple);
 
         const auto& arcError = std::get<std::optional<Error>>(arcTuple);
 
@@ -1075,13 +1521,13 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (arcs.empty()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected arcs when parsing elliptical arc command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected arcs when parsing elliptical arc command", parser.location()) };
     }
 
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::EllipticalArc,
             position,
             std::nullopt,
@@ -1091,14 +1537,17 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommandClosePath(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommandClosePath(
     const PathCommandToken& command,
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_COMMAND(PathCommandType::ClosePath);
+
     if (command.value() != 'Z'
         && command.value() != 'z') {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected close path command when parsing close path command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected close path command when parsing close path command", parser.location()) };
     }
 
     const auto position = command.value() == 'A'
@@ -1110,7 +1559,7 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     ///
 
     return {
-        PathCommand {
+        BasicPathCommand<T> {
             PathCommandType::ClosePath,
             position,
             std::nullopt,
@@ -1120,12 +1569,13 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     };
 }
 
-const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::parseCommand(
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> BasicPathParser<T>::parseCommand(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
@@ -1134,7 +1584,7 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (!peekOrNull.has_value()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected token when parsing command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected token when parsing command", parser.location()) };
     }
 
     ///
@@ -1148,7 +1598,7 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
 
     if (peek.type() != PathTokenType::Command) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "expected command when parsing command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedToken, "expected command when parsing command", parser.location()) };
     }
 
     ///
@@ -1158,79 +1608,80 @@ const std::tuple<std::optional<PathCommand>, std::optional<Error>> PathParser::p
     switch (command.value()) {
     case 'M':
     case 'm': {
-        return PathParser::parseCommandMoveTo(command, parser);
+        return BasicPathParser<T>::parseCommandMoveTo(command, parser);
     }
 
     case 'L':
     case 'l': {
-        return PathParser::parseCommandLineTo(command, parser);
+        return BasicPathParser<T>::parseCommandLineTo(command, parser);
     }
 
     case 'H':
     case 'h': {
-        return PathParser::parseCommandHLineTo(command, parser);
+        return BasicPathParser<T>::parseCommandHLineTo(command, parser);
     }
 
     case 'V':
     case 'v': {
-        return PathParser::parseCommandVLineTo(command, parser);
+        return BasicPathParser<T>::parseCommandVLineTo(command, parser);
     }
 
     case 'C':
     case 'c': {
-        return PathParser::parseCommandCurveTo(command, parser);
+        return BasicPathParser<T>::parseCommandCurveTo(command, parser);
     }
 
     case 'S':
     case 's': {
-        return PathParser::parseCommandSmoothCurveTo(command, parser);
+        return BasicPathParser<T>::parseCommandSmoothCurveTo(command, parser);
     }
 
     case 'Q':
     case 'q': {
-        return PathParser::parseCommandQuadraticBezierCurveTo(command, parser);
+        return BasicPathParser<T>::parseCommandQuadraticBezierCurveTo(command, parser);
     }
 
     case 'T':
     case 't': {
-        return PathParser::parseCommandSmoothQuadraticBezierCurveTo(command, parser);
+        return BasicPathParser<T>::parseCommandSmoothQuadraticBezierCurveTo(command, parser);
     }
 
     case 'A':
     case 'a': {
-        return PathParser::parseCommandEllipticalArc(command, parser);
+        return BasicPathParser<T>::parseCommandEllipticalArc(command, parser);
     }
 
     case 'Z':
     case 'z': {
-        return PathParser::parseCommandClosePath(command, parser);
+        return BasicPathParser<T>::parseCommandClosePath(command, parser);
     }
 
     default: {
-        return { std::nullopt, Error(ErrorType::Parser, "unknown command token when parsing command") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnknownCommand, "unknown command token when parsing command", parser.location()) };
     }
     }
 }
 
-const std::tuple<std::optional<std::vector<PathCommand>>, std::optional<Error>> PathParser::parseSubPath(
+template <typename T>
+const std::tuple<std::optional<std::vector<BasicPathCommand<T>>>, std::optional<Error>> BasicPathParser<T>::parseSubPath(
     Parser<PathToken>& parser)
 {
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
 
-    std::vector<PathCommand> commands;
+    std::vector<BasicPathCommand<T>> commands;
 
     ///
 
     while (!parser.isEof()) {
 
-        const auto commandTuple = PathParser::parseCommand(parser);
+        const auto commandTuple = BasicPathParser<T>::parseCommand(parser);
 
-        const auto& commandOrNull = std::get<std::optional<PathCommand>>(commandTuple);
+        const auto& commandOrNull = std::get<std::optional<BasicPathCommand<T>>>(commandTuple);
 
         const auto& commandError = std::get<std::optional<Error>>(commandTuple);
 
@@ -1268,25 +1719,28 @@ const std::tuple<std::optional<std::vector<PathCommand>>, std::optional<Error>>
     return { std::move(commands), std::nullopt };
 }
 
-const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::optional<Error>> PathParser::parseSubPaths(
+template <typename T>
+const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> BasicPathParser<T>::parseSubPaths(
     Parser<PathToken>& parser)
 {
+    SARLACC_STATS_PHASE("parse", parseNanoseconds);
+
     if (parser.isEof()) {
 
-        return { std::nullopt, Error(ErrorType::Parser, "unexpected eof") };
+        return { std::nullopt, Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "unexpected eof", parser.location()) };
     }
 
     ///
 
-    std::vector<std::vector<PathCommand>> subPaths;
+    std::vector<std::vector<BasicPathCommand<T>>> subPaths;
 
     ///
 
     while (!parser.isEof()) {
 
-        const auto subPathTuple = PathParser::parseSubPath(parser);
+        const auto subPathTuple = BasicPathParser<T>::parseSubPath(parser);
 
-        const auto& subPath = std::get<std::optional<std::vector<PathCommand>>>(subPathTuple);
+        const auto& subPath = std::get<std::optional<std::vector<BasicPathCommand<T>>>>(subPathTuple);
 
         const auto& subPathError = std::get<std::optional<Error>>(subPathTuple);
 
@@ -1307,3 +1761,13 @@ const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::opti
 
     return { std::move(subPaths), std::nullopt };
 }
+
+///
+
+template class BasicPathParser<float>;
+
+template class BasicPathParser<double>;
+
+template class BasicPathParser<Fixed16_16>;
+
+template class BasicPathParser<Fixed24_8>;
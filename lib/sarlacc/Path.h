@@ -4,10 +4,15 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 
+#include "AllocationTracking.h"
 #include "Error.h"
 #include "Parsing.h"
+#include "PathParseStats.h"
+#include "PathScalar.h"
 #include "SourceLocation.h"
 
 // path tokens
@@ -49,6 +54,10 @@ public:
 
     PathToken& operator=(PathToken&&) = delete;
 
+    // tokens are owned and freed as PathTokens
+
+    virtual ~PathToken() = default;
+
     ///
 
     const PathTokenType& type() const { return m_type; }
@@ -245,7 +254,22 @@ private:
 class PathLexer final {
 public:
     static const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>> lexFromSource(
-        const std::string& source);
+        std::string_view source);
+
+    static const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>> lexFromSource(
+        std::span<const std::byte> source);
+
+    // The same tokens from a DFA generated out of a declarative rule list, for
+    // comparison with the hand-written lexer.
+
+    static const std::tuple<std::vector<std::unique_ptr<PathToken>>, std::optional<Error>> lexFromSourceWithTable(
+        std::string_view source);
+
+    // Tokens one at a time, ending with the Eof token, for a streaming
+    // Parser<PathToken>. The source must outlive the stream.
+
+    static const Parser<PathToken>::TokenSource tokenStream(
+        std::string_view source);
 
 private:
     static const bool isDigit(
@@ -265,16 +289,23 @@ private:
 
 // path types
 
-struct PathNumber {
-    float value;
+template <typename T>
+struct BasicPathNumber {
+    T value;
     std::string source;
 };
 
-struct PathPoint {
-    PathNumber x;
-    PathNumber y;
+template <typename T>
+struct BasicPathPoint {
+    BasicPathNumber<T> x;
+    BasicPathNumber<T> y;
 };
 
+// radii, x-axis-rotation, flags, end point
+
+template <typename T>
+using BasicPathArc = std::tuple<BasicPathPoint<T>, BasicPathNumber<T>, BasicPathPoint<T>, BasicPathPoint<T>>;
+
 enum class PathCommandPosition {
     Absolute,
     Relative,
@@ -293,86 +324,178 @@ enum class PathCommandType {
     EllipticalArc,
 };
 
-struct PathCommand {
+template <typename T>
+struct BasicPathCommand {
     PathCommandType type;
     PathCommandPosition position;
-    std::optional<std::vector<PathPoint>> points;
-    std::optional<std::vector<PathNumber>> numbers;
-    std::optional<std::vector<std::tuple<PathPoint, PathNumber, PathPoint, PathPoint>>> arcs;
+    std::optional<std::vector<BasicPathPoint<T>>> points;
+    std::optional<std::vector<BasicPathNumber<T>>> numbers;
+    std::optional<std::vector<BasicPathArc<T>>> arcs;
 };
 
+using PathNumber = BasicPathNumber<float>;
+
+using PathPoint = BasicPathPoint<float>;
+
+using PathArc = BasicPathArc<float>;
+
+using PathCommand = BasicPathCommand<float>;
+
 ///
 
 // path parsing
 
-class PathParser final {
+// Coordinates are converted once, straight from the source digits, into `T`:
+// `float`, `double`, `Fixed16_16` or `Fixed24_8`.
+
+template <typename T>
+class BasicPathParser final {
 
 public:
-    static const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::optional<Error>> parsePathFromSource(
-        const std::string& source);
+    // The source is only viewed, never copied: a slice of a larger buffer or a
+    // file mapping parses in place.
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> parsePathFromSource(
+        std::string_view source);
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> parsePathFromSource(
+        std::span<const std::byte> source);
+
+    // Maps the file read-only, advised for sequential access, and parses the
+    // mapping directly.
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> parsePathFromFile(
+        const std::string& path);
+
+    // Parses tokens from PathLexer::lexFromSource over the same source, so the
+    // two phases can be run and timed apart.
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> parsePathFromTokens(
+        std::string_view source,
+        const std::vector<std::unique_ptr<PathToken>>& tokens);
+
+    // Lexes as the parser goes, holding `lookahead` tokens rather than the
+    // whole token list; the path grammar needs one.
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> parsePathStreaming(
+        std::string_view source,
+        size_t lookahead = 1);
+
+    // Parses past errors: on each failure the error is kept and parsing
+    // resumes at the next command token, until `maxErrors` are collected.
+    // Returns the commands that parsed, grouped into sub paths as usual, and
+    // the errors in source order.
+
+    static const std::tuple<std::vector<std::vector<BasicPathCommand<T>>>, std::vector<Error>> parsePathRecovering(
+        std::string_view source,
+        size_t maxErrors = 16);
+
+    // Parses with the lexer and parser instrumented, returning bytes, token and
+    // command counts and time per phase alongside the result, and with
+    // `recordEvents` a trace event per phase and command. Stats are only there
+    // in builds configured with SARLACC_PARSE_STATS; without it the hooks are
+    // compiled out and this is parsePathFromSource.
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>, std::optional<PathParseStats>> parsePathWithStats(
+        std::string_view source,
+        bool recordEvents = false);
+
+    // Parses with every allocation on this thread counted, the result's own
+    // included, so callers can hold a parse to a budget. With `limits` the
+    // first allocation over budget stops the parse with a LimitExceeded error,
+    // or aborts if the limits ask for that, as AllocationScope describes.
+    // Stats, and so budgets, are only there in builds configured with
+    // SARLACC_ALLOCATION_TRACKING.
+
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>, std::optional<AllocationStats>> parsePathWithAllocations(
+        std::string_view source,
+        std::optional<AllocationLimits> limits = std::nullopt);
 
 private:
-    static const std::tuple<std::optional<PathPoint>, std::optional<Error>> parsePoint(
+    static const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>> parseNumberToken(
+        const PathNumberToken& token);
+
+    // Numbers are converted before the parser moves past their tokens, which
+    // a streaming parser frees; a point reports the first conversion error.
+
+    static const std::tuple<std::optional<BasicPathPoint<T>>, std::optional<Error>> makePoint(
+        const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>>& xTuple,
+        const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>>& yTuple);
+
+    static const std::tuple<std::optional<BasicPathPoint<T>>, std::optional<Error>> parsePoint(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<std::vector<PathPoint>>, std::optional<Error>> parsePoints(
+    static const std::tuple<std::optional<std::vector<BasicPathPoint<T>>>, std::optional<Error>> parsePoints(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathNumber>, std::optional<Error>> parseNumber(
+    static const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>> parseNumber(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<std::vector<PathNumber>>, std::optional<Error>> parseNumbers(
+    static const std::tuple<std::optional<std::vector<BasicPathNumber<T>>>, std::optional<Error>> parseNumbers(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandMoveTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandMoveTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandLineTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandLineTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandHLineTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandHLineTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandVLineTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandVLineTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandCurveTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandCurveTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandSmoothCurveTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandSmoothCurveTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandQuadraticBezierCurveTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandQuadraticBezierCurveTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandSmoothQuadraticBezierCurveTo(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandSmoothQuadraticBezierCurveTo(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<std::tuple<PathPoint, PathNumber, PathPoint, PathPoint>>, std::optional<Error>> parseEllipticalArc(
+    static const std::tuple<std::optional<BasicPathArc<T>>, std::optional<Error>> parseEllipticalArc(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandEllipticalArc(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandEllipticalArc(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommandClosePath(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommandClosePath(
         const PathCommandToken& command,
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<PathCommand>, std::optional<Error>> parseCommand(
+    static const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> parseCommand(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<std::vector<PathCommand>>, std::optional<Error>> parseSubPath(
+    static const std::tuple<std::optional<std::vector<BasicPathCommand<T>>>, std::optional<Error>> parseSubPath(
         Parser<PathToken>& parser);
 
-    static const std::tuple<std::optional<std::vector<std::vector<PathCommand>>>, std::optional<Error>> parseSubPaths(
+    static const std::tuple<std::optional<std::vector<std::vector<BasicPathCommand<T>>>>, std::optional<Error>> parseSubPaths(
         Parser<PathToken>& parser);
-};
\ No newline at end of file
+
+    static void skipToCommand(
+        Parser<PathToken>& parser);
+};
+
+using PathParser = BasicPathParser<float>;
+
+extern template class BasicPathParser<float>;
+
+extern template class BasicPathParser<double>;
+
+extern template class BasicPathParser<Fixed16_16>;
+
+extern template class BasicPathParser<Fixed24_8>;
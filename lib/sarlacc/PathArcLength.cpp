@@ -0,0 +1,561 @@
+#include "PathArcLength.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "Simd.h"
+
+// arc length
+
+namespace {
+
+// 5-point Gauss-Legendre on [-1, 1]
+
+constexpr double gaussNodes[] = {
+    0.0,
+    -0.5384693101056831,
+    0.5384693101056831,
+    -0.9061798459386640,
+    0.9061798459386640,
+};
+
+constexpr double gaussWeights[] = {
+    0.5688888888888889,
+    0.4786286704993665,
+    0.4786286704993665,
+    0.2369268850561891,
+    0.2369268850561891,
+};
+
+constexpr int polynomialIntervals[] = { 0, 1, 4, 8 };
+
+struct SimdPolynomial {
+    SimdFloat4 coefficients[8];
+};
+
+SimdFloat4 simdSpeed(
+    const SimdPolynomial& p,
+    const SimdFloat4& t)
+{
+    const auto three = simdSplat(3);
+
+    const auto two = simdSplat(2);
+
+    const auto dx = (three * p.coefficients[0] * t + two * p.coefficients[1]) * t + p.coefficients[2];
+
+    const auto dy = (three * p.coefficients[4] * t + two * p.coefficients[5]) * t + p.coefficients[6];
+
+    return simdSqrt(dx * dx + dy * dy);
+}
+
+}
+
+const PathArcLengthTable PathArcLengthTable::build(
+    const PathBuffer& buffer)
+{
+    PathArcLengthTable table;
+
+    double currentX = 0, currentY = 0, startX = 0, startY = 0;
+
+    size_t coordinate = 0;
+
+    size_t arc = 0;
+
+    auto first = true;
+
+    ///
+
+    const auto addLine = [&](double toX, double toY) {
+        if (toX == currentX && toY == currentY) {
+
+            return;
+        }
+
+        const double points[] = { currentX, currentY, toX, toY };
+
+        table.addPolynomial(points, 1);
+    };
+
+    for (const auto verb : buffer.verbs) {
+
+        const auto* p = buffer.coordinates.data() + coordinate;
+
+        switch (verb) {
+        case PathVerb::MoveTo: {
+
+            startX = p[0];
+
+            startY = p[1];
+
+            if (first) {
+
+                table.m_originX = p[0];
+
+                table.m_originY = p[1];
+
+                first = false;
+            }
+
+            break;
+        }
+
+        case PathVerb::LineTo: {
+
+            addLine(p[0], p[1]);
+
+            break;
+        }
+
+        case PathVerb::QuadraticTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3] };
+
+            table.addPolynomial(points, 2);
+
+            break;
+        }
+
+        case PathVerb::CubicTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3], p[4], p[5] };
+
+            table.addPolynomial(points, 3);
+
+            break;
+        }
+
+        case PathVerb::ArcTo: {
+
+            const auto& parameters = buffer.arcs[arc++];
+
+            const auto ellipse = PathGeometry::centerArc(
+                currentX,
+                currentY,
+                parameters.radiusX,
+                parameters.radiusY,
+                parameters.rotation,
+                parameters.largeArc,
+                parameters.sweep,
+                p[0],
+                p[1]);
+
+            if (ellipse.has_value()) {
+
+                table.addArc(ellipse.value());
+            } else {
+
+                addLine(p[0], p[1]);
+            }
+
+            break;
+        }
+
+        case PathVerb::ClosePath: {
+
+            addLine(startX, startY);
+
+            currentX = startX;
+
+            currentY = startY;
+
+            break;
+        }
+        }
+
+        ///
+
+        const auto count = PathVerbs::pointCount(verb) * 2;
+
+        if (count > 0) {
+
+            currentX = p[count - 2];
+
+            currentY = p[count - 1];
+        }
+
+        coordinate += count;
+    }
+
+    ///
+
+    table.m_length = float(table.m_accumulated);
+
+    return table;
+}
+
+void PathArcLengthTable::addPolynomial(
+    const double* points,
+    int degree)
+{
+    double coefficients[8] = {};
+
+    for (auto axis = 0; axis < 2; ++axis) {
+
+        const auto p0 = points[axis];
+
+        const auto p1 = points[2 + axis];
+
+        auto* c = coefficients + axis * 4;
+
+        if (degree == 1) {
+
+            c[2] = p1 - p0;
+        } else if (degree == 2) {
+
+            const auto p2 = points[4 + axis];
+
+            c[1] = p0 - 2 * p1 + p2;
+
+            c[2] = 2 * (p1 - p0);
+        } else {
+
+            const auto p2 = points[4 + axis];
+
+            const auto p3 = points[6 + axis];
+
+            c[0] = -p0 + 3 * p1 - 3 * p2 + p3;
+
+            c[1] = 3 * p0 - 6 * p1 + 3 * p2;
+
+            c[2] = 3 * (p1 - p0);
+        }
+
+        c[3] = p0;
+    }
+
+    ///
+
+    Polynomial polynomial;
+
+    for (auto i = 0; i < 8; ++i) {
+
+        polynomial.coefficients[i] = float(coefficients[i]);
+    }
+
+    m_segments.push_back({ SegmentKind::Polynomial, uint32_t(m_polynomials.size()) });
+
+    m_polynomials.push_back(polynomial);
+
+    addIntervals(polynomialIntervals[degree]);
+}
+
+void PathArcLengthTable::addArc(
+    const PathEllipse& ellipse)
+{
+    m_segments.push_back({ SegmentKind::Arc, uint32_t(m_arcs.size()) });
+
+    m_arcs.push_back(ellipse);
+
+    // one interval per sixteenth of a turn
+
+    addIntervals(std::max(1, int(std::ceil(std::abs(ellipse.sweepAngle) / (std::numbers::pi / 8)))));
+}
+
+void PathArcLengthTable::addIntervals(
+    int intervalCount)
+{
+    const auto segmentIndex = uint32_t(m_segments.size() - 1);
+
+    const auto& segment = m_segments.back();
+
+    for (auto i = 0; i < intervalCount; ++i) {
+
+        const auto t0 = double(i) / intervalCount;
+
+        const auto t1 = double(i + 1) / intervalCount;
+
+        m_accumulated += lengthBetween(segment, t0, t1);
+
+        m_intervals.push_back({ segmentIndex, float(t0), float(t1) });
+
+        m_intervalEnds.push_back(float(m_accumulated));
+    }
+}
+
+const double PathArcLengthTable::speed(
+    const Segment& segment,
+    double t) const
+{
+    if (segment.kind == SegmentKind::Arc) {
+
+        const auto& ellipse = m_arcs[segment.index];
+
+        double x, y;
+
+        PathGeometry::tangentOnEllipse(ellipse, ellipse.startAngle + t * ellipse.sweepAngle, x, y);
+
+        return std::hypot(x, y) * std::abs(ellipse.sweepAngle);
+    }
+
+    ///
+
+    const auto* c = m_polynomials[segment.index].coefficients;
+
+    const auto dx = (3 * c[0] * t + 2 * c[1]) * t + c[2];
+
+    const auto dy = (3 * c[4] * t + 2 * c[5]) * t + c[6];
+
+    return std::hypot(dx, dy);
+}
+
+const double PathArcLengthTable::lengthBetween(
+    const Segment& segment,
+    double t0,
+    double t1) const
+{
+    const auto half = (t1 - t0) / 2;
+
+    const auto middle = (t1 + t0) / 2;
+
+    auto sum = 0.0;
+
+    for (auto i = 0; i < 5; ++i) {
+
+        sum += gaussWeights[i] * speed(segment, middle + half * gaussNodes[i]);
+    }
+
+    return sum * half;
+}
+
+const size_t PathArcLengthTable::findInterval(
+    float distance) const
+{
+    const auto found = std::upper_bound(m_intervalEnds.begin(), m_intervalEnds.end(), distance);
+
+    return std::min(size_t(found - m_intervalEnds.begin()), m_intervalEnds.size() - 1);
+}
+
+const PathSample PathArcLengthTable::evaluate(
+    const Segment& segment,
+    double t) const
+{
+    double x, y, tangentX, tangentY;
+
+    if (segment.kind == SegmentKind::Arc) {
+
+        const auto& ellipse = m_arcs[segment.index];
+
+        const auto angle = ellipse.startAngle + t * ellipse.sweepAngle;
+
+        PathGeometry::pointOnEllipse(ellipse, angle, x, y);
+
+        PathGeometry::tangentOnEllipse(ellipse, angle, tangentX, tangentY);
+
+        if (ellipse.sweepAngle < 0) {
+
+            tangentX = -tangentX;
+
+            tangentY = -tangentY;
+        }
+    } else {
+
+        const auto* c = m_polynomials[segment.index].coefficients;
+
+        x = ((c[0] * t + c[1]) * t + c[2]) * t + c[3];
+
+        y = ((c[4] * t + c[5]) * t + c[6]) * t + c[7];
+
+        tangentX = (3 * c[0] * t + 2 * c[1]) * t + c[2];
+
+        tangentY = (3 * c[4] * t + 2 * c[5]) * t + c[6];
+
+        // a cusp has no derivative; the chord to a nearby point gives its direction
+
+        if (tangentX == 0 && tangentY == 0) {
+
+            const auto other = t < 0.5 ? t + 1e-3 : t - 1e-3;
+
+            const auto sign = t < 0.5 ? 1.0 : -1.0;
+
+            tangentX = sign * ((((c[0] * other + c[1]) * other + c[2]) * other + c[3]) - x);
+
+            tangentY = sign * ((((c[4] * other + c[5]) * other + c[6]) * other + c[7]) - y);
+        }
+    }
+
+    ///
+
+    const auto norm = std::hypot(tangentX, tangentY);
+
+    if (norm > 0) {
+
+        tangentX /= norm;
+
+        tangentY /= norm;
+    }
+
+    return { float(x), float(y), float(tangentX), float(tangentY) };
+}
+
+const PathSample PathArcLengthTable::sampleAt(
+    float distance) const
+{
+    if (m_intervals.empty()) {
+
+        return { m_originX, m_originY, 1, 0 };
+    }
+
+    ///
+
+    const auto clamped = std::clamp(distance, 0.0f, m_length);
+
+    const auto index = findInterval(clamped);
+
+    const auto& interval = m_intervals[index];
+
+    const auto& segment = m_segments[interval.segment];
+
+    const auto s0 = index == 0 ? 0.0f : m_intervalEnds[index - 1];
+
+    const auto s1 = m_intervalEnds[index];
+
+    const auto fraction = s1 > s0 ? (clamped - s0) / (s1 - s0) : 0.0f;
+
+    auto t = double(interval.t0) + fraction * double(interval.t1 - interval.t0);
+
+    ///
+
+    const auto speedAtT = speed(segment, t);
+
+    if (speedAtT > 0) {
+
+        const auto error = lengthBetween(segment, interval.t0, t) - (clamped - s0);
+
+        t = std::clamp(t - error / speedAtT, double(interval.t0), double(interval.t1));
+    }
+
+    ///
+
+    return evaluate(segment, t);
+}
+
+void PathArcLengthTable::sampleAt(
+    const float* distances,
+    PathSample* samples,
+    size_t count) const
+{
+    if (m_intervals.empty()) {
+
+        for (size_t i = 0; i < count; ++i) {
+
+            samples[i] = { m_originX, m_originY, 1, 0 };
+        }
+
+        return;
+    }
+
+    ///
+
+    for (size_t base = 0; base < count; base += 4) {
+
+        const auto lanes = std::min(size_t(4), count - base);
+
+        SimdPolynomial polynomial = {};
+
+        SimdFloat4 distance = {}, s0 = {}, s1 = {}, t0 = {}, t1 = {};
+
+        int arcLanes = 0;
+
+        // gather each lane's interval and coefficients; arc lanes keep zero
+        // coefficients here and are resolved by the scalar path below
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+
+            const auto clamped = std::clamp(distances[base + lane], 0.0f, m_length);
+
+            const auto index = findInterval(clamped);
+
+            const auto& interval = m_intervals[index];
+
+            const auto& segment = m_segments[interval.segment];
+
+            distance[lane] = clamped;
+
+            s0[lane] = index == 0 ? 0.0f : m_intervalEnds[index - 1];
+
+            s1[lane] = m_intervalEnds[index];
+
+            t0[lane] = interval.t0;
+
+            t1[lane] = interval.t1;
+
+            if (segment.kind == SegmentKind::Arc) {
+
+                arcLanes |= 1 << lane;
+
+                continue;
+            }
+
+            const auto* c = m_polynomials[segment.index].coefficients;
+
+            for (auto k = 0; k < 8; ++k) {
+
+                polynomial.coefficients[k][lane] = c[k];
+            }
+        }
+
+        ///
+
+        const auto span = s1 - s0;
+
+        const auto fraction = span > 0 ? (distance - s0) / span : simdSplat(0);
+
+        auto t = t0 + fraction * (t1 - t0);
+
+        // one Newton step on the quadrature length from t0 to t
+
+        const auto half = (t - t0) * simdSplat(0.5f);
+
+        const auto middle = (t + t0) * simdSplat(0.5f);
+
+        auto integral = simdSplat(0);
+
+        for (auto i = 0; i < 5; ++i) {
+
+            const auto node = middle + half * simdSplat(float(gaussNodes[i]));
+
+            integral += simdSplat(float(gaussWeights[i])) * simdSpeed(polynomial, node);
+        }
+
+        const auto speedAtT = simdSpeed(polynomial, t);
+
+        const auto step = (integral * half - (distance - s0)) / speedAtT;
+
+        t = speedAtT > 0 ? t - step : t;
+
+        t = simdMin(simdMax(t, t0), t1);
+
+        ///
+
+        const auto* c = polynomial.coefficients;
+
+        const auto x = ((c[0] * t + c[1]) * t + c[2]) * t + c[3];
+
+        const auto y = ((c[4] * t + c[5]) * t + c[6]) * t + c[7];
+
+        auto tangentX = (simdSplat(3) * c[0] * t + simdSplat(2) * c[1]) * t + c[2];
+
+        auto tangentY = (simdSplat(3) * c[4] * t + simdSplat(2) * c[5]) * t + c[6];
+
+        const auto norm = simdSqrt(tangentX * tangentX + tangentY * tangentY);
+
+        tangentX = norm > 0 ? tangentX / norm : tangentX;
+
+        tangentY = norm > 0 ? tangentY / norm : tangentY;
+
+        ///
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+
+            if ((arcLanes & (1 << lane)) || norm[lane] == 0) {
+
+                samples[base + lane] = sampleAt(distance[lane]);
+
+                continue;
+            }
+
+            samples[base + lane] = { x[lane], y[lane], tangentX[lane], tangentY[lane] };
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PathBuffer.h"
+#include "PathGeometry.h"
+
+// arc length
+
+struct PathSample {
+    float x;
+    float y;
+    float tangentX;
+    float tangentY;
+};
+
+// Cumulative arc length of a path buffer, measured with 5-point Gauss-Legendre
+// quadrature over short parameter intervals of every line, quadratic, cubic and
+// arc. Queries binary search the interval ends, then take one Newton step on the
+// exact length so results do not depend on the table density.
+//
+// The table copies everything it needs out of the buffer, so it can be built once
+// and cached next to the parsed commands.
+
+class PathArcLengthTable final {
+public:
+    static const PathArcLengthTable build(
+        const PathBuffer& buffer);
+
+    ///
+
+    const float length() const { return m_length; }
+
+    // `distance` is clamped to [0, length()]; tangents are unit length
+
+    const PathSample sampleAt(
+        float distance) const;
+
+    // Samples many distances at once, evaluating polynomial segments four lanes at
+    // a time. Sorted input is not required.
+
+    void sampleAt(
+        const float* distances,
+        PathSample* samples,
+        size_t count) const;
+
+private:
+    enum class SegmentKind : uint8_t {
+        Polynomial,
+        Arc,
+    };
+
+    struct Segment {
+        SegmentKind kind;
+        uint32_t index;
+    };
+
+    // x(t) = ((c[0] t + c[1]) t + c[2]) t + c[3], y(t) likewise from c[4]
+
+    struct Polynomial {
+        float coefficients[8];
+    };
+
+    struct Interval {
+        uint32_t segment;
+        float t0;
+        float t1;
+    };
+
+    void addPolynomial(
+        const double* points,
+        int degree);
+
+    void addArc(
+        const PathEllipse& ellipse);
+
+    void addIntervals(
+        int intervalCount);
+
+    const double speed(
+        const Segment& segment,
+        double t) const;
+
+    const double lengthBetween(
+        const Segment& segment,
+        double t0,
+        double t1) const;
+
+    const size_t findInterval(
+        float distance) const;
+
+    const PathSample evaluate(
+        const Segment& segment,
+        double t) const;
+
+    std::vector<Segment> m_segments;
+
+    std::vector<Polynomial> m_polynomials;
+
+    std::vector<PathEllipse> m_arcs;
+
+    std::vector<Interval> m_intervals;
+
+    std::vector<float> m_intervalEnds;
+
+    double m_accumulated = 0;
+
+    float m_length = 0;
+
+    float m_originX = 0;
+
+    float m_originY = 0;
+};
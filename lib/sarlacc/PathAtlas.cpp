@@ -0,0 +1,309 @@
+#include "PathAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "Parallel.h"
+#include "PathBounds.h"
+#include "PathFlattener.h"
+#include "PathRasterizer.h"
+
+// atlases
+
+namespace {
+
+// The top edge of everything packed so far, as runs of constant height from left
+// to right. Each rect goes where its top would be lowest, leftmost on ties.
+
+class SkylinePacker {
+public:
+    SkylinePacker(
+        int width)
+        : m_width(width)
+    {
+        m_nodes.push_back({ 0, 0, width });
+    }
+
+    void insert(
+        int width,
+        int height,
+        int& x,
+        int& y)
+    {
+        auto bestTop = std::numeric_limits<int>::max();
+
+        auto bestNode = size_t(0);
+
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+
+            const auto top = fit(i, width);
+
+            if (top >= 0 && top + height < bestTop) {
+
+                bestTop = top + height;
+
+                bestNode = i;
+            }
+        }
+
+        x = m_nodes[bestNode].x;
+
+        y = bestTop - height;
+
+        ///
+
+        // the new run replaces whatever it now covers
+
+        const auto right = x + width;
+
+        auto end = bestNode;
+
+        while (end < m_nodes.size() && m_nodes[end].x + m_nodes[end].width <= right) {
+
+            ++end;
+        }
+
+        if (end < m_nodes.size() && m_nodes[end].x < right) {
+
+            auto& partial = m_nodes[end];
+
+            partial.width -= right - partial.x;
+
+            partial.x = right;
+        }
+
+        m_nodes.erase(m_nodes.begin() + bestNode, m_nodes.begin() + end);
+
+        m_nodes.insert(m_nodes.begin() + bestNode, { x, bestTop, width });
+
+        merge();
+    }
+
+    const int height() const
+    {
+        auto height = 0;
+
+        for (const auto& node : m_nodes) {
+
+            height = std::max(height, node.y);
+        }
+
+        return height;
+    }
+
+private:
+    struct Node {
+        int x;
+        int y;
+        int width;
+    };
+
+    // the lowest top for a rect whose left edge is at node `index`, or -1
+
+    const int fit(
+        size_t index,
+        int width) const
+    {
+        if (m_nodes[index].x + width > m_width) {
+
+            return -1;
+        }
+
+        auto top = 0;
+
+        auto remaining = width;
+
+        for (auto i = index; remaining > 0; ++i) {
+
+            top = std::max(top, m_nodes[i].y);
+
+            remaining -= m_nodes[i].width;
+        }
+
+        return top;
+    }
+
+    void merge()
+    {
+        for (size_t i = 1; i < m_nodes.size();) {
+
+            if (m_nodes[i - 1].y == m_nodes[i].y) {
+
+                m_nodes[i - 1].width += m_nodes[i].width;
+
+                m_nodes.erase(m_nodes.begin() + i);
+            } else {
+
+                ++i;
+            }
+        }
+    }
+
+    const int m_width;
+
+    std::vector<Node> m_nodes;
+};
+
+}
+
+const PathAtlas PathAtlasBuilder::build(
+    const std::vector<PathBuffer>& paths,
+    const PathAtlasOptions& options)
+{
+    const auto scale = options.scale;
+
+    const auto padding = std::max(0, options.padding);
+
+    PathAtlas atlas;
+
+    atlas.entries.resize(paths.size());
+
+    // bounds are independent per path, so measure them in parallel too
+
+    Parallel::forEach(paths.size(), 256, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+
+            const auto bounds = PathBounds::compute(paths[i]);
+
+            auto& entry = atlas.entries[i];
+
+            entry = PathAtlasEntry {};
+
+            if (bounds.isEmpty()) {
+
+                continue;
+            }
+
+            const auto left = std::floor(bounds.minX * scale);
+
+            const auto top = std::floor(bounds.minY * scale);
+
+            entry.width = int(std::ceil(bounds.maxX * scale) - left);
+
+            entry.height = int(std::ceil(bounds.maxY * scale) - top);
+
+            entry.originX = left / scale;
+
+            entry.originY = top / scale;
+        }
+    });
+
+    ///
+
+    atlas.width = options.width;
+
+    for (const auto& entry : atlas.entries) {
+
+        atlas.width = std::max(atlas.width, entry.width + padding * 2);
+    }
+
+    std::vector<uint32_t> order(paths.size());
+
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const auto& first = atlas.entries[a];
+
+        const auto& second = atlas.entries[b];
+
+        return first.height != second.height ? first.height > second.height : first.width > second.width;
+    });
+
+    SkylinePacker packer(atlas.width);
+
+    for (const auto index : order) {
+
+        auto& entry = atlas.entries[index];
+
+        if (entry.width == 0 || entry.height == 0) {
+
+            continue;
+        }
+
+        int x, y;
+
+        packer.insert(entry.width + padding * 2, entry.height + padding * 2, x, y);
+
+        entry.x = x + padding;
+
+        entry.y = y + padding;
+    }
+
+    atlas.height = std::max(1, packer.height());
+
+    ///
+
+    for (auto& entry : atlas.entries) {
+
+        entry.u0 = float(entry.x) / atlas.width;
+
+        entry.v0 = float(entry.y) / atlas.height;
+
+        entry.u1 = float(entry.x + entry.width) / atlas.width;
+
+        entry.v1 = float(entry.y + entry.height) / atlas.height;
+    }
+
+    atlas.pixels.assign(size_t(atlas.width) * atlas.height * 4, 0);
+
+    const auto rowBytes = size_t(atlas.width) * 4;
+
+    Parallel::forEach(paths.size(), 16, [&](size_t begin, size_t end) {
+        PathPolylines polylines;
+
+        std::vector<uint8_t> coverage;
+
+        std::vector<float> accumulation;
+
+        for (auto i = begin; i < end; ++i) {
+
+            const auto& entry = atlas.entries[i];
+
+            if (entry.width == 0 || entry.height == 0) {
+
+                continue;
+            }
+
+            PathFlattener::flatten(paths[i], options.tolerance / scale, polylines);
+
+            for (size_t point = 0; point < polylines.pointCount(); ++point) {
+
+                polylines.points[point * 2] = (polylines.points[point * 2] - entry.originX) * scale;
+
+                polylines.points[point * 2 + 1] = (polylines.points[point * 2 + 1] - entry.originY) * scale;
+            }
+
+            coverage.resize(size_t(entry.width) * entry.height);
+
+            PathRasterizer::rasterize(polylines, options.fillRule, entry.width, entry.height, coverage.data(), entry.width, accumulation);
+
+            ///
+
+            for (auto row = 0; row < entry.height; ++row) {
+
+                const auto* source = coverage.data() + size_t(row) * entry.width;
+
+                auto* out = atlas.pixels.data() + size_t(entry.y + row) * rowBytes + size_t(entry.x) * 4;
+
+                for (auto column = 0; column < entry.width; ++column) {
+
+                    const auto alpha = source[column];
+
+                    out[column * 4] = alpha;
+
+                    out[column * 4 + 1] = alpha;
+
+                    out[column * 4 + 2] = alpha;
+
+                    out[column * 4 + 3] = alpha;
+                }
+            }
+        }
+    });
+
+    ///
+
+    return atlas;
+}
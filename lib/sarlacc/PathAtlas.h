@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PathBuffer.h"
+
+// atlases
+
+struct PathAtlasOptions {
+    // grown to fit the widest entry if needed; the height follows from packing
+    int width = 2048;
+    // transparent pixels around every entry, so filtering never bleeds between them
+    int padding = 1;
+    // path units to pixels
+    float scale = 1;
+    PathFillRule fillRule = PathFillRule::NonZero;
+    // flattening tolerance in pixels
+    float tolerance = 0.25f;
+};
+
+struct PathAtlasEntry {
+    // the pixels covering the path, padding excluded; empty paths get a 0x0 rect
+    int x;
+    int y;
+    int width;
+    int height;
+    // the same rect normalised, with (0, 0) at the top left as Metal samples it
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+    // the point in path units that lands on the rect's top-left corner
+    float originX;
+    float originY;
+};
+
+struct PathAtlas {
+    int width;
+    int height;
+    // premultiplied white with coverage alpha, for `MTL::PixelFormatRGBA8Unorm`
+    std::vector<uint8_t> pixels;
+    // one per input path, in input order
+    std::vector<PathAtlasEntry> entries;
+};
+
+class PathAtlasBuilder final {
+public:
+    // Measures the tight bounds of every path, packs the rects tallest first with
+    // a bottom-left skyline packer, then rasterizes entries in parallel straight
+    // into the shared image (packed rects never overlap, so no locking is needed).
+
+    static const PathAtlas build(
+        const std::vector<PathBuffer>& paths,
+        const PathAtlasOptions& options);
+};
@@ -0,0 +1,250 @@
+#include "PathBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include "PathGeometry.h"
+
+// path bounds
+
+namespace {
+
+class BoundsAccumulator {
+public:
+    void add(
+        double x,
+        double y)
+    {
+        m_minX = std::min(m_minX, x);
+
+        m_minY = std::min(m_minY, y);
+
+        m_maxX = std::max(m_maxX, x);
+
+        m_maxY = std::max(m_maxY, y);
+    }
+
+    // roots in (0, 1) of a t^2 + b t + c, the derivative of one curve coordinate
+
+    void addExtrema(
+        const double* points,
+        int degree,
+        double a,
+        double b,
+        double c)
+    {
+        double roots[2];
+
+        auto count = 0;
+
+        if (std::abs(a) < 1e-12) {
+
+            if (std::abs(b) > 1e-12) {
+
+                roots[count++] = -c / b;
+            }
+        } else {
+
+            const auto discriminant = b * b - 4 * a * c;
+
+            if (discriminant >= 0) {
+
+                const auto root = std::sqrt(discriminant);
+
+                roots[count++] = (-b + root) / (2 * a);
+
+                roots[count++] = (-b - root) / (2 * a);
+            }
+        }
+
+        for (auto i = 0; i < count; ++i) {
+
+            const auto t = roots[i];
+
+            if (t <= 0 || t >= 1) {
+
+                continue;
+            }
+
+            const auto u = 1 - t;
+
+            if (degree == 2) {
+
+                add(u * u * points[0] + 2 * u * t * points[2] + t * t * points[4],
+                    u * u * points[1] + 2 * u * t * points[3] + t * t * points[5]);
+            } else {
+
+                add(u * u * u * points[0] + 3 * u * u * t * points[2] + 3 * u * t * t * points[4] + t * t * t * points[6],
+                    u * u * u * points[1] + 3 * u * u * t * points[3] + 3 * u * t * t * points[5] + t * t * t * points[7]);
+            }
+        }
+    }
+
+    void addCurve(
+        const double* points,
+        int degree)
+    {
+        add(points[degree * 2], points[degree * 2 + 1]);
+
+        for (auto axis = 0; axis < 2; ++axis) {
+
+            const auto p0 = points[axis], p1 = points[2 + axis], p2 = points[4 + axis];
+
+            if (degree == 2) {
+
+                addExtrema(points, degree, 0, p0 - 2 * p1 + p2, p1 - p0);
+            } else {
+
+                const auto p3 = points[6 + axis];
+
+                addExtrema(points, degree, -p0 + 3 * p1 - 3 * p2 + p3, 2 * (p0 - 2 * p1 + p2), p1 - p0);
+            }
+        }
+    }
+
+    // x(t) and y(t) each peak twice per turn, at `phase` and `phase + pi`
+
+    void addArc(
+        const PathEllipse& ellipse)
+    {
+        const auto phases = {
+            std::atan2(-ellipse.radiusY * ellipse.sinRotation, ellipse.radiusX * ellipse.cosRotation),
+            std::atan2(ellipse.radiusY * ellipse.cosRotation, ellipse.radiusX * ellipse.sinRotation),
+        };
+
+        const auto low = std::min(ellipse.startAngle, ellipse.startAngle + ellipse.sweepAngle);
+
+        const auto high = std::max(ellipse.startAngle, ellipse.startAngle + ellipse.sweepAngle);
+
+        for (const auto phase : phases) {
+
+            for (auto angle = phase + std::ceil((low - phase) / std::numbers::pi) * std::numbers::pi; angle < high; angle += std::numbers::pi) {
+
+                double x, y;
+
+                PathGeometry::pointOnEllipse(ellipse, angle, x, y);
+
+                add(x, y);
+            }
+        }
+    }
+
+    const PathRect rect() const
+    {
+        if (m_minX > m_maxX) {
+
+            return PathRect { 0, 0, 0, 0 };
+        }
+
+        return PathRect { float(m_minX), float(m_minY), float(m_maxX), float(m_maxY) };
+    }
+
+private:
+    double m_minX = std::numeric_limits<double>::infinity();
+
+    double m_minY = std::numeric_limits<double>::infinity();
+
+    double m_maxX = -std::numeric_limits<double>::infinity();
+
+    double m_maxY = -std::numeric_limits<double>::infinity();
+};
+
+}
+
+const PathRect PathBounds::compute(
+    const PathBuffer& buffer)
+{
+    BoundsAccumulator bounds;
+
+    double currentX = 0, currentY = 0;
+
+    size_t coordinate = 0;
+
+    size_t arc = 0;
+
+    for (const auto verb : buffer.verbs) {
+
+        const auto* p = buffer.coordinates.data() + coordinate;
+
+        switch (verb) {
+        case PathVerb::MoveTo:
+        case PathVerb::ClosePath:
+            break;
+
+        case PathVerb::LineTo: {
+
+            bounds.add(currentX, currentY);
+
+            bounds.add(p[0], p[1]);
+
+            break;
+        }
+
+        case PathVerb::QuadraticTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3] };
+
+            bounds.add(currentX, currentY);
+
+            bounds.addCurve(points, 2);
+
+            break;
+        }
+
+        case PathVerb::CubicTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3], p[4], p[5] };
+
+            bounds.add(currentX, currentY);
+
+            bounds.addCurve(points, 3);
+
+            break;
+        }
+
+        case PathVerb::ArcTo: {
+
+            const auto& parameters = buffer.arcs[arc++];
+
+            bounds.add(currentX, currentY);
+
+            bounds.add(p[0], p[1]);
+
+            const auto ellipse = PathGeometry::centerArc(
+                currentX,
+                currentY,
+                parameters.radiusX,
+                parameters.radiusY,
+                parameters.rotation,
+                parameters.largeArc,
+                parameters.sweep,
+                p[0],
+                p[1]);
+
+            if (ellipse.has_value()) {
+
+                bounds.addArc(ellipse.value());
+            }
+
+            break;
+        }
+        }
+
+        ///
+
+        const auto count = PathVerbs::pointCount(verb) * 2;
+
+        if (count > 0) {
+
+            currentX = p[count - 2];
+
+            currentY = p[count - 1];
+        }
+
+        coordinate += count;
+    }
+
+    return bounds.rect();
+}
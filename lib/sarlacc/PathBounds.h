@@ -0,0 +1,28 @@
+#pragma once
+
+#include "PathBuffer.h"
+
+// path bounds
+
+struct PathRect {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+
+    const float width() const { return maxX - minX; }
+
+    const float height() const { return maxY - minY; }
+
+    const bool isEmpty() const { return !(maxX > minX) || !(maxY > minY); }
+};
+
+class PathBounds final {
+public:
+    // The exact extent of the drawn outline: curve and arc extrema are solved for
+    // rather than taken from control points. A buffer with no segments returns an
+    // empty rect at the origin.
+
+    static const PathRect compute(
+        const PathBuffer& buffer);
+};
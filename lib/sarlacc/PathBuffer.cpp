@@ -0,0 +1,511 @@
+#include "PathBuffer.h"
+
+#include "PathGeometry.h"
+
+// path buffers
+
+namespace {
+
+template <typename T>
+class PathBufferWriter {
+public:
+    PathBufferWriter(
+        BasicPathBuffer<T>& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    ///
+
+    void moveTo(
+        T x,
+        T y)
+    {
+        push(PathVerb::MoveTo, { x, y });
+
+        m_startX = x;
+
+        m_startY = y;
+
+        m_open = true;
+    }
+
+    void lineTo(
+        T x,
+        T y)
+    {
+        ensureOpen();
+
+        push(PathVerb::LineTo, { x, y });
+    }
+
+    void quadraticTo(
+        T controlX,
+        T controlY,
+        T x,
+        T y)
+    {
+        ensureOpen();
+
+        push(PathVerb::QuadraticTo, { controlX, controlY, x, y });
+
+        m_lastControlX = controlX;
+
+        m_lastControlY = controlY;
+    }
+
+    void cubicTo(
+        T control1X,
+        T control1Y,
+        T control2X,
+        T control2Y,
+        T x,
+        T y)
+    {
+        ensureOpen();
+
+        push(PathVerb::CubicTo, { control1X, control1Y, control2X, control2Y, x, y });
+
+        m_lastControlX = control2X;
+
+        m_lastControlY = control2Y;
+    }
+
+    void arcTo(
+        const BasicPathBufferArc<T>& arc,
+        T x,
+        T y)
+    {
+        ensureOpen();
+
+        push(PathVerb::ArcTo, { x, y });
+
+        m_buffer.arcs.push_back(arc);
+    }
+
+    void closePath()
+    {
+        if (!m_open) {
+
+            return;
+        }
+
+        m_buffer.verbs.push_back(PathVerb::ClosePath);
+
+        m_currentX = m_startX;
+
+        m_currentY = m_startY;
+
+        m_open = false;
+
+        m_previous = PathVerb::ClosePath;
+    }
+
+    ///
+
+    // the control point a smooth curve reflects: the previous curve's last
+    // control point when it was the same kind of curve, else the current point
+
+    void reflectedControl(
+        PathVerb kind,
+        T& x,
+        T& y) const
+    {
+        if (m_previous == kind) {
+
+            x = m_currentX + (m_currentX - m_lastControlX);
+
+            y = m_currentY + (m_currentY - m_lastControlY);
+
+            return;
+        }
+
+        x = m_currentX;
+
+        y = m_currentY;
+    }
+
+    const T& currentX() const { return m_currentX; }
+
+    const T& currentY() const { return m_currentY; }
+
+private:
+    void ensureOpen()
+    {
+        // drawing after a close path continues from that contour's start point
+
+        if (!m_open) {
+
+            moveTo(m_currentX, m_currentY);
+        }
+    }
+
+    void push(
+        PathVerb verb,
+        std::initializer_list<T> coordinates)
+    {
+        m_buffer.verbs.push_back(verb);
+
+        m_buffer.coordinates.insert(m_buffer.coordinates.end(), coordinates);
+
+        m_currentX = *(coordinates.end() - 2);
+
+        m_currentY = *(coordinates.end() - 1);
+
+        m_previous = verb;
+    }
+
+    BasicPathBuffer<T>& m_buffer;
+
+    T m_currentX {};
+
+    T m_currentY {};
+
+    T m_startX {};
+
+    T m_startY {};
+
+    T m_lastControlX {};
+
+    T m_lastControlY {};
+
+    PathVerb m_previous = PathVerb::MoveTo;
+
+    bool m_open = false;
+};
+
+}
+
+template <typename T>
+const BasicPathBuffer<T> BasicPathBufferBuilder<T>::fromSubPaths(
+    const std::vector<std::vector<BasicPathCommand<T>>>& subPaths)
+{
+    BasicPathBuffer<T> buffer;
+
+    PathBufferWriter<T> writer(buffer);
+
+    ///
+
+    for (const auto& subPath : subPaths) {
+
+        for (const auto& command : subPath) {
+
+            const auto relative = command.position == PathCommandPosition::Relative;
+
+            // relative coordinates are offsets from the current point at the
+            // start of each segment
+
+            const auto resolveX = [&](const BasicPathNumber<T>& number) {
+                return relative ? writer.currentX() + number.value : number.value;
+            };
+
+            const auto resolveY = [&](const BasicPathNumber<T>& number) {
+                return relative ? writer.currentY() + number.value : number.value;
+            };
+
+            ///
+
+            switch (command.type) {
+            case PathCommandType::MoveTo: {
+
+                const auto& points = command.points.value();
+
+                for (size_t i = 0; i < points.size(); ++i) {
+
+                    const auto x = resolveX(points[i].x);
+
+                    const auto y = resolveY(points[i].y);
+
+                    if (i == 0) {
+
+                        writer.moveTo(x, y);
+                    } else {
+
+                        writer.lineTo(x, y);
+                    }
+                }
+
+                break;
+            }
+
+            case PathCommandType::LineTo: {
+
+                for (const auto& point : command.points.value()) {
+
+                    writer.lineTo(resolveX(point.x), resolveY(point.y));
+                }
+
+                break;
+            }
+
+            case PathCommandType::HorizontalLineTo: {
+
+                for (const auto& number : command.numbers.value()) {
+
+                    writer.lineTo(resolveX(number), writer.currentY());
+                }
+
+                break;
+            }
+
+            case PathCommandType::VerticalLineTo: {
+
+                for (const auto& number : command.numbers.value()) {
+
+                    writer.lineTo(writer.currentX(), resolveY(number));
+                }
+
+                break;
+            }
+
+            case PathCommandType::CurveTo: {
+
+                const auto& points = command.points.value();
+
+                for (size_t i = 0; i + 2 < points.size(); i += 3) {
+
+                    writer.cubicTo(
+                        resolveX(points[i].x),
+                        resolveY(points[i].y),
+                        resolveX(points[i + 1].x),
+                        resolveY(points[i + 1].y),
+                        resolveX(points[i + 2].x),
+                        resolveY(points[i + 2].y));
+                }
+
+                break;
+            }
+
+            case PathCommandType::SmoothCurveTo: {
+
+                const auto& points = command.points.value();
+
+                for (size_t i = 0; i + 1 < points.size(); i += 2) {
+
+                    T controlX, controlY;
+
+                    writer.reflectedControl(PathVerb::CubicTo, controlX, controlY);
+
+                    writer.cubicTo(
+                        controlX,
+                        controlY,
+                        resolveX(points[i].x),
+                        resolveY(points[i].y),
+                        resolveX(points[i + 1].x),
+                        resolveY(points[i + 1].y));
+                }
+
+                break;
+            }
+
+            case PathCommandType::QuadraticBezierCurveTo: {
+
+                const auto& points = command.points.value();
+
+                for (size_t i = 0; i + 1 < points.size(); i += 2) {
+
+                    writer.quadraticTo(
+                        resolveX(points[i].x),
+                        resolveY(points[i].y),
+                        resolveX(points[i + 1].x),
+                        resolveY(points[i + 1].y));
+                }
+
+                break;
+            }
+
+            case PathCommandType::SmoothQuadraticBezierCurveTo: {
+
+                for (const auto& point : command.points.value()) {
+
+                    T controlX, controlY;
+
+                    writer.reflectedControl(PathVerb::QuadraticTo, controlX, controlY);
+
+                    writer.quadraticTo(controlX, controlY, resolveX(point.x), resolveY(point.y));
+                }
+
+                break;
+            }
+
+            case PathCommandType::EllipticalArc: {
+
+                for (const auto& arc : command.arcs.value()) {
+
+                    const auto& radii = std::get<0>(arc);
+
+                    const auto& rotation = std::get<1>(arc);
+
+                    const auto& flags = std::get<2>(arc);
+
+                    const auto& end = std::get<3>(arc);
+
+                    const auto x = resolveX(end.x);
+
+                    const auto y = resolveY(end.y);
+
+                    const auto radiusX = radii.x.value < T {} ? -radii.x.value : radii.x.value;
+
+                    const auto radiusY = radii.y.value < T {} ? -radii.y.value : radii.y.value;
+
+                    if (radiusX == T {} || radiusY == T {}) {
+
+                        writer.lineTo(x, y);
+
+                        continue;
+                    }
+
+                    writer.arcTo(
+                        BasicPathBufferArc<T> {
+                            radiusX,
+                            radiusY,
+                            rotation.value,
+                            flags.x.value != T {},
+                            flags.y.value != T {} },
+                        x,
+                        y);
+                }
+
+                break;
+            }
+
+            case PathCommandType::ClosePath: {
+
+                writer.closePath();
+
+                break;
+            }
+            }
+        }
+    }
+
+    ///
+
+    return buffer;
+}
+
+template <typename T>
+const BasicPathBuffer<T> BasicPathBufferBuilder<T>::withArcsAsCubics(
+    const BasicPathBuffer<T>& buffer)
+{
+    if (buffer.arcs.empty()) {
+
+        return buffer;
+    }
+
+    ///
+
+    BasicPathBuffer<T> result;
+
+    result.verbs.reserve(buffer.verbs.size() + buffer.arcs.size() * 3);
+
+    result.coordinates.reserve(buffer.coordinates.size() + buffer.arcs.size() * 16);
+
+    std::vector<double> controlPoints;
+
+    size_t coordinate = 0;
+
+    size_t arc = 0;
+
+    T currentX {}, currentY {}, startX {}, startY {};
+
+    ///
+
+    for (const auto verb : buffer.verbs) {
+
+        const auto count = PathVerbs::pointCount(verb) * 2;
+
+        if (verb == PathVerb::ArcTo) {
+
+            const auto& parameters = buffer.arcs[arc++];
+
+            const auto toX = buffer.coordinates[coordinate];
+
+            const auto toY = buffer.coordinates[coordinate + 1];
+
+            const auto ellipse = PathGeometry::centerArc(
+                PathScalar<T>::toDouble(currentX),
+                PathScalar<T>::toDouble(currentY),
+                PathScalar<T>::toDouble(parameters.radiusX),
+                PathScalar<T>::toDouble(parameters.radiusY),
+                PathScalar<T>::toDouble(parameters.rotation),
+                parameters.largeArc,
+                parameters.sweep,
+                PathScalar<T>::toDouble(toX),
+                PathScalar<T>::toDouble(toY));
+
+            if (!ellipse.has_value()) {
+
+                result.verbs.push_back(PathVerb::LineTo);
+
+                result.coordinates.insert(result.coordinates.end(), { toX, toY });
+            } else {
+
+                controlPoints.clear();
+
+                const auto cubics = PathGeometry::arcToCubics(ellipse.value(), controlPoints);
+
+                for (auto i = 0; i < cubics; ++i) {
+
+                    result.verbs.push_back(PathVerb::CubicTo);
+
+                    for (auto j = 0; j < 6; ++j) {
+
+                        result.coordinates.push_back(PathScalar<T>::fromDouble(controlPoints[i * 6 + j]));
+                    }
+                }
+
+                // land exactly on the original end point
+
+                result.coordinates[result.coordinates.size() - 2] = toX;
+
+                result.coordinates[result.coordinates.size() - 1] = toY;
+            }
+        } else {
+
+            result.verbs.push_back(verb);
+
+            result.coordinates.insert(
+                result.coordinates.end(),
+                buffer.coordinates.begin() + coordinate,
+                buffer.coordinates.begin() + coordinate + count);
+        }
+
+        ///
+
+        if (verb == PathVerb::ClosePath) {
+
+            currentX = startX;
+
+            currentY = startY;
+        } else {
+
+            currentX = buffer.coordinates[coordinate + count - 2];
+
+            currentY = buffer.coordinates[coordinate + count - 1];
+        }
+
+        if (verb == PathVerb::MoveTo) {
+
+            startX = currentX;
+
+            startY = currentY;
+        }
+
+        coordinate += count;
+    }
+
+    ///
+
+    return result;
+}
+
+///
+
+template class BasicPathBufferBuilder<float>;
+
+template class BasicPathBufferBuilder<double>;
+
+template class BasicPathBufferBuilder<Fixed16_16>;
+
+template class BasicPathBufferBuilder<Fixed24_8>;
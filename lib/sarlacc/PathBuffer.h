@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Path.h"
+#include "PathScalar.h"
+
+// path buffers
+
+// A parsed path flattened into contiguous arrays in absolute coordinates: `H`/`V`
+// become lines, smooth curves get their reflected control point, and every
+// contour starts with a MoveTo. This is the form the geometry kernels consume.
+
+enum class PathVerb : uint8_t {
+    MoveTo,
+    LineTo,
+    QuadraticTo,
+    CubicTo,
+    ArcTo,
+    ClosePath,
+};
+
+enum class PathFillRule {
+    NonZero,
+    EvenOdd,
+};
+
+class PathVerbs final {
+public:
+    // number of (x, y) pairs each verb consumes from `coordinates`
+
+    static constexpr int pointCount(
+        PathVerb verb)
+    {
+        switch (verb) {
+        case PathVerb::MoveTo:
+        case PathVerb::LineTo:
+        case PathVerb::ArcTo:
+            return 1;
+
+        case PathVerb::QuadraticTo:
+            return 2;
+
+        case PathVerb::CubicTo:
+            return 3;
+
+        case PathVerb::ClosePath:
+            return 0;
+        }
+
+        return 0;
+    }
+};
+
+///
+
+template <typename T>
+struct BasicPathBufferArc {
+    T radiusX;
+    T radiusY;
+    T rotation;
+    bool largeArc;
+    bool sweep;
+};
+
+template <typename T>
+struct BasicPathBuffer {
+    std::vector<PathVerb> verbs;
+    std::vector<T> coordinates;
+    std::vector<BasicPathBufferArc<T>> arcs;
+};
+
+///
+
+template <typename T>
+class BasicPathBufferBuilder final {
+public:
+    static const BasicPathBuffer<T> fromSubPaths(
+        const std::vector<std::vector<BasicPathCommand<T>>>& subPaths);
+
+    // Replaces every ArcTo with one cubic per quarter turn (or a line for arcs
+    // SVG draws straight), for consumers that only handle polynomial segments.
+
+    static const BasicPathBuffer<T> withArcsAsCubics(
+        const BasicPathBuffer<T>& buffer);
+};
+
+using PathBuffer = BasicPathBuffer<float>;
+
+using PathBufferArc = BasicPathBufferArc<float>;
+
+using PathBufferBuilder = BasicPathBufferBuilder<float>;
+
+extern template class BasicPathBufferBuilder<float>;
+
+extern template class BasicPathBufferBuilder<double>;
+
+extern template class BasicPathBufferBuilder<Fixed16_16>;
+
+extern template class BasicPathBufferBuilder<Fixed24_8>;
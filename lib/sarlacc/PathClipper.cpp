@@ -0,0 +1,747 @@
+#include "PathClipper.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "PathGeometry.h"
+
+// clipping
+
+namespace {
+
+const double evaluate(
+    const double* points,
+    int degree,
+    int axis,
+    double t)
+{
+    const auto u = 1 - t;
+
+    const auto* p = points + axis;
+
+    switch (degree) {
+    case 1:
+        return u * p[0] + t * p[2];
+
+    case 2:
+        return u * u * p[0] + 2 * u * t * p[2] + t * t * p[4];
+
+    default:
+        return u * u * u * p[0] + 3 * u * u * t * p[2] + 3 * u * t * t * p[4] + t * t * t * p[6];
+    }
+}
+
+// de Casteljau, in place: keeps [0, t] or [t, 1]
+
+void splitLeft(
+    double* points,
+    int degree,
+    double t)
+{
+    for (auto level = 1; level <= degree; ++level) {
+
+        for (auto i = degree; i >= level; --i) {
+
+            points[i * 2] = points[(i - 1) * 2] + t * (points[i * 2] - points[(i - 1) * 2]);
+
+            points[i * 2 + 1] = points[(i - 1) * 2 + 1] + t * (points[i * 2 + 1] - points[(i - 1) * 2 + 1]);
+        }
+    }
+}
+
+void splitRight(
+    double* points,
+    int degree,
+    double t)
+{
+    for (auto level = 1; level <= degree; ++level) {
+
+        for (auto i = 0; i <= degree - level; ++i) {
+
+            points[i * 2] = points[i * 2] + t * (points[(i + 1) * 2] - points[i * 2]);
+
+            points[i * 2 + 1] = points[i * 2 + 1] + t * (points[(i + 1) * 2 + 1] - points[i * 2 + 1]);
+        }
+    }
+}
+
+// parameters in (0, 1) where one coordinate of the curve turns around
+
+int extrema(
+    const double* points,
+    int degree,
+    int axis,
+    double* roots)
+{
+    const auto* p = points + axis;
+
+    double a, b, c;
+
+    if (degree == 2) {
+
+        a = 0;
+
+        b = p[0] - 2 * p[2] + p[4];
+
+        c = p[2] - p[0];
+    } else if (degree == 3) {
+
+        a = -p[0] + 3 * p[2] - 3 * p[4] + p[6];
+
+        b = 2 * (p[0] - 2 * p[2] + p[4]);
+
+        c = p[2] - p[0];
+    } else {
+
+        return 0;
+    }
+
+    double candidates[2];
+
+    auto candidateCount = 0;
+
+    if (std::abs(a) < 1e-12) {
+
+        if (std::abs(b) > 1e-12) {
+
+            candidates[candidateCount++] = -c / b;
+        }
+    } else {
+
+        const auto discriminant = b * b - 4 * a * c;
+
+        if (discriminant >= 0) {
+
+            const auto root = std::sqrt(discriminant);
+
+            candidates[candidateCount++] = (-b + root) / (2 * a);
+
+            candidates[candidateCount++] = (-b - root) / (2 * a);
+        }
+    }
+
+    auto count = 0;
+
+    for (auto i = 0; i < candidateCount; ++i) {
+
+        if (candidates[i] > 0 && candidates[i] < 1) {
+
+            roots[count++] = candidates[i];
+        }
+    }
+
+    return count;
+}
+
+class ClipWriter {
+public:
+    ClipWriter(
+        PathBuffer& buffer,
+        const PathRect& rect)
+        : m_buffer(buffer)
+        , m_left(rect.minX)
+        , m_top(rect.minY)
+        , m_right(rect.maxX)
+        , m_bottom(rect.maxY)
+    {
+    }
+
+    void moveTo(
+        double x,
+        double y)
+    {
+        clamp(x, y);
+
+        m_buffer.verbs.push_back(PathVerb::MoveTo);
+
+        m_buffer.coordinates.insert(m_buffer.coordinates.end(), { float(x), float(y) });
+
+        m_x = x;
+
+        m_y = y;
+
+        m_boundaryRun = false;
+    }
+
+    void close()
+    {
+        m_buffer.verbs.push_back(PathVerb::ClosePath);
+    }
+
+    void arcTo(
+        const PathBufferArc& arc,
+        double x,
+        double y)
+    {
+        m_buffer.verbs.push_back(PathVerb::ArcTo);
+
+        m_buffer.coordinates.insert(m_buffer.coordinates.end(), { float(x), float(y) });
+
+        m_buffer.arcs.push_back(arc);
+
+        m_x = x;
+
+        m_y = y;
+
+        m_boundaryRun = false;
+    }
+
+    // `points` holds the segment's start point followed by its other points
+
+    void segment(
+        const double* points,
+        int degree)
+    {
+        auto minX = points[0], maxX = points[0], minY = points[1], maxY = points[1];
+
+        for (auto i = 1; i <= degree; ++i) {
+
+            minX = std::min(minX, points[i * 2]);
+
+            maxX = std::max(maxX, points[i * 2]);
+
+            minY = std::min(minY, points[i * 2 + 1]);
+
+            maxY = std::max(maxY, points[i * 2 + 1]);
+        }
+
+        if (minX >= m_left && maxX <= m_right && minY >= m_top && maxY <= m_bottom) {
+
+            emit(points, degree);
+
+            return;
+        }
+
+        if (maxX <= m_left || minX >= m_right || maxY <= m_top || minY >= m_bottom) {
+
+            clampedLineTo(points[degree * 2], points[degree * 2 + 1]);
+
+            return;
+        }
+
+        ///
+
+        // pieces monotonic in both axes, then split where they cross an edge
+
+        double cuts[16] = { 0 };
+
+        auto cutCount = 1;
+
+        cutCount += extrema(points, degree, 0, cuts + cutCount);
+
+        cutCount += extrema(points, degree, 1, cuts + cutCount);
+
+        cuts[cutCount++] = 1;
+
+        std::sort(cuts, cuts + cutCount);
+
+        double splits[24] = { 0 };
+
+        auto splitCount = 1;
+
+        for (auto i = 0; i + 1 < cutCount; ++i) {
+
+            for (auto axis = 0; axis < 2; ++axis) {
+
+                const double edges[] = { axis == 0 ? m_left : m_top, axis == 0 ? m_right : m_bottom };
+
+                for (const auto edge : edges) {
+
+                    const auto root = crossing(points, degree, axis, cuts[i], cuts[i + 1], edge);
+
+                    if (root > 0 && splitCount < 23) {
+
+                        splits[splitCount++] = root;
+                    }
+                }
+            }
+        }
+
+        splits[splitCount++] = 1;
+
+        std::sort(splits, splits + splitCount);
+
+        ///
+
+        for (auto i = 0; i + 1 < splitCount; ++i) {
+
+            const auto t0 = splits[i], t1 = splits[i + 1];
+
+            if (t1 <= t0) {
+
+                continue;
+            }
+
+            const auto middle = (t0 + t1) / 2;
+
+            const auto x = evaluate(points, degree, 0, middle);
+
+            const auto y = evaluate(points, degree, 1, middle);
+
+            double piece[8];
+
+            std::copy(points, points + (degree + 1) * 2, piece);
+
+            splitLeft(piece, degree, t1);
+
+            splitRight(piece, degree, t0 / t1);
+
+            if (x >= m_left && x <= m_right && y >= m_top && y <= m_bottom) {
+
+                emit(piece, degree);
+            } else {
+
+                clampedLineTo(piece[degree * 2], piece[degree * 2 + 1]);
+            }
+        }
+    }
+
+private:
+    void clamp(
+        double& x,
+        double& y) const
+    {
+        x = std::clamp(x, m_left, m_right);
+
+        y = std::clamp(y, m_top, m_bottom);
+    }
+
+    // the parameter in (t0, t1) where the monotonic piece reaches `edge`, or -1
+
+    const double crossing(
+        const double* points,
+        int degree,
+        int axis,
+        double t0,
+        double t1,
+        double edge) const
+    {
+        auto v0 = evaluate(points, degree, axis, t0) - edge;
+
+        const auto v1 = evaluate(points, degree, axis, t1) - edge;
+
+        if (v0 == 0 || v1 == 0 || (v0 < 0) == (v1 < 0)) {
+
+            return -1;
+        }
+
+        if (degree == 1) {
+
+            return t0 + (t1 - t0) * v0 / (v0 - v1);
+        }
+
+        for (auto iteration = 0; iteration < 52; ++iteration) {
+
+            const auto t = (t0 + t1) / 2;
+
+            const auto v = evaluate(points, degree, axis, t) - edge;
+
+            if ((v < 0) == (v0 < 0)) {
+
+                t0 = t;
+
+                v0 = v;
+            } else {
+
+                t1 = t;
+            }
+        }
+
+        return (t0 + t1) / 2;
+    }
+
+    void emit(
+        const double* points,
+        int degree)
+    {
+        constexpr PathVerb verbs[] = { PathVerb::LineTo, PathVerb::QuadraticTo, PathVerb::CubicTo };
+
+        m_buffer.verbs.push_back(verbs[degree - 1]);
+
+        for (auto i = 1; i <= degree; ++i) {
+
+            auto x = points[i * 2], y = points[i * 2 + 1];
+
+            // crossings land on an edge up to rounding; keep them on it exactly
+
+            if (i == degree) {
+
+                clamp(x, y);
+            }
+
+            m_buffer.coordinates.insert(m_buffer.coordinates.end(), { float(x), float(y) });
+        }
+
+        m_x = std::clamp(points[degree * 2], m_left, m_right);
+
+        m_y = std::clamp(points[degree * 2 + 1], m_top, m_bottom);
+
+        m_boundaryRun = false;
+    }
+
+    // consecutive clamped lines along the same edge collapse into one
+
+    void clampedLineTo(
+        double x,
+        double y)
+    {
+        clamp(x, y);
+
+        if (x == m_x && y == m_y) {
+
+            return;
+        }
+
+        const auto alongVertical = m_runX == m_x && m_x == x && (x == m_left || x == m_right);
+
+        const auto alongHorizontal = m_runY == m_y && m_y == y && (y == m_top || y == m_bottom);
+
+        if (m_boundaryRun && (alongVertical || alongHorizontal)) {
+
+            m_buffer.coordinates[m_buffer.coordinates.size() - 2] = float(x);
+
+            m_buffer.coordinates.back() = float(y);
+        } else {
+
+            m_buffer.verbs.push_back(PathVerb::LineTo);
+
+            m_buffer.coordinates.insert(m_buffer.coordinates.end(), { float(x), float(y) });
+
+            m_runX = m_x;
+
+            m_runY = m_y;
+
+            m_boundaryRun = true;
+        }
+
+        m_x = x;
+
+        m_y = y;
+    }
+
+    PathBuffer& m_buffer;
+
+    const double m_left;
+
+    const double m_top;
+
+    const double m_right;
+
+    const double m_bottom;
+
+    double m_x = 0;
+
+    double m_y = 0;
+
+    // the start of the last clamped line, while it is still the last verb
+    bool m_boundaryRun = false;
+
+    double m_runX = 0;
+
+    double m_runY = 0;
+};
+
+struct Contour {
+    size_t verbBegin;
+    size_t verbEnd;
+    size_t coordinateBegin;
+    size_t coordinateEnd;
+    size_t arcBegin;
+    size_t arcEnd;
+};
+
+// a box around an arc's whole ellipse, with the radii scaled up as the arc
+// code scales them when they are too small to span the endpoints, so it holds
+// whichever part of the ellipse the arc draws
+
+const PathRect ellipseBounds(
+    const PathEllipse& ellipse)
+{
+    const auto halfWidth = std::hypot(ellipse.radiusX * ellipse.cosRotation, ellipse.radiusY * ellipse.sinRotation);
+
+    const auto halfHeight = std::hypot(ellipse.radiusX * ellipse.sinRotation, ellipse.radiusY * ellipse.cosRotation);
+
+    return {
+        float(ellipse.centerX - halfWidth),
+        float(ellipse.centerY - halfHeight),
+        float(ellipse.centerX + halfWidth),
+        float(ellipse.centerY + halfHeight),
+    };
+}
+
+// a box containing everything the contour can draw: control points, plus the
+// ellipse of each arc
+
+const PathRect contourBounds(
+    const PathBuffer& buffer,
+    const Contour& contour)
+{
+    auto bounds = PathRect { buffer.coordinates[contour.coordinateBegin], buffer.coordinates[contour.coordinateBegin + 1], buffer.coordinates[contour.coordinateBegin], buffer.coordinates[contour.coordinateBegin + 1] };
+
+    const auto add = [&](float x, float y, float margin) {
+        bounds.minX = std::min(bounds.minX, x - margin);
+
+        bounds.minY = std::min(bounds.minY, y - margin);
+
+        bounds.maxX = std::max(bounds.maxX, x + margin);
+
+        bounds.maxY = std::max(bounds.maxY, y + margin);
+    };
+
+    for (auto i = contour.coordinateBegin; i < contour.coordinateEnd; i += 2) {
+
+        add(buffer.coordinates[i], buffer.coordinates[i + 1], 0);
+    }
+
+    auto coordinate = contour.coordinateBegin;
+
+    auto arc = contour.arcBegin;
+
+    for (auto i = contour.verbBegin; i < contour.verbEnd; ++i) {
+
+        const auto verb = buffer.verbs[i];
+
+        if (verb == PathVerb::ArcTo) {
+
+            const auto& parameters = buffer.arcs[arc++];
+
+            const auto fromX = buffer.coordinates[coordinate - 2], fromY = buffer.coordinates[coordinate - 1];
+
+            const auto toX = buffer.coordinates[coordinate], toY = buffer.coordinates[coordinate + 1];
+
+            const auto ellipse = PathGeometry::centerArc(fromX, fromY, parameters.radiusX, parameters.radiusY, parameters.rotation, parameters.largeArc, parameters.sweep, toX, toY);
+
+            // arcs drawn as lines stay within their endpoints, already added
+
+            if (ellipse.has_value()) {
+
+                const auto reach = ellipseBounds(ellipse.value());
+
+                add(reach.minX, reach.minY, 0);
+
+                add(reach.maxX, reach.maxY, 0);
+            }
+        }
+
+        coordinate += PathVerbs::pointCount(verb) * 2;
+    }
+
+    return bounds;
+}
+
+}
+
+const PathBuffer PathClipper::clip(
+    const PathBuffer& buffer,
+    const PathRect& rect)
+{
+    PathBuffer result;
+
+    if (rect.isEmpty()) {
+
+        return result;
+    }
+
+    // contours start at each MoveTo
+
+    std::vector<Contour> contours;
+
+    size_t coordinate = 0, arc = 0;
+
+    for (size_t i = 0; i < buffer.verbs.size(); ++i) {
+
+        const auto verb = buffer.verbs[i];
+
+        if (verb == PathVerb::MoveTo) {
+
+            if (!contours.empty()) {
+
+                contours.back().verbEnd = i;
+
+                contours.back().coordinateEnd = coordinate;
+
+                contours.back().arcEnd = arc;
+            }
+
+            contours.push_back({ i, buffer.verbs.size(), coordinate, buffer.coordinates.size(), arc, buffer.arcs.size() });
+        }
+
+        coordinate += PathVerbs::pointCount(verb) * 2;
+
+        if (verb == PathVerb::ArcTo) {
+
+            ++arc;
+        }
+    }
+
+    ///
+
+    ClipWriter writer(result, rect);
+
+    std::vector<double> arcPoints;
+
+    for (const auto& contour : contours) {
+
+        const auto bounds = contourBounds(buffer, contour);
+
+        if (bounds.maxX <= rect.minX || bounds.minX >= rect.maxX || bounds.maxY <= rect.minY || bounds.minY >= rect.maxY) {
+
+            continue;
+        }
+
+        if (bounds.minX >= rect.minX && bounds.maxX <= rect.maxX && bounds.minY >= rect.minY && bounds.maxY <= rect.maxY) {
+
+            result.verbs.insert(result.verbs.end(), buffer.verbs.begin() + contour.verbBegin, buffer.verbs.begin() + contour.verbEnd);
+
+            result.coordinates.insert(result.coordinates.end(), buffer.coordinates.begin() + contour.coordinateBegin, buffer.coordinates.begin() + contour.coordinateEnd);
+
+            result.arcs.insert(result.arcs.end(), buffer.arcs.begin() + contour.arcBegin, buffer.arcs.begin() + contour.arcEnd);
+
+            continue;
+        }
+
+        ///
+
+        const auto* p = buffer.coordinates.data() + contour.coordinateBegin;
+
+        const double startX = p[0], startY = p[1];
+
+        double currentX = startX, currentY = startY;
+
+        auto closed = false;
+
+        auto arcIndex = contour.arcBegin;
+
+        writer.moveTo(startX, startY);
+
+        p += 2;
+
+        for (auto i = contour.verbBegin + 1; i < contour.verbEnd; ++i) {
+
+            const auto verb = buffer.verbs[i];
+
+            switch (verb) {
+            case PathVerb::MoveTo:
+                break;
+
+            case PathVerb::LineTo:
+            case PathVerb::QuadraticTo:
+            case PathVerb::CubicTo: {
+
+                const auto degree = PathVerbs::pointCount(verb);
+
+                double points[8] = { currentX, currentY };
+
+                for (auto j = 0; j < degree * 2; ++j) {
+
+                    points[2 + j] = p[j];
+                }
+
+                writer.segment(points, degree);
+
+                break;
+            }
+
+            case PathVerb::ArcTo: {
+
+                const auto& parameters = buffer.arcs[arcIndex++];
+
+                const auto ellipse = PathGeometry::centerArc(
+                    currentX,
+                    currentY,
+                    parameters.radiusX,
+                    parameters.radiusY,
+                    parameters.rotation,
+                    parameters.largeArc,
+                    parameters.sweep,
+                    p[0],
+                    p[1]);
+
+                if (!ellipse.has_value()) {
+
+                    const double points[] = { currentX, currentY, p[0], p[1] };
+
+                    writer.segment(points, 1);
+
+                    break;
+                }
+
+                const auto reach = ellipseBounds(ellipse.value());
+
+                if (reach.minX >= rect.minX && reach.maxX <= rect.maxX && reach.minY >= rect.minY && reach.maxY <= rect.maxY) {
+
+                    writer.arcTo(parameters, p[0], p[1]);
+
+                    break;
+                }
+
+                arcPoints.clear();
+
+                const auto cubics = PathGeometry::arcToCubics(ellipse.value(), arcPoints);
+
+                auto fromX = currentX, fromY = currentY;
+
+                for (auto j = 0; j < cubics; ++j) {
+
+                    const auto* c = arcPoints.data() + j * 6;
+
+                    const double points[] = { fromX, fromY, c[0], c[1], c[2], c[3], c[4], c[5] };
+
+                    writer.segment(points, 3);
+
+                    fromX = c[4];
+
+                    fromY = c[5];
+                }
+
+                break;
+            }
+
+            case PathVerb::ClosePath: {
+
+                closed = true;
+
+                break;
+            }
+            }
+
+            ///
+
+            const auto count = PathVerbs::pointCount(verb) * 2;
+
+            if (count > 0) {
+
+                currentX = p[count - 2];
+
+                currentY = p[count - 1];
+            }
+
+            p += count;
+        }
+
+        // the closing edge, explicit or not, is clipped like any other
+
+        if (currentX != startX || currentY != startY) {
+
+            const double points[] = { currentX, currentY, startX, startY };
+
+            writer.segment(points, 1);
+        }
+
+        if (closed) {
+
+            writer.close();
+        }
+    }
+
+    ///
+
+    return result;
+}
+
+const PathBuffer PathClipper::clip(
+    const std::vector<std::vector<PathCommand>>& subPaths,
+    const PathRect& rect)
+{
+    return PathClipper::clip(PathBufferBuilder::fromSubPaths(subPaths), rect);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "Path.h"
+#include "PathBounds.h"
+#include "PathBuffer.h"
+
+// clipping
+
+class PathClipper final {
+public:
+    // Clips a path for filling against `rect`, so later flattening and
+    // tessellation only see what is visible.
+    //
+    // Subpaths whose control points and arc ellipses miss the rect are dropped
+    // whole, and segments entirely inside or entirely beyond one edge skip all
+    // curve work. The rest are split where they cross the rect's edges (after
+    // chopping curves into pieces monotonic in x and y), inside pieces are kept
+    // as curves and outside pieces are replaced by lines between their
+    // endpoints clamped to the rect.
+    // Clamping never moves a point across the rect's interior, so the winding
+    // number of every point inside the rect, and with it the fill, is unchanged.
+    // For that reason open subpaths are closed as filling would close them.
+
+    static const PathBuffer clip(
+        const PathBuffer& buffer,
+        const PathRect& rect);
+
+    static const PathBuffer clip(
+        const std::vector<std::vector<PathCommand>>& subPaths,
+        const PathRect& rect);
+};
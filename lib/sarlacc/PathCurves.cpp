@@ -0,0 +1,782 @@
+#include "PathCurves.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "PathGeometry.h"
+
+// GPU curve data
+
+namespace {
+
+constexpr int maxQuadraticsPerCubic = 64;
+
+// a backstop; separating and settling curves normally ends far sooner
+constexpr int overlapPasses = 32;
+
+void appendLine(
+    std::vector<PathQuadratic>& quadratics,
+    double x0,
+    double y0,
+    double x2,
+    double y2)
+{
+    if (x0 == x2 && y0 == y2) {
+
+        return;
+    }
+
+    quadratics.push_back({ float(x0), float(y0), float((x0 + x2) / 2), float((y0 + y2) / 2), float(x2), float(y2) });
+}
+
+// A cubic's best single quadratic has control (3 (c1 + c2) - p0 - p3) / 4 and
+// misses by at most sqrt(3) / 36 |p3 - 3 c2 + 3 c1 - p0|; splitting into n equal
+// pieces divides that by n^3.
+
+void appendCubic(
+    std::vector<PathQuadratic>& quadratics,
+    const double* p,
+    float tolerance)
+{
+    const auto dx = p[6] - 3 * p[4] + 3 * p[2] - p[0];
+
+    const auto dy = p[7] - 3 * p[5] + 3 * p[3] - p[1];
+
+    const auto error = std::sqrt(3.0) / 36 * std::hypot(dx, dy);
+
+    const auto count = std::clamp(int(std::ceil(std::cbrt(error / tolerance))), 1, maxQuadraticsPerCubic);
+
+    ///
+
+    const auto point = [&](double t, int axis) {
+        const auto u = 1 - t;
+
+        return u * u * u * p[axis] + 3 * u * u * t * p[2 + axis] + 3 * u * t * t * p[4 + axis] + t * t * t * p[6 + axis];
+    };
+
+    const auto derivative = [&](double t, int axis) {
+        const auto u = 1 - t;
+
+        return 3 * (u * u * (p[2 + axis] - p[axis]) + 2 * u * t * (p[4 + axis] - p[2 + axis]) + t * t * (p[6 + axis] - p[4 + axis]));
+    };
+
+    for (auto i = 0; i < count; ++i) {
+
+        const auto t0 = double(i) / count, t1 = double(i + 1) / count;
+
+        const auto scale = (t1 - t0) / 3;
+
+        // the piece's own cubic control points, from the end derivatives
+
+        double piece[8];
+
+        for (auto axis = 0; axis < 2; ++axis) {
+
+            piece[axis] = point(t0, axis);
+
+            piece[2 + axis] = piece[axis] + scale * derivative(t0, axis);
+
+            piece[6 + axis] = point(t1, axis);
+
+            piece[4 + axis] = piece[6 + axis] - scale * derivative(t1, axis);
+        }
+
+        quadratics.push_back({
+            float(piece[0]),
+            float(piece[1]),
+            float((3 * (piece[2] + piece[4]) - piece[0] - piece[6]) / 4),
+            float((3 * (piece[3] + piece[5]) - piece[1] - piece[7]) / 4),
+            float(piece[6]),
+            float(piece[7]),
+        });
+    }
+}
+
+const double signedArea(
+    double ax,
+    double ay,
+    double bx,
+    double by,
+    double cx,
+    double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+const bool isCurved(
+    const PathQuadratic& q)
+{
+    const auto area = signedArea(q.x0, q.y0, q.x1, q.y1, q.x2, q.y2);
+
+    const auto chord = std::hypot(double(q.x2 - q.x0), double(q.y2 - q.y0));
+
+    return std::abs(area) > 1e-6 * std::max(chord * chord, 1e-12);
+}
+
+void halve(
+    const PathQuadratic& q,
+    PathQuadratic& first,
+    PathQuadratic& second)
+{
+    const auto ax = (q.x0 + q.x1) / 2, ay = (q.y0 + q.y1) / 2;
+
+    const auto bx = (q.x1 + q.x2) / 2, by = (q.y1 + q.y2) / 2;
+
+    const auto mx = (ax + bx) / 2, my = (ay + by) / 2;
+
+    first = { q.x0, q.y0, ax, ay, mx, my };
+
+    second = { mx, my, bx, by, q.x2, q.y2 };
+}
+
+// Separating axis test on the control triangles; touching (shared vertices or
+// edges) does not count as overlapping.
+
+const bool overlaps(
+    const PathQuadratic& a,
+    const PathQuadratic& b)
+{
+    const double pa[] = { a.x0, a.y0, a.x1, a.y1, a.x2, a.y2 };
+
+    const double pb[] = { b.x0, b.y0, b.x1, b.y1, b.x2, b.y2 };
+
+    for (const auto* triangle : { pa, pb }) {
+
+        for (auto edge = 0; edge < 3; ++edge) {
+
+            const auto next = (edge + 1) % 3;
+
+            const auto nx = -(triangle[next * 2 + 1] - triangle[edge * 2 + 1]);
+
+            const auto ny = triangle[next * 2] - triangle[edge * 2];
+
+            const auto length = std::hypot(nx, ny);
+
+            if (length == 0) {
+
+                continue;
+            }
+
+            double minA = INFINITY, maxA = -INFINITY, minB = INFINITY, maxB = -INFINITY;
+
+            for (auto i = 0; i < 3; ++i) {
+
+                const auto projectionA = (pa[i * 2] * nx + pa[i * 2 + 1] * ny) / length;
+
+                const auto projectionB = (pb[i * 2] * nx + pb[i * 2 + 1] * ny) / length;
+
+                minA = std::min(minA, projectionA);
+
+                maxA = std::max(maxA, projectionA);
+
+                minB = std::min(minB, projectionB);
+
+                maxB = std::max(maxB, projectionB);
+            }
+
+            const auto epsilon = 1e-5 * std::max({ std::abs(minA), std::abs(maxA), 1.0 });
+
+            if (maxA <= minB + epsilon || maxB <= minA + epsilon) {
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Calls `visit(i, j)` for each pair of curves whose triangles overlap,
+// sweeping over their x extents. `order` is scratch space.
+
+template <typename Visit>
+void forEachOverlap(
+    const std::vector<PathQuadratic>& curves,
+    std::vector<uint32_t>& order,
+    const Visit& visit)
+{
+    const auto minX = [&](const PathQuadratic& q) { return std::min({ q.x0, q.x1, q.x2 }); };
+
+    const auto maxX = [&](const PathQuadratic& q) { return std::max({ q.x0, q.x1, q.x2 }); };
+
+    order.resize(curves.size());
+
+    std::iota(order.begin(), order.end(), 0);
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return minX(curves[a]) < minX(curves[b]); });
+
+    for (size_t i = 0; i < order.size(); ++i) {
+
+        const auto& a = curves[order[i]];
+
+        const auto right = maxX(a);
+
+        for (auto j = i + 1; j < order.size() && minX(curves[order[j]]) < right; ++j) {
+
+            if (overlaps(a, curves[order[j]])) {
+
+                visit(order[i], order[j]);
+            }
+        }
+    }
+}
+
+const double curveArea(
+    const PathQuadratic& q)
+{
+    return std::abs(signedArea(q.x0, q.y0, q.x1, q.y1, q.x2, q.y2));
+}
+
+// How far the curve strays from its chord: half the control point's distance
+// from it.
+
+const double chordDistance(
+    const PathQuadratic& q)
+{
+    const auto chord = std::hypot(double(q.x2 - q.x0), double(q.y2 - q.y0));
+
+    if (chord == 0) {
+
+        return std::hypot(double(q.x1 - q.x0), double(q.y1 - q.y0)) / 2;
+    }
+
+    return curveArea(q) / (2 * chord);
+}
+
+void pushTriangle(
+    PathCurveMesh& mesh,
+    const PathCurveVertex& a,
+    const PathCurveVertex& b,
+    const PathCurveVertex& c)
+{
+    const auto base = uint32_t(mesh.vertices.size());
+
+    mesh.vertices.insert(mesh.vertices.end(), { a, b, c });
+
+    mesh.indices.insert(mesh.indices.end(), { base, base + 1, base + 2 });
+}
+
+}
+
+const std::vector<PathQuadratic> PathCurves::toQuadratics(
+    const PathBuffer& buffer,
+    float tolerance)
+{
+    std::vector<PathQuadratic> quadratics;
+
+    std::vector<double> arcPoints;
+
+    double currentX = 0, currentY = 0, startX = 0, startY = 0;
+
+    size_t coordinate = 0;
+
+    size_t arc = 0;
+
+    for (const auto verb : buffer.verbs) {
+
+        const auto* p = buffer.coordinates.data() + coordinate;
+
+        switch (verb) {
+        case PathVerb::MoveTo: {
+
+            appendLine(quadratics, currentX, currentY, startX, startY);
+
+            startX = p[0];
+
+            startY = p[1];
+
+            break;
+        }
+
+        case PathVerb::LineTo: {
+
+            appendLine(quadratics, currentX, currentY, p[0], p[1]);
+
+            break;
+        }
+
+        case PathVerb::QuadraticTo: {
+
+            quadratics.push_back({ float(currentX), float(currentY), p[0], p[1], p[2], p[3] });
+
+            break;
+        }
+
+        case PathVerb::CubicTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3], p[4], p[5] };
+
+            appendCubic(quadratics, points, tolerance);
+
+            break;
+        }
+
+        case PathVerb::ArcTo: {
+
+            const auto& parameters = buffer.arcs[arc++];
+
+            const auto ellipse = PathGeometry::centerArc(
+                currentX,
+                currentY,
+                parameters.radiusX,
+                parameters.radiusY,
+                parameters.rotation,
+                parameters.largeArc,
+                parameters.sweep,
+                p[0],
+                p[1]);
+
+            if (!ellipse.has_value()) {
+
+                appendLine(quadratics, currentX, currentY, p[0], p[1]);
+
+                break;
+            }
+
+            arcPoints.clear();
+
+            const auto cubics = PathGeometry::arcToCubics(ellipse.value(), arcPoints);
+
+            auto fromX = currentX, fromY = currentY;
+
+            for (auto i = 0; i < cubics; ++i) {
+
+                const auto* c = arcPoints.data() + i * 6;
+
+                const double points[] = { fromX, fromY, c[0], c[1], c[2], c[3], c[4], c[5] };
+
+                appendCubic(quadratics, points, tolerance);
+
+                fromX = c[4];
+
+                fromY = c[5];
+            }
+
+            break;
+        }
+
+        case PathVerb::ClosePath:
+            break;
+        }
+
+        ///
+
+        const auto count = PathVerbs::pointCount(verb) * 2;
+
+        if (count > 0) {
+
+            currentX = p[count - 2];
+
+            currentY = p[count - 1];
+        }
+
+        coordinate += count;
+    }
+
+    appendLine(quadratics, currentX, currentY, startX, startY);
+
+    return quadratics;
+}
+
+const PathCurveMesh PathCurves::buildMesh(
+    const std::vector<PathQuadratic>& quadratics,
+    float tolerance)
+{
+    PathCurveMesh mesh;
+
+    if (quadratics.empty()) {
+
+        mesh.solidTriangleCount = 0;
+
+        mesh.chordCurveCount = 0;
+
+        return mesh;
+    }
+
+    // curves only; lines need nothing beyond their fan triangle
+
+    std::vector<PathQuadratic> curves;
+
+    for (const auto& quadratic : quadratics) {
+
+        if (isCurved(quadratic)) {
+
+            curves.push_back(quadratic);
+        }
+    }
+
+    ///
+
+    std::vector<uint32_t> order;
+
+    std::vector<uint8_t> split;
+
+    std::vector<PathQuadratic> next;
+
+    // overlapping pairs with both curves within tolerance of their chords
+
+    std::vector<std::pair<uint32_t, uint32_t>> settled;
+
+    auto halving = true;
+
+    for (auto pass = 0; pass < overlapPasses && halving; ++pass) {
+
+        split.assign(curves.size(), 0);
+
+        settled.clear();
+
+        halving = false;
+
+        forEachOverlap(curves, order, [&](uint32_t a, uint32_t b) {
+            // halve the larger of the two that is not yet within tolerance
+
+            const auto splitA = chordDistance(curves[a]) > tolerance;
+
+            const auto splitB = chordDistance(curves[b]) > tolerance;
+
+            if (!splitA && !splitB) {
+
+                settled.emplace_back(a, b);
+
+                return;
+            }
+
+            split[splitA && (!splitB || curveArea(curves[a]) >= curveArea(curves[b])) ? a : b] = 1;
+
+            halving = true;
+        });
+
+        if (!halving) {
+
+            break;
+        }
+
+        next.clear();
+
+        for (size_t i = 0; i < curves.size(); ++i) {
+
+            if (split[i]) {
+
+                PathQuadratic first, second;
+
+                halve(curves[i], first, second);
+
+                next.push_back(first);
+
+                next.push_back(second);
+            } else {
+
+                next.push_back(curves[i]);
+            }
+        }
+
+        curves.swap(next);
+    }
+
+    if (halving) {
+
+        settled.clear();
+
+        forEachOverlap(curves, order, [&](uint32_t a, uint32_t b) { settled.emplace_back(a, b); });
+    }
+
+    // curves that cross keep overlapping however finely they are halved, so
+    // one of each pair still overlapping is drawn as its chord, by the fan
+    // alone, which keeps every remaining curve triangle disjoint
+
+    std::vector<uint8_t> asChord(curves.size(), 0);
+
+    mesh.chordCurveCount = 0;
+
+    for (const auto& [a, b] : settled) {
+
+        if (asChord[a] || asChord[b]) {
+
+            continue;
+        }
+
+        asChord[curveArea(curves[a]) >= curveArea(curves[b]) ? a : b] = 1;
+
+        ++mesh.chordCurveCount;
+    }
+
+    ///
+
+    // halving a curve changes its chords, so the fan follows the final curves and
+    // the lines
+
+    const auto anchorX = quadratics[0].x0, anchorY = quadratics[0].y0;
+
+    const auto anchor = PathCurveVertex { anchorX, anchorY, 0, 1 };
+
+    const auto fan = [&](float x0, float y0, float x2, float y2) {
+        if (signedArea(anchorX, anchorY, x0, y0, x2, y2) != 0) {
+
+            pushTriangle(mesh, anchor, { x0, y0, 0, 1 }, { x2, y2, 0, 1 });
+        }
+    };
+
+    for (const auto& quadratic : quadratics) {
+
+        if (!isCurved(quadratic)) {
+
+            fan(quadratic.x0, quadratic.y0, quadratic.x2, quadratic.y2);
+        }
+    }
+
+    for (const auto& curve : curves) {
+
+        fan(curve.x0, curve.y0, curve.x2, curve.y2);
+    }
+
+    mesh.solidTriangleCount = mesh.indices.size() / 3;
+
+    for (size_t i = 0; i < curves.size(); ++i) {
+
+        if (asChord[i]) {
+
+            continue;
+        }
+
+        const auto& curve = curves[i];
+
+        pushTriangle(mesh, { curve.x0, curve.y0, 0, 0 }, { curve.x1, curve.y1, 0.5f, 0 }, { curve.x2, curve.y2, 1, 1 });
+    }
+
+    return mesh;
+}
+
+const PathCurveBands PathCurves::buildBands(
+    const std::vector<PathQuadratic>& quadratics,
+    int bandCount)
+{
+    PathCurveBands bands;
+
+    bands.bandCount = std::max(1, bandCount);
+
+    // y-monotonic pieces, split at each curve's turning point
+
+    std::vector<PathQuadratic> pieces;
+
+    for (const auto& quadratic : quadratics) {
+
+        if (quadratic.y0 == quadratic.y2 && quadratic.y1 == quadratic.y0) {
+
+            continue;
+        }
+
+        const auto denominator = quadratic.y0 - 2 * quadratic.y1 + quadratic.y2;
+
+        const auto t = denominator != 0 ? (quadratic.y0 - quadratic.y1) / denominator : -1.0f;
+
+        if (t <= 0 || t >= 1) {
+
+            pieces.push_back(quadratic);
+
+            continue;
+        }
+
+        const auto u = 1 - t;
+
+        const auto ax = u * quadratic.x0 + t * quadratic.x1, ay = u * quadratic.y0 + t * quadratic.y1;
+
+        const auto bx = u * quadratic.x1 + t * quadratic.x2, by = u * quadratic.y1 + t * quadratic.y2;
+
+        const auto mx = u * ax + t * bx, my = u * ay + t * by;
+
+        // the turning point is an extremum, so both halves end flat there
+
+        pieces.push_back({ quadratic.x0, quadratic.y0, ax, my, mx, my });
+
+        pieces.push_back({ mx, my, bx, my, quadratic.x2, quadratic.y2 });
+    }
+
+    ///
+
+    bands.bounds = PathRect { 0, 0, 0, 0 };
+
+    if (!pieces.empty()) {
+
+        bands.bounds = PathRect { pieces[0].x0, pieces[0].y0, pieces[0].x0, pieces[0].y0 };
+
+        for (const auto& piece : pieces) {
+
+            bands.bounds.minX = std::min({ bands.bounds.minX, piece.x0, piece.x1, piece.x2 });
+
+            bands.bounds.maxX = std::max({ bands.bounds.maxX, piece.x0, piece.x1, piece.x2 });
+
+            bands.bounds.minY = std::min({ bands.bounds.minY, piece.y0, piece.y2 });
+
+            bands.bounds.maxY = std::max({ bands.bounds.maxY, piece.y0, piece.y2 });
+        }
+    }
+
+    bands.curves.reserve(pieces.size() * 6);
+
+    for (const auto& piece : pieces) {
+
+        bands.curves.insert(bands.curves.end(), { piece.x0, piece.y0, piece.x1, piece.y1, piece.x2, piece.y2 });
+    }
+
+    ///
+
+    const auto bandHeight = std::max(bands.bounds.height(), 1e-6f) / bands.bandCount;
+
+    const auto bandOf = [&](float y) {
+        return std::clamp(int(std::floor((y - bands.bounds.minY) / bandHeight)), 0, bands.bandCount - 1);
+    };
+
+    std::vector<std::vector<uint32_t>> lists(bands.bandCount);
+
+    for (size_t i = 0; i < pieces.size(); ++i) {
+
+        const auto& piece = pieces[i];
+
+        const auto first = bandOf(std::min(piece.y0, piece.y2));
+
+        const auto last = bandOf(std::max(piece.y0, piece.y2));
+
+        for (auto band = first; band <= last; ++band) {
+
+            lists[band].push_back(uint32_t(i));
+        }
+    }
+
+    bands.bandOffsets.push_back(0);
+
+    for (auto& list : lists) {
+
+        std::sort(list.begin(), list.end(), [&](uint32_t a, uint32_t b) {
+            const auto& p = pieces[a];
+
+            const auto& q = pieces[b];
+
+            return std::max({ p.x0, p.x1, p.x2 }) > std::max({ q.x0, q.x1, q.x2 });
+        });
+
+        bands.bandCurves.insert(bands.bandCurves.end(), list.begin(), list.end());
+
+        bands.bandOffsets.push_back(uint32_t(bands.bandCurves.size()));
+    }
+
+    return bands;
+}
+
+///
+
+const int PathCurves::meshWinding(
+    const PathCurveMesh& mesh,
+    float x,
+    float y)
+{
+    auto winding = 0;
+
+    for (size_t triangle = 0; triangle * 3 < mesh.indices.size(); ++triangle) {
+
+        const auto& a = mesh.vertices[mesh.indices[triangle * 3]];
+
+        const auto& b = mesh.vertices[mesh.indices[triangle * 3 + 1]];
+
+        const auto& c = mesh.vertices[mesh.indices[triangle * 3 + 2]];
+
+        const auto area = signedArea(a.x, a.y, b.x, b.y, c.x, c.y);
+
+        if (area == 0) {
+
+            continue;
+        }
+
+        // barycentric weights, all positive inside whichever way it faces
+
+        const auto wa = signedArea(x, y, b.x, b.y, c.x, c.y) / area;
+
+        const auto wb = signedArea(a.x, a.y, x, y, c.x, c.y) / area;
+
+        const auto wc = 1 - wa - wb;
+
+        if (wa < 0 || wb < 0 || wc < 0) {
+
+            continue;
+        }
+
+        const auto u = wa * a.u + wb * b.u + wc * c.u;
+
+        const auto v = wa * a.v + wb * b.v + wc * c.v;
+
+        if (u * u - v >= 0) {
+
+            continue;
+        }
+
+        winding += area > 0 ? 1 : -1;
+    }
+
+    return winding;
+}
+
+const int PathCurves::bandWinding(
+    const PathCurveBands& bands,
+    float x,
+    float y)
+{
+    if (bands.bandCurves.empty() || y < bands.bounds.minY || y > bands.bounds.maxY) {
+
+        return 0;
+    }
+
+    const auto bandHeight = std::max(bands.bounds.height(), 1e-6f) / bands.bandCount;
+
+    const auto band = std::clamp(int(std::floor((y - bands.bounds.minY) / bandHeight)), 0, bands.bandCount - 1);
+
+    auto winding = 0;
+
+    for (auto i = bands.bandOffsets[band]; i < bands.bandOffsets[band + 1]; ++i) {
+
+        const auto* c = bands.curves.data() + bands.bandCurves[i] * 6;
+
+        if (std::max({ c[0], c[2], c[4] }) <= x) {
+
+            break;
+        }
+
+        // half-open in y so that a ray through a shared endpoint counts once
+
+        const auto up = c[5] > c[1];
+
+        if (up ? (y < c[1] || y >= c[5]) : (y < c[5] || y >= c[1])) {
+
+            continue;
+        }
+
+        const double a = c[1] - 2 * c[3] + c[5], b = 2 * (c[3] - c[1]), k = c[1] - y;
+
+        double t;
+
+        if (std::abs(a) < 1e-9) {
+
+            t = -k / b;
+        } else {
+
+            const auto root = std::sqrt(std::max(0.0, b * b - 4 * a * k));
+
+            t = (-b + root) / (2 * a);
+
+            if (t < 0 || t > 1) {
+
+                t = (-b - root) / (2 * a);
+            }
+        }
+
+        const auto u = 1 - t;
+
+        const auto crossingX = u * u * c[0] + 2 * u * t * c[2] + t * t * c[4];
+
+        if (crossingX > x) {
+
+            winding += up ? 1 : -1;
+        }
+    }
+
+    return winding;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PathBounds.h"
+#include "PathBuffer.h"
+
+// GPU curve data
+
+// One quadratic Bezier: start, control, end. Lines are quadratics whose control
+// point is their midpoint.
+
+struct PathQuadratic {
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+};
+
+// 16 bytes, for a vertex descriptor of two `float2` attributes: position in path
+// units and Loop-Blinn coordinates. The fragment shader keeps a fragment when
+// u * u - v < 0; solid triangles carry (0, 1) on every vertex so they always pass.
+
+struct PathCurveVertex {
+    float x;
+    float y;
+    float u;
+    float v;
+};
+
+// Triangles for stencil-then-cover filling: each counts +1 or -1 towards the
+// winding number of the pixels it covers, by facing. The first
+// `solidTriangleCount` triangles fan from one anchor to every segment's chord;
+// the rest each add the sliver between one quadratic and its chord. No two curve
+// triangles overlap, so the curve pass may also be drawn directly with
+// antialiasing from the implicit function.
+
+struct PathCurveMesh {
+    std::vector<PathCurveVertex> vertices;
+    std::vector<uint32_t> indices;
+    size_t solidTriangleCount;
+    // curves left without a sliver, drawn as their chords; see buildMesh
+    size_t chordCurveCount;
+};
+
+// Slug-style bands. The bounds are cut into `bandCount` horizontal bands, and
+// each band lists the quadratics that reach into it, as indices into `curves`
+// (six floats per quadratic, every one monotonic in y), sorted by decreasing
+// maximum x. A fragment casts a ray towards +x through its band's curves and can
+// stop at the first curve lying entirely to its left.
+
+struct PathCurveBands {
+    PathRect bounds;
+    int bandCount;
+    std::vector<float> curves;
+    std::vector<uint32_t> bandOffsets;
+    std::vector<uint32_t> bandCurves;
+};
+
+class PathCurves final {
+public:
+    // Every contour as a closed run of quadratics, as filling closes it. Arcs go
+    // through cubics; each cubic is split evenly into as many quadratics as keep
+    // the approximation within `tolerance`.
+
+    static const std::vector<PathQuadratic> toQuadratics(
+        const PathBuffer& buffer,
+        float tolerance);
+
+    // Overlapping curve triangles are separated by halving the larger curve of
+    // each overlapping pair. Curves that cross never separate, so halving
+    // stops once both of a pair lie within `tolerance` of their chords, and one
+    // of each pair still overlapping is then drawn as its chord, counted in
+    // `chordCurveCount`; the fill moves by at most `tolerance` there.
+
+    static const PathCurveMesh buildMesh(
+        const std::vector<PathQuadratic>& quadratics,
+        float tolerance);
+
+    static const PathCurveBands buildBands(
+        const std::vector<PathQuadratic>& quadratics,
+        int bandCount);
+
+    // CPU models of the two shading schemes, returning the winding number at
+    // (x, y), so the emitted data can be checked against a reference.
+
+    static const int meshWinding(
+        const PathCurveMesh& mesh,
+        float x,
+        float y);
+
+    static const int bandWinding(
+        const PathCurveBands& bands,
+        float x,
+        float y);
+};
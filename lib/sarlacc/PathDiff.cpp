@@ -0,0 +1,1413 @@
+#include "PathDiff.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+// path diffing
+
+namespace {
+
+// Patch format, version 2:
+//
+//     patch       := version subPathOps base
+//     subPathOps  := (Keep n | Delete n | Insert n command... | Edit commandOps)... End
+//     commandOps  := (Keep n | Delete n | Insert command | Edit n gap... numbers)... End
+//     command     := header count... numbers
+//
+// Counts and gaps are LEB128 varints. Keep and Delete count entries of the
+// old path and Edit changes one, so between them they cover it exactly. A
+// command header holds the type in its low four bits, relative in bit 4 and
+// whether points, numbers and arcs are present in bits 5 to 7, and a count
+// follows for each list that is. Numbers are addressed by their index in the
+// command flattened: points, then numbers, then arcs as radius x, radius y,
+// rotation, large arc, sweep, x, y. An edit gives each changed index as the
+// gap from the one before. Numbers are four-bit characters, each ending in
+// numberEnd, padded out to a byte after a command or an edit.
+//
+// The base is a hash of the old sub paths and commands the patch deletes or
+// edits, in patch order, as eight little-endian bytes. Apply recomputes it
+// from the path it is given, so a patch made against another path fails
+// without reading more of the path than the patch changes.
+
+constexpr uint8_t patchVersion = 2;
+
+enum class PatchOp : uint8_t {
+    End,
+    Keep,
+    Delete,
+    Insert,
+    Edit,
+};
+
+constexpr char numberCharacters[] = "0123456789.-eE";
+
+// any other byte, as two more characters
+constexpr uint8_t numberEscape = 14;
+
+constexpr uint8_t numberEnd = 15;
+
+// How far the edit search goes before replacing the differing middle of two
+// sequences outright, which bounds its time and memory on unrelated paths.
+constexpr ptrdiff_t maximumEdits = 512;
+
+///
+
+class PatchWriter final {
+public:
+    void byte(
+        uint8_t value)
+    {
+        m_halfFull = false;
+
+        m_bytes.push_back(value);
+    }
+
+    void op(
+        PatchOp op)
+    {
+        byte(uint8_t(op));
+    }
+
+    void varint(
+        uint64_t value)
+    {
+        while (value >= 0x80) {
+            byte(uint8_t(value) | 0x80);
+
+            value >>= 7;
+        }
+
+        byte(uint8_t(value));
+    }
+
+    void number(
+        std::string_view source)
+    {
+        for (const auto c : source) {
+
+            const auto* found = std::char_traits<char>::find(numberCharacters, sizeof(numberCharacters) - 1, c);
+
+            if (found != nullptr) {
+
+                nibble(uint8_t(found - numberCharacters));
+            } else {
+
+                nibble(numberEscape);
+
+                nibble(uint8_t(c) >> 4);
+
+                nibble(uint8_t(c) & 15);
+            }
+        }
+
+        nibble(numberEnd);
+    }
+
+    void word(
+        uint64_t value)
+    {
+        for (auto shift = 0; shift < 64; shift += 8) {
+            byte(uint8_t(value >> shift));
+        }
+    }
+
+    std::vector<uint8_t>& bytes() { return m_bytes; }
+
+private:
+    void nibble(
+        uint8_t value)
+    {
+        if (m_halfFull) {
+
+            m_bytes.back() |= value << 4;
+
+            m_halfFull = false;
+        } else {
+
+            m_bytes.push_back(value);
+
+            m_halfFull = true;
+        }
+    }
+
+    std::vector<uint8_t> m_bytes;
+
+    bool m_halfFull = false;
+};
+
+class PatchReader final {
+public:
+    PatchReader(
+        std::span<const uint8_t> bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    const std::optional<uint8_t> byte()
+    {
+        m_halfRead = false;
+
+        if (m_position >= m_bytes.size()) {
+
+            return std::nullopt;
+        }
+
+        return m_bytes[m_position++];
+    }
+
+    const std::optional<uint64_t> varint()
+    {
+        uint64_t value = 0;
+
+        for (auto shift = 0; shift < 64; shift += 7) {
+
+            const auto next = byte();
+
+            if (!next) {
+
+                return std::nullopt;
+            }
+
+            value |= uint64_t(*next & 0x7f) << shift;
+
+            if ((*next & 0x80) == 0) {
+
+                return value;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    const std::optional<uint64_t> word()
+    {
+        uint64_t value = 0;
+
+        for (auto shift = 0; shift < 64; shift += 8) {
+
+            const auto next = byte();
+
+            if (!next) {
+
+                return std::nullopt;
+            }
+
+            value |= uint64_t(*next) << shift;
+        }
+
+        return value;
+    }
+
+    // Reads one number's characters into `text`; false if the patch ends
+    // first.
+
+    const bool number(
+        std::string& text)
+    {
+        text.clear();
+
+        while (true) {
+
+            const auto next = nibble();
+
+            if (!next || *next == numberEnd) {
+
+                return next.has_value();
+            }
+
+            if (*next != numberEscape) {
+
+                text += numberCharacters[*next];
+
+                continue;
+            }
+
+            const auto high = nibble();
+
+            const auto low = nibble();
+
+            if (!high || !low) {
+
+                return false;
+            }
+
+            text += char((*high << 4) | *low);
+        }
+    }
+
+    const size_t remaining() const { return m_bytes.size() - m_position; }
+
+    const int position() const { return int(m_position); }
+
+private:
+    const std::optional<uint8_t> nibble()
+    {
+        if (m_halfRead) {
+
+            m_halfRead = false;
+
+            return m_bytes[m_position - 1] >> 4;
+        }
+
+        if (m_position >= m_bytes.size()) {
+
+            return std::nullopt;
+        }
+
+        m_halfRead = true;
+
+        return m_bytes[m_position++] & 15;
+    }
+
+    std::span<const uint8_t> m_bytes;
+
+    size_t m_position = 0;
+
+    bool m_halfRead = false;
+};
+
+///
+
+template <typename T>
+const size_t numberCount(
+    const BasicPathCommand<T>& command)
+{
+    return (command.points ? command.points->size() * 2 : 0)
+        + (command.numbers ? command.numbers->size() : 0)
+        + (command.arcs ? command.arcs->size() * 7 : 0);
+}
+
+// The `index`th number of a command in patch order; `Command` may be const.
+
+template <typename Command>
+auto& numberAt(
+    Command& command,
+    size_t index)
+{
+    const auto pointNumbers = command.points ? command.points->size() * 2 : 0;
+
+    if (index < pointNumbers) {
+
+        auto& point = (*command.points)[index / 2];
+
+        return index % 2 == 0 ? point.x : point.y;
+    }
+
+    index -= pointNumbers;
+
+    const auto numbers = command.numbers ? command.numbers->size() : 0;
+
+    if (index < numbers) {
+
+        return (*command.numbers)[index];
+    }
+
+    index -= numbers;
+
+    auto& [radii, rotation, flags, end] = (*command.arcs)[index / 7];
+
+    switch (index % 7) {
+    case 0:
+        return radii.x;
+    case 1:
+        return radii.y;
+    case 2:
+        return rotation;
+    case 3:
+        return flags.x;
+    case 4:
+        return flags.y;
+    case 5:
+        return end.x;
+    default:
+        return end.y;
+    }
+}
+
+// Same type, position and list lengths, so one can become the other by
+// changing numbers alone.
+
+template <typename T>
+const bool sameShape(
+    const BasicPathCommand<T>& a,
+    const BasicPathCommand<T>& b)
+{
+    const auto sameLength = [](const auto& x, const auto& y) {
+        return x.has_value() == y.has_value() && (!x || x->size() == y->size());
+    };
+
+    return a.type == b.type
+        && a.position == b.position
+        && sameLength(a.points, b.points)
+        && sameLength(a.numbers, b.numbers)
+        && sameLength(a.arcs, b.arcs);
+}
+
+template <typename T>
+const bool sameCommand(
+    const BasicPathCommand<T>& a,
+    const BasicPathCommand<T>& b)
+{
+    if (!sameShape(a, b)) {
+
+        return false;
+    }
+
+    const auto count = numberCount(a);
+
+    for (size_t i = 0; i < count; ++i) {
+
+        if (numberAt(a, i).source != numberAt(b, i).source) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// FNV-1a
+
+constexpr uint64_t hashSeed = 0xcbf29ce484222325ull;
+
+const uint64_t hashBytes(
+    uint64_t hash,
+    std::string_view bytes)
+{
+    for (const auto c : bytes) {
+
+        hash = (hash ^ uint8_t(c)) * 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+template <typename T>
+const uint64_t hashCommand(
+    const BasicPathCommand<T>& command)
+{
+    const char shape[] = {
+        char(command.type),
+        char(command.position),
+        char(command.points ? command.points->size() + 1 : 0),
+        char(command.numbers ? command.numbers->size() + 1 : 0),
+        char(command.arcs ? command.arcs->size() + 1 : 0),
+    };
+
+    auto hash = hashBytes(hashSeed, std::string_view(shape, sizeof(shape)));
+
+    const auto count = numberCount(command);
+
+    for (size_t i = 0; i < count; ++i) {
+
+        hash = hashBytes(hash, numberAt(command, i).source);
+
+        hash = hashBytes(hash, ",");
+    }
+
+    return hash;
+}
+
+const uint64_t combineHash(
+    uint64_t hash,
+    uint64_t value)
+{
+    return (hash ^ value) * 0x100000001b3ull;
+}
+
+template <typename T>
+const uint64_t hashSubPath(
+    const std::vector<BasicPathCommand<T>>& commands)
+{
+    auto hash = hashSeed;
+
+    for (const auto& command : commands) {
+
+        hash = combineHash(hash, hashCommand(command));
+    }
+
+    return hash;
+}
+
+///
+
+struct EditRun {
+    PatchOp op;
+    size_t count;
+};
+
+void pushRun(
+    std::vector<EditRun>& runs,
+    PatchOp op,
+    size_t count)
+{
+    if (count == 0) {
+
+        return;
+    }
+
+    if (!runs.empty() && runs.back().op == op) {
+
+        runs.back().count += count;
+
+        return;
+    }
+
+    runs.push_back({ op, count });
+}
+
+// Myers' shortest edit script between `from` and `to` elements, as Keep,
+// Delete and Insert runs, or std::nullopt past maximumEdits edits.
+
+template <typename Equal>
+const std::optional<std::vector<EditRun>> shortestEdit(
+    size_t from,
+    size_t to,
+    const Equal& equal)
+{
+    const auto n = ptrdiff_t(from);
+
+    const auto m = ptrdiff_t(to);
+
+    const auto limit = std::min(n + m, maximumEdits);
+
+    const auto offset = limit + 1;
+
+    // furthest x reached on each diagonal k = x - y
+
+    std::vector<ptrdiff_t> furthest(size_t(2 * limit + 3), 0);
+
+    // the diagonals -d - 1 to d + 1 of `furthest` as they stood before each
+    // round d, to walk the path back
+
+    std::vector<std::vector<ptrdiff_t>> trace;
+
+    for (ptrdiff_t d = 0; d <= limit; ++d) {
+
+        trace.emplace_back(furthest.begin() + (offset - d - 1), furthest.begin() + (offset + d + 2));
+
+        for (auto k = -d; k <= d; k += 2) {
+
+            const auto down = k == -d || (k != d && furthest[offset + k - 1] < furthest[offset + k + 1]);
+
+            auto x = down ? furthest[offset + k + 1] : furthest[offset + k - 1] + 1;
+
+            auto y = x - k;
+
+            while (x < n && y < m && equal(size_t(x), size_t(y))) {
+
+                ++x;
+
+                ++y;
+            }
+
+            furthest[offset + k] = x;
+
+            if (x < n || y < m) {
+
+                continue;
+            }
+
+            ///
+
+            std::vector<PatchOp> steps;
+
+            x = n;
+
+            y = m;
+
+            for (auto step = d; step >= 0; --step) {
+
+                const auto& before = trace[step];
+
+                const auto at = [&](ptrdiff_t diagonal) { return before[diagonal + step + 1]; };
+
+                const auto diagonal = x - y;
+
+                const auto previous = (diagonal == -step || (diagonal != step && at(diagonal - 1) < at(diagonal + 1))) ? diagonal + 1 : diagonal - 1;
+
+                const auto previousX = at(previous);
+
+                const auto previousY = previousX - previous;
+
+                while (x > previousX && y > previousY) {
+
+                    steps.push_back(PatchOp::Keep);
+
+                    --x;
+
+                    --y;
+                }
+
+                if (step > 0) {
+
+                    steps.push_back(x == previousX ? PatchOp::Insert : PatchOp::Delete);
+                }
+
+                x = previousX;
+
+                y = previousY;
+            }
+
+            std::vector<EditRun> runs;
+
+            for (auto i = steps.rbegin(); i != steps.rend(); ++i) {
+
+                pushRun(runs, *i, 1);
+            }
+
+            return runs;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Edit runs turning `from` elements into `to`, with the common ends matched
+// directly, which is all most edits need.
+
+template <typename Equal>
+const std::vector<EditRun> align(
+    size_t from,
+    size_t to,
+    const Equal& equal)
+{
+    size_t prefix = 0;
+
+    while (prefix < from && prefix < to && equal(prefix, prefix)) {
+
+        ++prefix;
+    }
+
+    size_t suffix = 0;
+
+    while (suffix < from - prefix && suffix < to - prefix && equal(from - 1 - suffix, to - 1 - suffix)) {
+
+        ++suffix;
+    }
+
+    std::vector<EditRun> runs;
+
+    pushRun(runs, PatchOp::Keep, prefix);
+
+    const auto middleFrom = from - prefix - suffix;
+
+    const auto middleTo = to - prefix - suffix;
+
+    const auto middle = shortestEdit(middleFrom, middleTo, [&](size_t i, size_t j) { return equal(prefix + i, prefix + j); });
+
+    if (middle) {
+
+        for (const auto& run : *middle) {
+
+            pushRun(runs, run.op, run.count);
+        }
+    } else {
+
+        pushRun(runs, PatchOp::Delete, middleFrom);
+
+        pushRun(runs, PatchOp::Insert, middleTo);
+    }
+
+    pushRun(runs, PatchOp::Keep, suffix);
+
+    return runs;
+}
+
+// Walks `runs`, pairing each stretch of deleted and inserted elements up
+// front to back: `keep(count)`, `edit(from, to)` for each pair, then
+// `remove(from, count)` and `insert(to, count)` for what is left over.
+
+template <typename Keep, typename Edit, typename Remove, typename Insert>
+void walkRuns(
+    const std::vector<EditRun>& runs,
+    const Keep& keep,
+    const Edit& edit,
+    const Remove& remove,
+    const Insert& insert)
+{
+    size_t from = 0;
+
+    size_t to = 0;
+
+    for (size_t i = 0; i < runs.size();) {
+
+        if (runs[i].op == PatchOp::Keep) {
+
+            keep(runs[i].count);
+
+            from += runs[i].count;
+
+            to += runs[i].count;
+
+            ++i;
+
+            continue;
+        }
+
+        size_t deleted = 0;
+
+        size_t inserted = 0;
+
+        for (; i < runs.size() && runs[i].op != PatchOp::Keep; ++i) {
+
+            (runs[i].op == PatchOp::Delete ? deleted : inserted) += runs[i].count;
+        }
+
+        const auto paired = std::min(deleted, inserted);
+
+        for (size_t p = 0; p < paired; ++p) {
+
+            edit(from + p, to + p);
+        }
+
+        if (deleted > paired) {
+
+            remove(from + paired, deleted - paired);
+        }
+
+        if (inserted > paired) {
+
+            insert(to + paired, inserted - paired);
+        }
+
+        from += deleted;
+
+        to += inserted;
+    }
+}
+
+///
+
+template <typename T>
+void writeCommand(
+    PatchWriter& writer,
+    const BasicPathCommand<T>& command)
+{
+    writer.byte(uint8_t(command.type)
+        | (command.position == PathCommandPosition::Relative ? 0x10 : 0)
+        | (command.points ? 0x20 : 0)
+        | (command.numbers ? 0x40 : 0)
+        | (command.arcs ? 0x80 : 0));
+
+    if (command.points) {
+
+        writer.varint(command.points->size());
+    }
+
+    if (command.numbers) {
+
+        writer.varint(command.numbers->size());
+    }
+
+    if (command.arcs) {
+
+        writer.varint(command.arcs->size());
+    }
+
+    const auto count = numberCount(command);
+
+    for (size_t i = 0; i < count; ++i) {
+
+        writer.number(numberAt(command, i).source);
+    }
+}
+
+template <typename T>
+void writeCommandOps(
+    PatchWriter& writer,
+    const std::vector<BasicPathCommand<T>>& from,
+    const std::vector<BasicPathCommand<T>>& to,
+    uint64_t& base)
+{
+    std::vector<uint64_t> fromHashes;
+
+    std::vector<uint64_t> toHashes;
+
+    for (const auto& command : from) {
+
+        fromHashes.push_back(hashCommand(command));
+    }
+
+    for (const auto& command : to) {
+
+        toHashes.push_back(hashCommand(command));
+    }
+
+    const auto runs = align(from.size(), to.size(), [&](size_t i, size_t j) {
+        return fromHashes[i] == toHashes[j] && sameCommand(from[i], to[j]);
+    });
+
+    const auto keep = [&](size_t count) {
+        writer.op(PatchOp::Keep);
+
+        writer.varint(count);
+    };
+
+    const auto remove = [&](size_t index, size_t count) {
+        writer.op(PatchOp::Delete);
+
+        writer.varint(count);
+
+        for (auto i = index; i < index + count; ++i) {
+
+            base = combineHash(base, hashCommand(from[i]));
+        }
+    };
+
+    const auto insert = [&](size_t index, size_t count) {
+        for (auto i = index; i < index + count; ++i) {
+
+            writer.op(PatchOp::Insert);
+
+            writeCommand(writer, to[i]);
+        }
+    };
+
+    const auto edit = [&](size_t i, size_t j) {
+        if (!sameShape(from[i], to[j])) {
+
+            remove(i, 1);
+
+            insert(j, 1);
+
+            return;
+        }
+
+        base = combineHash(base, hashCommand(from[i]));
+
+        std::vector<size_t> changed;
+
+        const auto count = numberCount(from[i]);
+
+        for (size_t index = 0; index < count; ++index) {
+
+            if (numberAt(from[i], index).source != numberAt(to[j], index).source) {
+
+                changed.push_back(index);
+            }
+        }
+
+        writer.op(PatchOp::Edit);
+
+        writer.varint(changed.size());
+
+        size_t next = 0;
+
+        for (const auto index : changed) {
+
+            writer.varint(index - next);
+
+            next = index + 1;
+        }
+
+        for (const auto index : changed) {
+
+            writer.number(numberAt(to[j], index).source);
+        }
+    };
+
+    walkRuns(runs, keep, edit, remove, insert);
+
+    writer.op(PatchOp::End);
+}
+
+///
+
+template <typename T>
+struct CommandPatch {
+    PatchOp op;
+    size_t count;
+    std::optional<BasicPathCommand<T>> command;
+    std::vector<std::tuple<size_t, BasicPathNumber<T>>> numbers;
+};
+
+template <typename T>
+struct SubPathPatch {
+    PatchOp op;
+    size_t count;
+    std::vector<BasicPathCommand<T>> commands;
+    std::vector<CommandPatch<T>> edits;
+};
+
+const Error patchError(
+    const PatchReader& reader,
+    const char* message)
+{
+    return Error(ErrorType::Parser, ErrorCode::InvalidPatch, message, SourceLocation(reader.position()));
+}
+
+template <typename T>
+const std::tuple<std::optional<BasicPathNumber<T>>, std::optional<Error>> readNumber(
+    PatchReader& reader)
+{
+    std::string text;
+
+    if (!reader.number(text)) {
+
+        return { std::nullopt, patchError(reader, "patch ends inside a number") };
+    }
+
+    const auto value = PathScalar<T>::fromChars(text);
+
+    if (!value) {
+
+        return { std::nullopt, patchError(reader, "patch number does not convert") };
+    }
+
+    return { BasicPathNumber<T> { *value, std::move(text) }, std::nullopt };
+}
+
+template <typename T>
+const std::tuple<std::optional<BasicPathCommand<T>>, std::optional<Error>> readCommand(
+    PatchReader& reader)
+{
+    const auto header = reader.byte();
+
+    if (!header || (*header & 15) > uint8_t(PathCommandType::EllipticalArc)) {
+
+        return { std::nullopt, patchError(reader, "expected a command header in patch") };
+    }
+
+    BasicPathCommand<T> command {
+        PathCommandType(*header & 15),
+        (*header & 0x10) != 0 ? PathCommandPosition::Relative : PathCommandPosition::Absolute,
+        std::nullopt,
+        std::nullopt,
+        std::nullopt,
+    };
+
+    // every number takes at least a byte's worth of characters, which bounds
+    // what a corrupt count can make us allocate
+
+    auto budget = reader.remaining() * 2;
+
+    const auto readCount = [&](uint8_t bit, size_t numbersEach) -> std::optional<size_t> {
+        if ((*header & bit) == 0) {
+
+            return 0;
+        }
+
+        const auto count = reader.varint();
+
+        if (!count || *count > budget / numbersEach) {
+
+            return std::nullopt;
+        }
+
+        budget -= *count * numbersEach;
+
+        return size_t(*count);
+    };
+
+    const auto points = readCount(0x20, 2);
+
+    const auto numbers = readCount(0x40, 1);
+
+    const auto arcs = readCount(0x80, 7);
+
+    if (!points || !numbers || !arcs) {
+
+        return { std::nullopt, patchError(reader, "invalid command list length in patch") };
+    }
+
+    if ((*header & 0x20) != 0) {
+
+        command.points.emplace(*points);
+    }
+
+    if ((*header & 0x40) != 0) {
+
+        command.numbers.emplace(*numbers);
+    }
+
+    if ((*header & 0x80) != 0) {
+
+        command.arcs.emplace(*arcs);
+    }
+
+    const auto count = numberCount(command);
+
+    for (size_t i = 0; i < count; ++i) {
+
+        auto [number, error] = readNumber<T>(reader);
+
+        if (error) {
+
+            return { std::nullopt, error };
+        }
+
+        numberAt(command, i) = std::move(*number);
+    }
+
+    return { std::move(command), std::nullopt };
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<CommandPatch<T>>>, std::optional<Error>> readCommandOps(
+    PatchReader& reader,
+    const std::vector<BasicPathCommand<T>>& commands,
+    uint64_t& base)
+{
+    std::vector<CommandPatch<T>> ops;
+
+    size_t index = 0;
+
+    while (true) {
+
+        const auto op = reader.byte();
+
+        if (!op) {
+
+            return { std::nullopt, patchError(reader, "patch ends inside a sub path edit") };
+        }
+
+        switch (PatchOp(*op)) {
+        case PatchOp::End:
+            if (index != commands.size()) {
+
+                return { std::nullopt, patchError(reader, "patch does not cover every command of the sub path") };
+            }
+
+            return { std::move(ops), std::nullopt };
+
+        case PatchOp::Keep:
+        case PatchOp::Delete: {
+            const auto count = reader.varint();
+
+            if (!count || *count > commands.size() - index) {
+
+                return { std::nullopt, patchError(reader, "patch runs past the end of the sub path") };
+            }
+
+            if (PatchOp(*op) == PatchOp::Delete) {
+
+                for (auto i = index; i < index + *count; ++i) {
+
+                    base = combineHash(base, hashCommand(commands[i]));
+                }
+            }
+
+            ops.push_back({ PatchOp(*op), size_t(*count), std::nullopt, { } });
+
+            index += *count;
+
+            break;
+        }
+
+        case PatchOp::Insert: {
+            auto [command, error] = readCommand<T>(reader);
+
+            if (error) {
+
+                return { std::nullopt, error };
+            }
+
+            ops.push_back({ PatchOp::Insert, 0, std::move(command), { } });
+
+            break;
+        }
+
+        case PatchOp::Edit: {
+            const auto changes = reader.varint();
+
+            if (index >= commands.size() || !changes) {
+
+                return { std::nullopt, patchError(reader, "invalid command edit in patch") };
+            }
+
+            base = combineHash(base, hashCommand(commands[index]));
+
+            const auto count = numberCount(commands[index]);
+
+            if (*changes > count) {
+
+                return { std::nullopt, patchError(reader, "invalid command edit in patch") };
+            }
+
+            CommandPatch<T> edit { PatchOp::Edit, 0, std::nullopt, { } };
+
+            std::vector<size_t> indices;
+
+            size_t next = 0;
+
+            for (uint64_t i = 0; i < *changes; ++i) {
+
+                const auto gap = reader.varint();
+
+                if (!gap || *gap >= count - next) {
+
+                    return { std::nullopt, patchError(reader, "patch edits a number the command does not have") };
+                }
+
+                indices.push_back(next + *gap);
+
+                next += *gap + 1;
+            }
+
+            for (const auto number : indices) {
+
+                auto [value, error] = readNumber<T>(reader);
+
+                if (error) {
+
+                    return { std::nullopt, error };
+                }
+
+                edit.numbers.emplace_back(number, std::move(*value));
+            }
+
+            ops.push_back(std::move(edit));
+
+            ++index;
+
+            break;
+        }
+
+        default:
+            return { std::nullopt, patchError(reader, "unknown patch operation") };
+        }
+    }
+}
+
+template <typename T>
+const std::tuple<std::optional<std::vector<SubPathPatch<T>>>, std::optional<Error>> readSubPathOps(
+    PatchReader& reader,
+    const std::vector<std::vector<BasicPathCommand<T>>>& subPaths,
+    uint64_t& base)
+{
+    std::vector<SubPathPatch<T>> ops;
+
+    size_t index = 0;
+
+    while (true) {
+
+        const auto op = reader.byte();
+
+        if (!op) {
+
+            return { std::nullopt, patchError(reader, "patch ends before its end marker") };
+        }
+
+        switch (PatchOp(*op)) {
+        case PatchOp::End:
+            if (index != subPaths.size()) {
+
+                return { std::nullopt, patchError(reader, "patch does not cover every sub path") };
+            }
+
+            return { std::move(ops), std::nullopt };
+
+        case PatchOp::Keep:
+        case PatchOp::Delete: {
+            const auto count = reader.varint();
+
+            if (!count || *count > subPaths.size() - index) {
+
+                return { std::nullopt, patchError(reader, "patch runs past the last sub path") };
+            }
+
+            if (PatchOp(*op) == PatchOp::Delete) {
+
+                for (auto i = index; i < index + *count; ++i) {
+
+                    base = combineHash(base, hashSubPath(subPaths[i]));
+                }
+            }
+
+            ops.push_back({ PatchOp(*op), size_t(*count), { }, { } });
+
+            index += *count;
+
+            break;
+        }
+
+        case PatchOp::Insert: {
+            const auto count = reader.varint();
+
+            // a command is at least a byte
+
+            if (!count || *count > reader.remaining()) {
+
+                return { std::nullopt, patchError(reader, "invalid sub path length in patch") };
+            }
+
+            SubPathPatch<T> insert { PatchOp::Insert, 0, { }, { } };
+
+            insert.commands.reserve(*count);
+
+            for (uint64_t i = 0; i < *count; ++i) {
+
+                auto [command, error] = readCommand<T>(reader);
+
+                if (error) {
+
+                    return { std::nullopt, error };
+                }
+
+                insert.commands.push_back(std::move(*command));
+            }
+
+            ops.push_back(std::move(insert));
+
+            break;
+        }
+
+        case PatchOp::Edit: {
+            if (index >= subPaths.size()) {
+
+                return { std::nullopt, patchError(reader, "patch edits a sub path past the last") };
+            }
+
+            auto [edits, error] = readCommandOps<T>(reader, subPaths[index], base);
+
+            if (error) {
+
+                return { std::nullopt, error };
+            }
+
+            ops.push_back({ PatchOp::Edit, 0, { }, std::move(*edits) });
+
+            ++index;
+
+            break;
+        }
+
+        default:
+            return { std::nullopt, patchError(reader, "unknown patch operation") };
+        }
+    }
+}
+
+// not const, so the result moves into place
+
+template <typename T>
+std::vector<BasicPathCommand<T>> applyCommandOps(
+    std::vector<BasicPathCommand<T>>&& commands,
+    std::vector<CommandPatch<T>>& ops)
+{
+    std::vector<BasicPathCommand<T>> out;
+
+    out.reserve(commands.size());
+
+    size_t index = 0;
+
+    for (auto& op : ops) {
+
+        switch (op.op) {
+        case PatchOp::Keep:
+            std::move(commands.begin() + index, commands.begin() + index + op.count, std::back_inserter(out));
+
+            index += op.count;
+
+            break;
+
+        case PatchOp::Delete:
+            index += op.count;
+
+            break;
+
+        case PatchOp::Insert:
+            out.push_back(std::move(*op.command));
+
+            break;
+
+        default: {
+            auto& command = out.emplace_back(std::move(commands[index]));
+
+            for (auto& [number, value] : op.numbers) {
+
+                numberAt(command, number) = std::move(value);
+            }
+
+            ++index;
+
+            break;
+        }
+        }
+    }
+
+    return out;
+}
+
+}
+
+///
+
+template <typename T>
+const std::vector<uint8_t> BasicPathDiff<T>::diff(
+    const std::vector<std::vector<BasicPathCommand<T>>>& from,
+    const std::vector<std::vector<BasicPathCommand<T>>>& to)
+{
+    std::vector<uint64_t> fromHashes;
+
+    std::vector<uint64_t> toHashes;
+
+    for (const auto& commands : from) {
+
+        fromHashes.push_back(hashSubPath<T>(commands));
+    }
+
+    for (const auto& commands : to) {
+
+        toHashes.push_back(hashSubPath<T>(commands));
+    }
+
+    const auto runs = align(from.size(), to.size(), [&](size_t i, size_t j) {
+        return fromHashes[i] == toHashes[j]
+            && from[i].size() == to[j].size()
+            && std::equal(from[i].begin(), from[i].end(), to[j].begin(), sameCommand<T>);
+    });
+
+    ///
+
+    PatchWriter writer;
+
+    writer.byte(patchVersion);
+
+    auto base = hashSeed;
+
+    const auto keep = [&](size_t count) {
+        writer.op(PatchOp::Keep);
+
+        writer.varint(count);
+    };
+
+    const auto edit = [&](size_t i, size_t j) {
+        writer.op(PatchOp::Edit);
+
+        writeCommandOps(writer, from[i], to[j], base);
+    };
+
+    const auto remove = [&](size_t index, size_t count) {
+        writer.op(PatchOp::Delete);
+
+        writer.varint(count);
+
+        for (auto i = index; i < index + count; ++i) {
+
+            base = combineHash(base, fromHashes[i]);
+        }
+    };
+
+    const auto insert = [&](size_t index, size_t count) {
+        for (auto i = index; i < index + count; ++i) {
+
+            writer.op(PatchOp::Insert);
+
+            writer.varint(to[i].size());
+
+            for (const auto& command : to[i]) {
+
+                writeCommand(writer, command);
+            }
+        }
+    };
+
+    walkRuns(runs, keep, edit, remove, insert);
+
+    writer.op(PatchOp::End);
+
+    writer.word(base);
+
+    return std::move(writer.bytes());
+}
+
+template <typename T>
+const std::optional<Error> BasicPathDiff<T>::apply(
+    std::vector<std::vector<BasicPathCommand<T>>>& subPaths,
+    std::span<const uint8_t> patch)
+{
+    // the whole patch is read and checked against `subPaths` before anything
+    // is moved, so a bad one changes nothing
+
+    PatchReader reader(patch);
+
+    const auto version = reader.byte();
+
+    if (!version || *version != patchVersion) {
+
+        return patchError(reader, "unsupported patch version");
+    }
+
+    auto base = hashSeed;
+
+    auto [ops, error] = readSubPathOps<T>(reader, subPaths, base);
+
+    if (error) {
+
+        return error;
+    }
+
+    const auto expected = reader.word();
+
+    if (!expected) {
+
+        return patchError(reader, "patch ends before its base hash");
+    }
+
+    if (*expected != base) {
+
+        return patchError(reader, "patch was made against another path");
+    }
+
+    if (reader.remaining() != 0) {
+
+        return patchError(reader, "unexpected bytes after patch");
+    }
+
+    ///
+
+    std::vector<std::vector<BasicPathCommand<T>>> out;
+
+    out.reserve(subPaths.size());
+
+    size_t index = 0;
+
+    for (auto& op : *ops) {
+
+        switch (op.op) {
+        case PatchOp::Keep:
+            std::move(subPaths.begin() + index, subPaths.begin() + index + op.count, std::back_inserter(out));
+
+            index += op.count;
+
+            break;
+
+        case PatchOp::Delete:
+            index += op.count;
+
+            break;
+
+        case PatchOp::Insert:
+            out.push_back(std::move(op.commands));
+
+            break;
+
+        default:
+            out.push_back(applyCommandOps(std::move(subPaths[index]), op.edits));
+
+            ++index;
+
+            break;
+        }
+    }
+
+    subPaths = std::move(out);
+
+    return std::nullopt;
+}
+
+///
+
+template class BasicPathDiff<float>;
+
+template class BasicPathDiff<double>;
+
+template class BasicPathDiff<Fixed16_16>;
+
+template class BasicPathDiff<Fixed24_8>;
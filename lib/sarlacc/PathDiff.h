@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Error.h"
+#include "Path.h"
+#include "PathScalar.h"
+
+// path diffing
+
+// Structural patches between two parsed paths, for sending an edit to peers
+// that already hold the old path instead of the whole new `d` string.
+//
+// Sub paths are aligned first and commands within each changed sub path
+// next, both by the shortest edit between the two sequences, so moving,
+// inserting or deleting a sub path leaves the rest untouched. Where a command
+// keeps its shape and only its numbers change, just those numbers are sent.
+// Numbers compare and travel as their source text, four bits a character, and
+// are converted on arrival exactly as the parser would have, so a patched
+// path equals a fresh parse of the new source and only changed numbers are
+// converted. Patch size and apply time follow the size of the change rather
+// than of the path.
+
+template <typename T>
+class BasicPathDiff final {
+public:
+    static const std::vector<uint8_t> diff(
+        const std::vector<std::vector<BasicPathCommand<T>>>& from,
+        const std::vector<std::vector<BasicPathCommand<T>>>& to);
+
+    // Patches `subPaths`, which must equal the `from` the patch was made
+    // against, in place, moving untouched sub paths and commands rather than
+    // copying them. A malformed patch, or one that does not fit `subPaths`,
+    // is an InvalidPatch error and leaves `subPaths` as it was.
+    //
+    // The sub paths and commands a patch deletes or edits are checked against
+    // a hash of the ones it was made from, so a patch for another path fails.
+    // Those it keeps are only counted, not read, which keeps apply in time
+    // with the change; paths differing only there are not told apart.
+
+    static const std::optional<Error> apply(
+        std::vector<std::vector<BasicPathCommand<T>>>& subPaths,
+        std::span<const uint8_t> patch);
+};
+
+using PathDiff = BasicPathDiff<float>;
+
+extern template class BasicPathDiff<float>;
+
+extern template class BasicPathDiff<double>;
+
+extern template class BasicPathDiff<Fixed16_16>;
+
+extern template class BasicPathDiff<Fixed24_8>;
@@ -0,0 +1,585 @@
+#include "PathDistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Parallel.h"
+#include "PathFlattener.h"
+
+// distance fields
+
+namespace {
+
+enum EdgeColor : uint8_t {
+    Red = 1,
+    Green = 2,
+    Blue = 4,
+    Cyan = Green | Blue,
+    Magenta = Red | Blue,
+    Yellow = Red | Green,
+    White = Red | Green | Blue,
+};
+
+struct Edge {
+    float ax;
+    float ay;
+    float bx;
+    float by;
+    uint32_t segment;
+    uint8_t color;
+    bool segmentStart;
+    bool segmentEnd;
+};
+
+struct Crossing {
+    float x;
+    int direction;
+};
+
+// two unit directions meet at a corner unless they continue almost straight on
+
+bool isCorner(
+    float ax,
+    float ay,
+    float bx,
+    float by)
+{
+    const auto dot = ax * bx + ay * by;
+
+    const auto cross = ax * by - ay * bx;
+
+    return dot <= 0 || std::abs(cross) > 0.14112f;
+}
+
+void edgeDirection(
+    const Edge& edge,
+    float& x,
+    float& y)
+{
+    const auto dx = edge.bx - edge.ax;
+
+    const auto dy = edge.by - edge.ay;
+
+    const auto length = std::hypot(dx, dy);
+
+    x = dx / length;
+
+    y = dy / length;
+}
+
+// Edge colouring after msdfgen's simple strategy: segments meeting at a corner
+// must not share two channels, so each channel's nearest edge keeps the corner
+// sharp, while smooth joins can share a colour.
+
+void colorContour(
+    Edge* edges,
+    size_t count)
+{
+    std::vector<size_t> groupStarts;
+
+    for (size_t i = 0; i < count; ++i) {
+
+        if (edges[i].segmentStart) {
+
+            groupStarts.push_back(i);
+        }
+    }
+
+    if (groupStarts.empty()) {
+
+        return;
+    }
+
+    ///
+
+    const auto groups = groupStarts.size();
+
+    const auto groupEnd = [&](size_t group) {
+        return group + 1 < groups ? groupStarts[group + 1] : count;
+    };
+
+    std::vector<size_t> corners;
+
+    for (size_t group = 0; group < groups; ++group) {
+
+        const auto& previous = edges[groupEnd((group + groups - 1) % groups) - 1];
+
+        const auto& first = edges[groupStarts[group]];
+
+        float ax, ay, bx, by;
+
+        edgeDirection(previous, ax, ay);
+
+        edgeDirection(first, bx, by);
+
+        if (isCorner(ax, ay, bx, by)) {
+
+            corners.push_back(group);
+        }
+    }
+
+    ///
+
+    std::vector<uint8_t> colors(groups, White);
+
+    if (corners.size() == 1) {
+
+        // a teardrop: split the contour into thirds starting at its one corner
+
+        if (groups >= 3) {
+
+            constexpr uint8_t thirds[] = { Magenta, White, Yellow };
+
+            for (size_t i = 0; i < groups; ++i) {
+
+                colors[(corners[0] + i) % groups] = thirds[i * 3 / groups];
+            }
+        }
+    } else if (corners.size() > 1) {
+
+        constexpr uint8_t cycle[] = { Cyan, Magenta, Yellow };
+
+        auto color = 0;
+
+        auto firstRun = true;
+
+        size_t lastRunStart = corners[0];
+
+        for (size_t i = 0; i < groups; ++i) {
+
+            const auto group = (corners[0] + i) % groups;
+
+            if (i > 0 && std::find(corners.begin(), corners.end(), group) != corners.end()) {
+
+                color = (color + 1) % 3;
+
+                firstRun = false;
+
+                lastRunStart = i;
+            }
+
+            colors[group] = cycle[color];
+        }
+
+        // the last run also touches the first one
+
+        if (!firstRun && cycle[color] == Cyan) {
+
+            const auto previous = (color + 2) % 3;
+
+            const auto replacement = cycle[previous] == Magenta ? Yellow : Magenta;
+
+            for (auto i = lastRunStart; i < groups; ++i) {
+
+                colors[(corners[0] + i) % groups] = replacement;
+            }
+        }
+    }
+
+    ///
+
+    for (size_t group = 0; group < groups; ++group) {
+
+        for (auto i = groupStarts[group]; i < groupEnd(group); ++i) {
+
+            edges[i].color = colors[group];
+        }
+    }
+}
+
+void buildEdges(
+    const PathPolylines& polylines,
+    bool colored,
+    std::vector<Edge>& edges)
+{
+    const auto& p = polylines.points;
+
+    for (size_t contour = 0; contour < polylines.contourCount(); ++contour) {
+
+        const auto start = polylines.contourStart(contour);
+
+        const auto end = polylines.contourEnds[contour];
+
+        const auto first = edges.size();
+
+        const auto add = [&](uint32_t from, uint32_t to, uint32_t segment) {
+            if (p[from * 2] == p[to * 2] && p[from * 2 + 1] == p[to * 2 + 1]) {
+
+                return;
+            }
+
+            edges.push_back({ p[from * 2], p[from * 2 + 1], p[to * 2], p[to * 2 + 1], segment, White, false, false });
+        };
+
+        for (auto i = start + 1; i < end; ++i) {
+
+            add(i - 1, i, polylines.pointSegments[i]);
+        }
+
+        // fills close open contours with a straight edge of their own
+
+        if (!polylines.contourClosed[contour]) {
+
+            add(end - 1, start, std::numeric_limits<uint32_t>::max() - uint32_t(contour));
+        }
+
+        ///
+
+        const auto count = edges.size() - first;
+
+        for (size_t i = 0; i < count; ++i) {
+
+            auto& edge = edges[first + i];
+
+            edge.segmentStart = edges[first + (i + count - 1) % count].segment != edge.segment;
+
+            edge.segmentEnd = edges[first + (i + 1) % count].segment != edge.segment;
+        }
+
+        if (colored && count > 0) {
+
+            colorContour(edges.data() + first, count);
+        }
+    }
+}
+
+// compressed rows of edge indices, one list per bucket
+
+struct Buckets {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> items;
+};
+
+template <typename Range>
+void fillBuckets(
+    size_t bucketCount,
+    size_t itemCount,
+    Range range,
+    Buckets& buckets)
+{
+    buckets.offsets.assign(bucketCount + 1, 0);
+
+    for (size_t item = 0; item < itemCount; ++item) {
+
+        range(item, [&](size_t bucket) { ++buckets.offsets[bucket + 1]; });
+    }
+
+    for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+
+        buckets.offsets[bucket + 1] += buckets.offsets[bucket];
+    }
+
+    buckets.items.resize(buckets.offsets.back());
+
+    auto cursor = buckets.offsets;
+
+    for (size_t item = 0; item < itemCount; ++item) {
+
+        range(item, [&](size_t bucket) { buckets.items[cursor[bucket]++] = uint32_t(item); });
+    }
+}
+
+uint8_t encode(
+    float distance,
+    float range)
+{
+    const auto value = std::clamp(0.5f + distance / (2 * range), 0.0f, 1.0f);
+
+    return uint8_t(std::lround(value * 255));
+}
+
+float median(
+    float a,
+    float b,
+    float c)
+{
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+}
+
+const std::vector<uint8_t> PathDistanceField::generate(
+    const PathBuffer& buffer,
+    const PathDistanceFieldOptions& options)
+{
+    const auto width = std::max(0, options.width);
+
+    const auto height = std::max(0, options.height);
+
+    const auto range = std::max(options.range, 1e-3f);
+
+    const auto multiChannel = options.format == PathDistanceFieldFormat::RGBA8;
+
+    const auto channels = multiChannel ? 4 : 1;
+
+    std::vector<uint8_t> pixels(size_t(width) * height * channels, 0);
+
+    if (width == 0 || height == 0) {
+
+        return pixels;
+    }
+
+    ///
+
+    auto transformed = buffer;
+
+    PathTransform::transform(transformed, options.transform);
+
+    const auto polylines = PathFlattener::flatten(transformed, options.tolerance);
+
+    std::vector<Edge> edges;
+
+    buildEdges(polylines, multiChannel, edges);
+
+    // pseudo-distance signs assume the fill is on the left of each edge; a
+    // negative total area means the path winds the other way
+
+    auto area = 0.0;
+
+    for (const auto& edge : edges) {
+
+        area += double(edge.ax) * edge.by - double(edge.bx) * edge.ay;
+    }
+
+    const auto orientation = area < 0 ? -1.0f : 1.0f;
+
+    ///
+
+    // grid cells `range` wide over the image grown by `range`, so a pixel's search
+    // disc touches at most a 3x3 block of cells
+
+    const auto cellSize = range;
+
+    const auto gridOrigin = -range;
+
+    const auto gridWidth = size_t(std::ceil((width + 2 * range) / cellSize));
+
+    const auto gridHeight = size_t(std::ceil((height + 2 * range) / cellSize));
+
+    const auto cellOf = [&](float value, size_t cells) {
+        return size_t(std::clamp(std::floor((value - gridOrigin) / cellSize), 0.0f, float(cells - 1)));
+    };
+
+    Buckets grid;
+
+    fillBuckets(gridWidth * gridHeight, edges.size(), [&](size_t item, const auto& emit) {
+        const auto& edge = edges[item];
+
+        const auto minX = std::min(edge.ax, edge.bx), maxX = std::max(edge.ax, edge.bx);
+
+        const auto minY = std::min(edge.ay, edge.by), maxY = std::max(edge.ay, edge.by);
+
+        if (maxX < gridOrigin || maxY < gridOrigin || minX > width + range || minY > height + range) {
+
+            return;
+        }
+
+        for (auto y = cellOf(minY, gridHeight); y <= cellOf(maxY, gridHeight); ++y) {
+
+            for (auto x = cellOf(minX, gridWidth); x <= cellOf(maxX, gridWidth); ++x) {
+
+                emit(y * gridWidth + x);
+            }
+        }
+    },
+        grid);
+
+    // edges crossing each row's centre line, for the inside test
+
+    Buckets rows;
+
+    fillBuckets(size_t(height), edges.size(), [&](size_t item, const auto& emit) {
+        const auto& edge = edges[item];
+
+        const auto minY = std::min(edge.ay, edge.by);
+
+        const auto maxY = std::max(edge.ay, edge.by);
+
+        const auto first = std::max(0, int(std::ceil(minY - 0.5f)));
+
+        const auto last = std::min(height, int(std::ceil(maxY - 0.5f)));
+
+        for (auto y = first; y < last; ++y) {
+
+            emit(size_t(y));
+        }
+    },
+        rows);
+
+    ///
+
+    Parallel::forEach(size_t(height), 4, [&](size_t beginRow, size_t endRow) {
+        std::vector<Crossing> crossings;
+
+        for (auto row = beginRow; row < endRow; ++row) {
+
+            const auto py = float(row) + 0.5f;
+
+            crossings.clear();
+
+            for (auto i = rows.offsets[row]; i < rows.offsets[row + 1]; ++i) {
+
+                const auto& edge = edges[rows.items[i]];
+
+                const auto direction = edge.by > edge.ay ? 1 : -1;
+
+                const auto x = edge.ax + (py - edge.ay) * (edge.bx - edge.ax) / (edge.by - edge.ay);
+
+                crossings.push_back({ x, direction });
+            }
+
+            std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) {
+                return a.x < b.x;
+            });
+
+            size_t crossing = 0;
+
+            auto winding = 0;
+
+            auto* out = pixels.data() + row * width * channels;
+
+            const auto cellY0 = cellOf(py - range, gridHeight);
+
+            const auto cellY1 = cellOf(py + range, gridHeight);
+
+            ///
+
+            for (auto column = 0; column < width; ++column) {
+
+                const auto px = float(column) + 0.5f;
+
+                while (crossing < crossings.size() && crossings[crossing].x < px) {
+
+                    winding += crossings[crossing++].direction;
+                }
+
+                const auto inside = options.fillRule == PathFillRule::NonZero
+                    ? winding != 0
+                    : (winding & 1) != 0;
+
+                const auto insideSign = inside ? 1.0f : -1.0f;
+
+                ///
+
+                auto best = range;
+
+                float channelBest[3] = { range, range, range };
+
+                const Edge* channelEdge[3] = { nullptr, nullptr, nullptr };
+
+                const auto cellX0 = cellOf(px - range, gridWidth);
+
+                const auto cellX1 = cellOf(px + range, gridWidth);
+
+                for (auto cellY = cellY0; cellY <= cellY1; ++cellY) {
+
+                    for (auto cellX = cellX0; cellX <= cellX1; ++cellX) {
+
+                        const auto cell = cellY * gridWidth + cellX;
+
+                        for (auto i = grid.offsets[cell]; i < grid.offsets[cell + 1]; ++i) {
+
+                            const auto& edge = edges[grid.items[i]];
+
+                            const auto dx = edge.bx - edge.ax;
+
+                            const auto dy = edge.by - edge.ay;
+
+                            const auto t = std::clamp(((px - edge.ax) * dx + (py - edge.ay) * dy) / (dx * dx + dy * dy), 0.0f, 1.0f);
+
+                            const auto distance = std::hypot(px - (edge.ax + t * dx), py - (edge.ay + t * dy));
+
+                            best = std::min(best, distance);
+
+                            if (!multiChannel) {
+
+                                continue;
+                            }
+
+                            for (auto channel = 0; channel < 3; ++channel) {
+
+                                if ((edge.color & (1 << channel)) && distance < channelBest[channel]) {
+
+                                    channelBest[channel] = distance;
+
+                                    channelEdge[channel] = &edge;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                ///
+
+                const auto trueDistance = insideSign * best;
+
+                if (!multiChannel) {
+
+                    out[column] = encode(trueDistance, range);
+
+                    continue;
+                }
+
+                float signedChannels[3];
+
+                for (auto channel = 0; channel < 3; ++channel) {
+
+                    const auto* edge = channelEdge[channel];
+
+                    if (edge == nullptr) {
+
+                        signedChannels[channel] = insideSign * range;
+
+                        continue;
+                    }
+
+                    // signed pseudo-distance: past the ends of a segment the distance
+                    // to its extended line, signed by which side of the edge we are on
+
+                    const auto dx = edge->bx - edge->ax;
+
+                    const auto dy = edge->by - edge->ay;
+
+                    const auto lengthSquared = dx * dx + dy * dy;
+
+                    const auto t = ((px - edge->ax) * dx + (py - edge->ay) * dy) / lengthSquared;
+
+                    const auto cross = dx * (py - edge->ay) - dy * (px - edge->ax);
+
+                    auto distance = channelBest[channel];
+
+                    if ((t < 0 && edge->segmentStart) || (t > 1 && edge->segmentEnd)) {
+
+                        distance = std::min(distance, std::abs(cross) / std::sqrt(lengthSquared));
+                    }
+
+                    signedChannels[channel] = orientation * (cross >= 0 ? 1.0f : -1.0f) * distance;
+                }
+
+                // where the channels disagree with the true inside test (overlapping
+                // contours, even-odd holes wound the same way) fall back to the true
+                // distance so the median cannot flip
+
+                const auto mid = median(signedChannels[0], signedChannels[1], signedChannels[2]);
+
+                if ((mid >= 0) != inside) {
+
+                    signedChannels[0] = signedChannels[1] = signedChannels[2] = trueDistance;
+                }
+
+                out[column * 4] = encode(signedChannels[0], range);
+
+                out[column * 4 + 1] = encode(signedChannels[1], range);
+
+                out[column * 4 + 2] = encode(signedChannels[2], range);
+
+                out[column * 4 + 3] = encode(trueDistance, range);
+            }
+        }
+    });
+
+    ///
+
+    return pixels;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PathBuffer.h"
+#include "PathTransform.h"
+
+// distance fields
+
+enum class PathDistanceFieldFormat {
+    // one byte per pixel: the true signed distance
+    R8,
+    // four bytes per pixel for `MTL::PixelFormatRGBA8Unorm`: a multi-channel
+    // field in RGB (sample with median(r, g, b)) and the true distance in A
+    RGBA8,
+};
+
+struct PathDistanceFieldOptions {
+    int width = 64;
+    int height = 64;
+    // distance in pixels mapped to the ends of the byte range; 0.5 is the edge
+    // and larger values are inside
+    float range = 4;
+    // from path units to pixels, y down
+    PathMatrix transform = PathMatrix::makeIdentity();
+    PathDistanceFieldFormat format = PathDistanceFieldFormat::R8;
+    PathFillRule fillRule = PathFillRule::NonZero;
+    // flattening tolerance in pixels
+    float tolerance = 0.05f;
+};
+
+class PathDistanceField final {
+public:
+    // Rows are generated in parallel. Edges are bucketed into a grid whose cells
+    // are `range` wide, so each pixel only measures the edges that can be within
+    // `range` of it; inside/outside comes from scanline crossings per row using
+    // the fill rule. Open contours are closed, as when filling.
+
+    static const std::vector<uint8_t> generate(
+        const PathBuffer& buffer,
+        const PathDistanceFieldOptions& options);
+};
@@ -0,0 +1,492 @@
+#include "PathExtrusion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "Parallel.h"
+#include "PathFlattener.h"
+#include "PathTriangulator.h"
+
+// extrusion
+
+namespace {
+
+// A closed contour within `Outline::points`, without a repeated last point.
+// `edgeSegments[i]` is the source segment of the edge from point i to the next.
+
+struct Ring {
+    uint32_t begin;
+    uint32_t end;
+    double area;
+    int depth;
+    int parent;
+};
+
+struct Outline {
+    // model space: scaled, centred and y up
+    std::vector<float> points;
+    // path space, for texcoords
+    std::vector<float> sources;
+    std::vector<uint32_t> edgeSegments;
+    std::vector<Ring> rings;
+};
+
+const Outline toOutline(
+    const PathBuffer& buffer,
+    const PathExtrusionOptions& options)
+{
+    const auto scale = options.scale != 0 ? options.scale : 1.0f;
+
+    const auto polylines = PathFlattener::flatten(buffer, options.tolerance / std::abs(scale));
+
+    Outline outline;
+
+    if (polylines.pointCount() == 0) {
+
+        return outline;
+    }
+
+    auto minX = std::numeric_limits<float>::infinity(), minY = minX, maxX = -minX, maxY = -minX;
+
+    for (size_t i = 0; i < polylines.points.size(); i += 2) {
+
+        minX = std::min(minX, polylines.points[i]);
+
+        maxX = std::max(maxX, polylines.points[i]);
+
+        minY = std::min(minY, polylines.points[i + 1]);
+
+        maxY = std::max(maxY, polylines.points[i + 1]);
+    }
+
+    const auto centerX = options.center ? (minX + maxX) / 2 : 0.0f;
+
+    const auto centerY = options.center ? (minY + maxY) / 2 : 0.0f;
+
+    const auto width = maxX > minX ? maxX - minX : 1.0f;
+
+    const auto height = maxY > minY ? maxY - minY : 1.0f;
+
+    ///
+
+    for (size_t contour = 0; contour < polylines.contourCount(); ++contour) {
+
+        const auto begin = polylines.contourStart(contour);
+
+        auto end = polylines.contourEnds[contour];
+
+        // the repeated first point only tells us which segment closes the ring;
+        // open contours are closed by a segment of their own, as when filled
+
+        auto closing = std::numeric_limits<uint32_t>::max();
+
+        if (polylines.contourClosed[contour] && end - begin > 1) {
+
+            --end;
+
+            closing = polylines.pointSegments[end];
+        }
+
+        Ring ring { uint32_t(outline.points.size() / 2), 0, 0, 0, -1 };
+
+        for (auto i = begin; i < end; ++i) {
+
+            const auto x = polylines.points[i * 2], y = polylines.points[i * 2 + 1];
+
+            const auto modelX = (x - centerX) * scale, modelY = (centerY - y) * scale;
+
+            if (outline.points.size() / 2 > ring.begin) {
+
+                outline.edgeSegments.back() = polylines.pointSegments[i];
+
+                if (outline.points[outline.points.size() - 2] == modelX && outline.points.back() == modelY) {
+
+                    continue;
+                }
+            }
+
+            outline.points.insert(outline.points.end(), { modelX, modelY });
+
+            outline.sources.insert(outline.sources.end(), { (x - minX) / width, (y - minY) / height });
+
+            outline.edgeSegments.push_back(closing);
+        }
+
+        ring.end = uint32_t(outline.points.size() / 2);
+
+        // a last point on top of the first folds into it
+
+        if (ring.end - ring.begin > 1) {
+
+            const auto* first = outline.points.data() + ring.begin * 2;
+
+            const auto* last = outline.points.data() + (ring.end - 1) * 2;
+
+            if (first[0] == last[0] && first[1] == last[1]) {
+
+                outline.points.resize(outline.points.size() - 2);
+
+                outline.sources.resize(outline.sources.size() - 2);
+
+                outline.edgeSegments.pop_back();
+
+                --ring.end;
+            }
+        }
+
+        if (ring.end - ring.begin < 3) {
+
+            outline.points.resize(ring.begin * 2);
+
+            outline.sources.resize(ring.begin * 2);
+
+            outline.edgeSegments.resize(ring.begin);
+
+            continue;
+        }
+
+        for (auto i = ring.begin, j = ring.end - 1; i < ring.end; j = i++) {
+
+            ring.area += (double(outline.points[j * 2]) * outline.points[i * 2 + 1] - double(outline.points[i * 2]) * outline.points[j * 2 + 1]) / 2;
+        }
+
+        outline.rings.push_back(ring);
+    }
+
+    return outline;
+}
+
+const bool contains(
+    const Outline& outline,
+    const Ring& ring,
+    float x,
+    float y)
+{
+    auto inside = false;
+
+    for (auto i = ring.begin, j = ring.end - 1; i < ring.end; j = i++) {
+
+        const auto xi = outline.points[i * 2], yi = outline.points[i * 2 + 1];
+
+        const auto xj = outline.points[j * 2], yj = outline.points[j * 2 + 1];
+
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+// nesting depth of every ring, and for holes the outline they cut into
+
+void classify(
+    Outline& outline)
+{
+    auto& rings = outline.rings;
+
+    std::vector<std::vector<int>> containers(rings.size());
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+
+        const auto x = outline.points[rings[i].begin * 2], y = outline.points[rings[i].begin * 2 + 1];
+
+        for (size_t j = 0; j < rings.size(); ++j) {
+
+            if (i != j && std::abs(rings[j].area) > std::abs(rings[i].area) && contains(outline, rings[j], x, y)) {
+
+                containers[i].push_back(int(j));
+            }
+        }
+
+        rings[i].depth = int(containers[i].size());
+    }
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+
+        if (rings[i].depth % 2 == 0) {
+
+            continue;
+        }
+
+        for (const auto j : containers[i]) {
+
+            if (rings[j].depth == rings[i].depth - 1) {
+
+                rings[i].parent = j;
+
+                break;
+            }
+        }
+    }
+}
+
+void setVertex(
+    PathMeshVertex& vertex,
+    float x,
+    float y,
+    float z,
+    float normalX,
+    float normalY,
+    float normalZ,
+    float u,
+    float v)
+{
+    vertex = { { x, y, z, 0 }, { normalX, normalY, normalZ, 0 }, { u, v } };
+}
+
+}
+
+template <typename Index>
+const std::tuple<std::optional<BasicPathMesh<Index>>, std::optional<Error>> BasicPathExtruder<Index>::extrude(
+    const PathBuffer& buffer,
+    const PathExtrusionOptions& options)
+{
+    auto outline = toOutline(buffer, options);
+
+    classify(outline);
+
+    const auto pointCount = outline.points.size() / 2;
+
+    const auto vertexCount = pointCount * 6;
+
+    if (vertexCount > size_t(std::numeric_limits<Index>::max()) + 1) {
+
+        return {
+            std::nullopt,
+            Error(ErrorType::Unknown, ErrorCode::LimitExceeded, "extruded mesh needs " + std::to_string(vertexCount) + " vertices, more than its index type can address")
+        };
+    }
+
+    BasicPathMesh<Index> mesh;
+
+    mesh.vertices.resize(vertexCount);
+
+    const auto front = options.depth / 2, back = -options.depth / 2;
+
+    // caps: the front at [0, n), the back at [n, 2n)
+
+    for (size_t i = 0; i < pointCount; ++i) {
+
+        const auto x = outline.points[i * 2], y = outline.points[i * 2 + 1];
+
+        const auto u = outline.sources[i * 2], v = outline.sources[i * 2 + 1];
+
+        setVertex(mesh.vertices[i], x, y, front, 0, 0, 1, u, v);
+
+        setVertex(mesh.vertices[pointCount + i], x, y, back, 0, 0, -1, u, v);
+    }
+
+    std::vector<float> points;
+
+    std::vector<uint32_t> ringEnds, origins, triangles;
+
+    for (size_t r = 0; r < outline.rings.size(); ++r) {
+
+        const auto& ring = outline.rings[r];
+
+        if (ring.depth % 2 != 0) {
+
+            continue;
+        }
+
+        points.clear();
+
+        ringEnds.clear();
+
+        origins.clear();
+
+        triangles.clear();
+
+        const auto append = [&](const Ring& part) {
+            points.insert(points.end(), outline.points.begin() + part.begin * 2, outline.points.begin() + part.end * 2);
+
+            for (auto i = part.begin; i < part.end; ++i) {
+
+                origins.push_back(i);
+            }
+
+            ringEnds.push_back(uint32_t(origins.size()));
+        };
+
+        append(ring);
+
+        for (const auto& hole : outline.rings) {
+
+            if (hole.parent == int(r)) {
+
+                append(hole);
+            }
+        }
+
+        PathTriangulator::triangulate(points, ringEnds, triangles);
+
+        // counter-clockwise from the front
+
+        const auto flip = ring.area < 0;
+
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+
+            const auto a = origins[triangles[i]];
+
+            const auto b = origins[triangles[i + (flip ? 2 : 1)]];
+
+            const auto c = origins[triangles[i + (flip ? 1 : 2)]];
+
+            mesh.indices.insert(mesh.indices.end(), { Index(a), Index(b), Index(c) });
+
+            mesh.indices.insert(mesh.indices.end(), { Index(pointCount + a), Index(pointCount + c), Index(pointCount + b) });
+        }
+    }
+
+    ///
+
+    // walls: four vertices per edge from 2n on, so normals can differ per side
+
+    auto next = pointCount * 2;
+
+    std::vector<float> edgeNormals;
+
+    for (const auto& ring : outline.rings) {
+
+        const auto count = ring.end - ring.begin;
+
+        // outlines run counter-clockwise and holes clockwise, so outward is to
+        // the right of travel; a ring the other way round flips its normals
+
+        const auto outward = (ring.area > 0) == (ring.depth % 2 == 0) ? 1.0f : -1.0f;
+
+        edgeNormals.resize(count * 2);
+
+        auto perimeter = 0.0;
+
+        for (uint32_t k = 0; k < count; ++k) {
+
+            const auto* a = outline.points.data() + (ring.begin + k) * 2;
+
+            const auto* b = outline.points.data() + (ring.begin + (k + 1) % count) * 2;
+
+            const auto dx = b[0] - a[0], dy = b[1] - a[1];
+
+            const auto length = std::hypot(dx, dy);
+
+            perimeter += length;
+
+            edgeNormals[k * 2] = length > 0 ? outward * dy / length : 0;
+
+            edgeNormals[k * 2 + 1] = length > 0 ? -outward * dx / length : 0;
+        }
+
+        const auto perimeterScale = perimeter > 0 ? 1 / perimeter : 0.0;
+
+        // smooth across a point when both edges come from one curve
+
+        const auto vertexNormal = [&](uint32_t edge, uint32_t neighbour, float& x, float& y) {
+            x = edgeNormals[edge * 2];
+
+            y = edgeNormals[edge * 2 + 1];
+
+            if (outline.edgeSegments[ring.begin + edge] != outline.edgeSegments[ring.begin + neighbour]) {
+
+                return;
+            }
+
+            const auto sumX = x + edgeNormals[neighbour * 2], sumY = y + edgeNormals[neighbour * 2 + 1];
+
+            const auto length = std::hypot(sumX, sumY);
+
+            if (length > 1e-6f) {
+
+                x = sumX / length;
+
+                y = sumY / length;
+            }
+        };
+
+        auto distance = 0.0;
+
+        for (uint32_t k = 0; k < count; ++k) {
+
+            const auto ia = ring.begin + k, ib = ring.begin + (k + 1) % count;
+
+            const auto* a = outline.points.data() + ia * 2;
+
+            const auto* b = outline.points.data() + ib * 2;
+
+            const auto u0 = float(distance * perimeterScale);
+
+            distance += std::hypot(b[0] - a[0], b[1] - a[1]);
+
+            const auto u1 = float(distance * perimeterScale);
+
+            float ax, ay, bx, by;
+
+            vertexNormal(k, (k + count - 1) % count, ax, ay);
+
+            vertexNormal(k, (k + 1) % count, bx, by);
+
+            setVertex(mesh.vertices[next], a[0], a[1], front, ax, ay, 0, u0, 0);
+
+            setVertex(mesh.vertices[next + 1], b[0], b[1], front, bx, by, 0, u1, 0);
+
+            setVertex(mesh.vertices[next + 2], b[0], b[1], back, bx, by, 0, u1, 1);
+
+            setVertex(mesh.vertices[next + 3], a[0], a[1], back, ax, ay, 0, u0, 1);
+
+            // with travel reversed against outward, the quad's sides swap
+
+            const auto af = Index(next), bf = Index(next + 1), bb = Index(next + 2), ab = Index(next + 3);
+
+            if (outward > 0) {
+
+                mesh.indices.insert(mesh.indices.end(), { af, ab, bb, af, bb, bf });
+            } else {
+
+                mesh.indices.insert(mesh.indices.end(), { bf, bb, ab, bf, ab, af });
+            }
+
+            next += 4;
+        }
+    }
+
+    return { std::move(mesh), std::nullopt };
+}
+
+template <typename Index>
+const std::vector<std::tuple<std::optional<BasicPathMesh<Index>>, std::optional<Error>>> BasicPathExtruder<Index>::extrude(
+    const std::vector<PathBuffer>& buffers,
+    const PathExtrusionOptions& options)
+{
+    using Result = std::tuple<std::optional<BasicPathMesh<Index>>, std::optional<Error>>;
+
+    // errors cannot be assigned, so each result is built in place
+
+    std::vector<std::optional<Result>> slots(buffers.size());
+
+    Parallel::forEach(buffers.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+
+            slots[i].emplace(BasicPathExtruder<Index>::extrude(buffers[i], options));
+        }
+    });
+
+    std::vector<Result> meshes;
+
+    meshes.reserve(slots.size());
+
+    for (auto& slot : slots) {
+
+        meshes.push_back(std::move(*slot));
+    }
+
+    return meshes;
+}
+
+///
+
+template class BasicPathExtruder<uint16_t>;
+
+template class BasicPathExtruder<uint32_t>;
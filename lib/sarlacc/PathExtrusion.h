@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "Error.h"
+#include "PathBuffer.h"
+
+// extrusion
+
+// Laid out like the samples' `shader_types::VertexData`, where simd::float3 is
+// padded to 16 bytes, so a mesh's vertices can be copied into a Metal buffer as
+// they are. The fourth position and normal lanes are zero.
+
+struct alignas(16) PathMeshVertex {
+    float position[4];
+    float normal[4];
+    float texcoord[2];
+};
+
+static_assert(sizeof(PathMeshVertex) == 48);
+
+template <typename Index>
+struct BasicPathMesh {
+    std::vector<PathMeshVertex> vertices;
+    std::vector<Index> indices;
+};
+
+using PathMesh = BasicPathMesh<uint32_t>;
+
+using PathMesh16 = BasicPathMesh<uint16_t>;
+
+struct PathExtrusionOptions {
+    // distance between the front and back caps, centred on z = 0
+    float depth = 1;
+
+    // applied to path units before anything else
+    float scale = 1;
+
+    // flattening tolerance in scaled units
+    float tolerance = 0.05f;
+
+    // moves the middle of the path's bounds to the origin
+    bool center = true;
+};
+
+template <typename Index>
+class BasicPathExtruder final {
+public:
+    // Flattens the path and clips its contours into front and back caps joined by
+    // side walls. Path y runs down and model y up, so the front cap faces +z and
+    // every triangle winds counter-clockwise seen from outside, as in the samples.
+    //
+    // Contours are told apart by nesting: one inside an even number of others is
+    // an outline, one inside an odd number a hole in the nearest outline around
+    // it. That matches both fill rules for outlines that do not cross themselves
+    // or each other, which covers glyphs and icons.
+    //
+    // Caps take texcoords from the path's bounds, v running down the path. Walls
+    // run u along each contour and v from front to back; their normals are
+    // smoothed where flattened points come from the same curve and split where
+    // two segments meet, so corners stay sharp.
+    //
+    // Fails when the mesh needs more vertices than `Index` can address.
+
+    static const std::tuple<std::optional<BasicPathMesh<Index>>, std::optional<Error>> extrude(
+        const PathBuffer& buffer,
+        const PathExtrusionOptions& options = { });
+
+    // One mesh per path, built across all hardware threads.
+
+    static const std::vector<std::tuple<std::optional<BasicPathMesh<Index>>, std::optional<Error>>> extrude(
+        const std::vector<PathBuffer>& buffers,
+        const PathExtrusionOptions& options = { });
+};
+
+using PathExtruder = BasicPathExtruder<uint32_t>;
+
+using PathExtruder16 = BasicPathExtruder<uint16_t>;
@@ -0,0 +1,129 @@
+#include "PathFlattenCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+// flattening caches
+
+PathFlattenCache::PathFlattenCache(
+    float tolerance)
+    : m_tolerance(tolerance)
+{
+}
+
+PathFlattenCache::~PathFlattenCache()
+{
+    for (auto& level : m_levels) {
+
+        delete level.load(std::memory_order_relaxed);
+    }
+
+    for (const auto* level : m_retired) {
+
+        delete level;
+    }
+}
+
+const PathPolylines* PathFlattenCache::lookup(
+    const PathBuffer& buffer,
+    float scale)
+{
+    const auto exponent = std::clamp(int(std::ceil(std::log2(std::max(scale, 1e-30f)))), minimumExponent, maximumExponent);
+
+    auto& slot = m_levels[exponent - minimumExponent];
+
+    const auto generation = m_generation.load(std::memory_order_acquire);
+
+    auto* current = slot.load(std::memory_order_acquire);
+
+    if (current != nullptr && current->generation == generation) {
+
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+
+        return &current->polylines;
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+
+    ///
+
+    auto* level = new Level { generation, {} };
+
+    PathFlattener::flatten(buffer, m_tolerance / std::ldexp(1.0f, exponent), level->polylines);
+
+    // publish unless another thread got there first with polylines at least as new
+
+    while (!slot.compare_exchange_weak(current, level, std::memory_order_acq_rel, std::memory_order_acquire)) {
+
+        if (current != nullptr && current->generation >= generation) {
+
+            delete level;
+
+            return &current->polylines;
+        }
+    }
+
+    if (current != nullptr) {
+
+        retire(current);
+    }
+
+    return &level->polylines;
+}
+
+const float PathFlattenCache::maximumScale(
+    const PathMatrix& matrix)
+{
+    // the larger singular value of the 2x2 part
+
+    const auto a = matrix.columns[0][0], b = matrix.columns[0][1];
+
+    const auto c = matrix.columns[1][0], d = matrix.columns[1][1];
+
+    const auto sum = a * a + b * b + c * c + d * d;
+
+    const auto determinant = a * d - b * c;
+
+    const auto root = std::sqrt(std::max(0.0, sum * sum - 4 * determinant * determinant));
+
+    return float(std::sqrt((sum + root) / 2));
+}
+
+void PathFlattenCache::invalidate()
+{
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void PathFlattenCache::reclaim()
+{
+    std::vector<const Level*> retired;
+
+    {
+        std::lock_guard lock(m_retiredMutex);
+
+        retired.swap(m_retired);
+    }
+
+    for (const auto* level : retired) {
+
+        delete level;
+    }
+}
+
+const PathFlattenCacheStats PathFlattenCache::stats() const
+{
+    return PathFlattenCacheStats {
+        m_hits.load(std::memory_order_relaxed),
+        m_misses.load(std::memory_order_relaxed),
+    };
+}
+
+///
+
+void PathFlattenCache::retire(
+    const Level* level)
+{
+    std::lock_guard lock(m_retiredMutex);
+
+    m_retired.push_back(level);
+}
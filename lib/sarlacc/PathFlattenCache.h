@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "PathBuffer.h"
+#include "PathFlattener.h"
+#include "PathTransform.h"
+
+// flattening caches
+
+struct PathFlattenCacheStats {
+    size_t hits;
+    size_t misses;
+};
+
+// Flattened polylines of one path at power-of-two scale buckets. A lookup at scale
+// s uses the bucket 2^ceil(log2 s), flattened finely enough for that bucket, so
+// zooming within a factor of two reuses the same polylines. Buckets are built on
+// first use; scales beyond 2^-16 to 2^16 share the end buckets.
+//
+// Lookups are lock free and may run on any number of threads: each bucket is an
+// atomic pointer, and a thread that misses flattens on its own and publishes with
+// a compare-and-swap (losing a race just discards the duplicate). `invalidate`
+// bumps a generation so every bucket rebuilds on next use; the polylines it
+// replaces are retired rather than freed, so pointers from earlier lookups stay
+// valid until `reclaim` is called at a point where no thread holds one (between
+// frames, say).
+
+class PathFlattenCache final {
+public:
+    // `tolerance` is in device pixels
+    PathFlattenCache(
+        float tolerance = 0.25f);
+
+    ~PathFlattenCache();
+
+    PathFlattenCache(const PathFlattenCache&) = delete;
+
+    PathFlattenCache& operator=(const PathFlattenCache&) = delete;
+
+    // polylines in the buffer's own units; `buffer` must be the path this cache
+    // was last invalidated for
+
+    const PathPolylines* lookup(
+        const PathBuffer& buffer,
+        float scale);
+
+    // the largest factor `matrix` stretches any direction by, for `lookup`
+
+    static const float maximumScale(
+        const PathMatrix& matrix);
+
+    // call when the path changes
+
+    void invalidate();
+
+    void reclaim();
+
+    const PathFlattenCacheStats stats() const;
+
+private:
+    static constexpr int minimumExponent = -16;
+
+    static constexpr int maximumExponent = 16;
+
+    struct Level {
+        uint64_t generation;
+        PathPolylines polylines;
+    };
+
+    void retire(
+        const Level* level);
+
+    const float m_tolerance;
+
+    std::atomic<uint64_t> m_generation = 0;
+
+    std::array<std::atomic<const Level*>, maximumExponent - minimumExponent + 1> m_levels {};
+
+    std::mutex m_retiredMutex;
+
+    std::vector<const Level*> m_retired;
+
+    std::atomic<size_t> m_hits = 0;
+
+    std::atomic<size_t> m_misses = 0;
+};
@@ -0,0 +1,309 @@
+#include "PathFlattener.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "PathGeometry.h"
+
+// path flattening
+
+namespace {
+
+constexpr int maxSubdivisions = 1024;
+
+class PolylineWriter {
+public:
+    PolylineWriter(
+        PathPolylines& polylines)
+        : m_polylines(polylines)
+    {
+    }
+
+    void moveTo(
+        float x,
+        float y)
+    {
+        finish(false);
+
+        m_contourStart = m_polylines.pointSegments.size();
+
+        push(x, y, m_segment);
+    }
+
+    void lineTo(
+        float x,
+        float y)
+    {
+        push(x, y, m_segment++);
+    }
+
+    // Wang's formula: n chords keep a degree-d Bezier within `tolerance` when
+    // n >= sqrt(d (d - 1) / 8 * max |P[i] - 2 P[i+1] + P[i+2]| / tolerance)
+
+    void curveTo(
+        const double* points,
+        int degree,
+        float tolerance)
+    {
+        auto second = 0.0;
+
+        for (auto i = 0; i + 2 <= degree; ++i) {
+
+            const auto ddx = points[i * 2] - 2 * points[i * 2 + 2] + points[i * 2 + 4];
+
+            const auto ddy = points[i * 2 + 1] - 2 * points[i * 2 + 3] + points[i * 2 + 5];
+
+            second = std::max(second, std::hypot(ddx, ddy));
+        }
+
+        const auto factor = degree == 3 ? 0.75 : 0.25;
+
+        const auto count = std::clamp(int(std::ceil(std::sqrt(factor * second / tolerance))), 1, maxSubdivisions);
+
+        ///
+
+        for (auto i = 1; i <= count; ++i) {
+
+            const auto t = double(i) / count;
+
+            const auto u = 1 - t;
+
+            double x, y;
+
+            if (degree == 2) {
+
+                x = u * u * points[0] + 2 * u * t * points[2] + t * t * points[4];
+
+                y = u * u * points[1] + 2 * u * t * points[3] + t * t * points[5];
+            } else {
+
+                x = u * u * u * points[0] + 3 * u * u * t * points[2] + 3 * u * t * t * points[4] + t * t * t * points[6];
+
+                y = u * u * u * points[1] + 3 * u * u * t * points[3] + 3 * u * t * t * points[5] + t * t * t * points[7];
+            }
+
+            push(float(x), float(y), m_segment);
+        }
+    }
+
+    void endSegment()
+    {
+        ++m_segment;
+    }
+
+    void close()
+    {
+        const auto start = m_contourStart * 2;
+
+        const auto& points = m_polylines.points;
+
+        if (points.size() - start >= 2
+            && (points[points.size() - 2] != points[start] || points.back() != points[start + 1])) {
+
+            lineTo(points[start], points[start + 1]);
+        }
+
+        finish(true);
+    }
+
+    void finish(
+        bool closed)
+    {
+        const auto count = m_polylines.pointSegments.size() - m_contourStart;
+
+        if (count == 0) {
+
+            return;
+        }
+
+        // a lone MoveTo draws nothing
+
+        if (count < 2) {
+
+            m_polylines.points.resize(m_contourStart * 2);
+
+            m_polylines.pointSegments.resize(m_contourStart);
+
+            return;
+        }
+
+        m_polylines.contourEnds.push_back(uint32_t(m_polylines.pointSegments.size()));
+
+        m_polylines.contourClosed.push_back(closed ? 1 : 0);
+
+        m_contourStart = m_polylines.pointSegments.size();
+    }
+
+private:
+    void push(
+        float x,
+        float y,
+        uint32_t segment)
+    {
+        m_polylines.points.push_back(x);
+
+        m_polylines.points.push_back(y);
+
+        m_polylines.pointSegments.push_back(segment);
+    }
+
+    PathPolylines& m_polylines;
+
+    size_t m_contourStart = 0;
+
+    uint32_t m_segment = 0;
+};
+
+}
+
+const PathPolylines PathFlattener::flatten(
+    const PathBuffer& buffer,
+    float tolerance)
+{
+    PathPolylines polylines;
+
+    PathFlattener::flatten(buffer, tolerance, polylines);
+
+    return polylines;
+}
+
+void PathFlattener::flatten(
+    const PathBuffer& buffer,
+    float tolerance,
+    PathPolylines& polylines)
+{
+    polylines.points.clear();
+
+    polylines.pointSegments.clear();
+
+    polylines.contourEnds.clear();
+
+    polylines.contourClosed.clear();
+
+    polylines.points.reserve(buffer.coordinates.size());
+
+    ///
+
+    PolylineWriter writer(polylines);
+
+    std::vector<double> arcPoints;
+
+    double currentX = 0, currentY = 0;
+
+    size_t coordinate = 0;
+
+    size_t arc = 0;
+
+    for (const auto verb : buffer.verbs) {
+
+        const auto* p = buffer.coordinates.data() + coordinate;
+
+        switch (verb) {
+        case PathVerb::MoveTo: {
+
+            writer.moveTo(p[0], p[1]);
+
+            break;
+        }
+
+        case PathVerb::LineTo: {
+
+            writer.lineTo(p[0], p[1]);
+
+            break;
+        }
+
+        case PathVerb::QuadraticTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3] };
+
+            writer.curveTo(points, 2, tolerance);
+
+            writer.endSegment();
+
+            break;
+        }
+
+        case PathVerb::CubicTo: {
+
+            const double points[] = { currentX, currentY, p[0], p[1], p[2], p[3], p[4], p[5] };
+
+            writer.curveTo(points, 3, tolerance);
+
+            writer.endSegment();
+
+            break;
+        }
+
+        case PathVerb::ArcTo: {
+
+            const auto& parameters = buffer.arcs[arc++];
+
+            const auto ellipse = PathGeometry::centerArc(
+                currentX,
+                currentY,
+                parameters.radiusX,
+                parameters.radiusY,
+                parameters.rotation,
+                parameters.largeArc,
+                parameters.sweep,
+                p[0],
+                p[1]);
+
+            if (!ellipse.has_value()) {
+
+                writer.lineTo(p[0], p[1]);
+
+                break;
+            }
+
+            // the quarter-turn cubics of one arc stay a single segment
+
+            arcPoints.clear();
+
+            const auto cubics = PathGeometry::arcToCubics(ellipse.value(), arcPoints);
+
+            auto fromX = currentX, fromY = currentY;
+
+            for (auto i = 0; i < cubics; ++i) {
+
+                const auto* c = arcPoints.data() + i * 6;
+
+                const double points[] = { fromX, fromY, c[0], c[1], c[2], c[3], c[4], c[5] };
+
+                writer.curveTo(points, 3, tolerance);
+
+                fromX = c[4];
+
+                fromY = c[5];
+            }
+
+            writer.endSegment();
+
+            break;
+        }
+
+        case PathVerb::ClosePath: {
+
+            writer.close();
+
+            break;
+        }
+        }
+
+        ///
+
+        const auto count = PathVerbs::pointCount(verb) * 2;
+
+        if (count > 0) {
+
+            currentX = p[count - 2];
+
+            currentY = p[count - 1];
+        }
+
+        coordinate += count;
+    }
+
+    writer.finish(false);
+}
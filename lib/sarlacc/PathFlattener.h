@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PathBuffer.h"
+
+// path flattening
+
+// Contours as polylines. `pointSegments[i]` is the index of the source segment
+// (line, curve or closing edge) that ends at point `i`, so consumers can still
+// tell where one curve meets the next. Closed contours repeat their first point
+// at the end; open ones do not.
+
+struct PathPolylines {
+    std::vector<float> points;
+    std::vector<uint32_t> pointSegments;
+    std::vector<uint32_t> contourEnds;
+    std::vector<uint8_t> contourClosed;
+
+    const size_t pointCount() const { return points.size() / 2; }
+
+    const size_t contourCount() const { return contourEnds.size(); }
+
+    const uint32_t contourStart(
+        size_t contour) const
+    {
+        return contour == 0 ? 0 : contourEnds[contour - 1];
+    }
+};
+
+class PathFlattener final {
+public:
+    // `tolerance` bounds the distance between each curve and its chords, in the
+    // buffer's units. Subdivision counts come from Wang's formula, so the work
+    // per curve is known before any point is emitted.
+
+    static const PathPolylines flatten(
+        const PathBuffer& buffer,
+        float tolerance);
+
+    static void flatten(
+        const PathBuffer& buffer,
+        float tolerance,
+        PathPolylines& polylines);
+};
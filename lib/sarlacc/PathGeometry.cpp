@@ -0,0 +1,269 @@
+#include "PathGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// path geometry
+
+namespace {
+
+double angleBetween(
+    double ux,
+    double uy,
+    double vx,
+    double vy)
+{
+    return std::atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+}
+
+}
+
+const std::optional<PathEllipse> PathGeometry::centerArc(
+    double fromX,
+    double fromY,
+    double radiusX,
+    double radiusY,
+    double rotationDegrees,
+    bool largeArc,
+    bool sweep,
+    double toX,
+    double toY)
+{
+    if (radiusX == 0 || radiusY == 0) {
+
+        return std::nullopt;
+    }
+
+    if (fromX == toX && fromY == toY) {
+
+        return std::nullopt;
+    }
+
+    ///
+
+    auto rx = std::abs(radiusX);
+
+    auto ry = std::abs(radiusY);
+
+    const auto rotation = rotationDegrees * std::numbers::pi / 180.0;
+
+    const auto cosRotation = std::cos(rotation);
+
+    const auto sinRotation = std::sin(rotation);
+
+    ///
+
+    // step 1: the start point in the ellipse's own frame
+
+    const auto halfDx = (fromX - toX) / 2;
+
+    const auto halfDy = (fromY - toY) / 2;
+
+    const auto x1 = cosRotation * halfDx + sinRotation * halfDy;
+
+    const auto y1 = -sinRotation * halfDx + cosRotation * halfDy;
+
+    ///
+
+    // out-of-range radii are scaled up just enough to span the endpoints
+
+    const auto lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+
+    if (lambda > 1) {
+
+        const auto scale = std::sqrt(lambda);
+
+        rx *= scale;
+
+        ry *= scale;
+    }
+
+    ///
+
+    // step 2: the centre in the ellipse's frame
+
+    const auto rx2 = rx * rx;
+
+    const auto ry2 = ry * ry;
+
+    const auto numerator = rx2 * ry2 - rx2 * y1 * y1 - ry2 * x1 * x1;
+
+    const auto denominator = rx2 * y1 * y1 + ry2 * x1 * x1;
+
+    const auto coefficient = std::sqrt(std::max(0.0, numerator / denominator))
+        * (largeArc == sweep ? -1.0 : 1.0);
+
+    const auto cx1 = coefficient * rx * y1 / ry;
+
+    const auto cy1 = coefficient * -ry * x1 / rx;
+
+    ///
+
+    // step 3 and 4: back to user space, then the angles
+
+    const auto centerX = cosRotation * cx1 - sinRotation * cy1 + (fromX + toX) / 2;
+
+    const auto centerY = sinRotation * cx1 + cosRotation * cy1 + (fromY + toY) / 2;
+
+    const auto ux = (x1 - cx1) / rx;
+
+    const auto uy = (y1 - cy1) / ry;
+
+    const auto vx = (-x1 - cx1) / rx;
+
+    const auto vy = (-y1 - cy1) / ry;
+
+    const auto startAngle = angleBetween(1, 0, ux, uy);
+
+    auto sweepAngle = angleBetween(ux, uy, vx, vy);
+
+    if (!sweep && sweepAngle > 0) {
+
+        sweepAngle -= 2 * std::numbers::pi;
+    } else if (sweep && sweepAngle < 0) {
+
+        sweepAngle += 2 * std::numbers::pi;
+    }
+
+    ///
+
+    return PathEllipse {
+        centerX,
+        centerY,
+        rx,
+        ry,
+        cosRotation,
+        sinRotation,
+        startAngle,
+        sweepAngle
+    };
+}
+
+void PathGeometry::pointOnEllipse(
+    const PathEllipse& ellipse,
+    double angle,
+    double& x,
+    double& y)
+{
+    const auto cx = ellipse.radiusX * std::cos(angle);
+
+    const auto sy = ellipse.radiusY * std::sin(angle);
+
+    x = ellipse.centerX + cx * ellipse.cosRotation - sy * ellipse.sinRotation;
+
+    y = ellipse.centerY + cx * ellipse.sinRotation + sy * ellipse.cosRotation;
+}
+
+void PathGeometry::tangentOnEllipse(
+    const PathEllipse& ellipse,
+    double angle,
+    double& x,
+    double& y)
+{
+    const auto sx = -ellipse.radiusX * std::sin(angle);
+
+    const auto cy = ellipse.radiusY * std::cos(angle);
+
+    x = sx * ellipse.cosRotation - cy * ellipse.sinRotation;
+
+    y = sx * ellipse.sinRotation + cy * ellipse.cosRotation;
+}
+
+const int PathGeometry::arcToCubics(
+    const PathEllipse& ellipse,
+    std::vector<double>& controlPoints)
+{
+    const auto count = std::max(1, int(std::ceil(std::abs(ellipse.sweepAngle) / (std::numbers::pi / 2) - 1e-9)));
+
+    const auto step = ellipse.sweepAngle / count;
+
+    const auto handle = 4.0 / 3.0 * std::tan(step / 4);
+
+    ///
+
+    for (auto i = 0; i < count; ++i) {
+
+        const auto from = ellipse.startAngle + step * i;
+
+        const auto to = from + step;
+
+        double fromX, fromY, fromTangentX, fromTangentY;
+
+        double toX, toY, toTangentX, toTangentY;
+
+        PathGeometry::pointOnEllipse(ellipse, from, fromX, fromY);
+
+        PathGeometry::tangentOnEllipse(ellipse, from, fromTangentX, fromTangentY);
+
+        PathGeometry::pointOnEllipse(ellipse, to, toX, toY);
+
+        PathGeometry::tangentOnEllipse(ellipse, to, toTangentX, toTangentY);
+
+        controlPoints.insert(controlPoints.end(), {
+            fromX + handle * fromTangentX,
+            fromY + handle * fromTangentY,
+            toX - handle * toTangentX,
+            toY - handle * toTangentY,
+            toX,
+            toY,
+        });
+    }
+
+    ///
+
+    return count;
+}
+
+void PathGeometry::transformArcParameters(
+    double a,
+    double b,
+    double c,
+    double d,
+    double& radiusX,
+    double& radiusY,
+    double& rotationDegrees,
+    bool& sweep)
+{
+    const auto rotation = rotationDegrees * std::numbers::pi / 180.0;
+
+    const auto cosRotation = std::cos(rotation);
+
+    const auto sinRotation = std::sin(rotation);
+
+    ///
+
+    // K = [a c; b d] * R(rotation) * diag(radiusX, radiusY) maps the unit circle
+    // onto the transformed ellipse; its singular values are the new radii
+
+    const auto k00 = (a * cosRotation + c * sinRotation) * radiusX;
+
+    const auto k01 = (-a * sinRotation + c * cosRotation) * radiusY;
+
+    const auto k10 = (b * cosRotation + d * sinRotation) * radiusX;
+
+    const auto k11 = (-b * sinRotation + d * cosRotation) * radiusY;
+
+    const auto p = k00 * k00 + k01 * k01;
+
+    const auto q = k00 * k10 + k01 * k11;
+
+    const auto r = k10 * k10 + k11 * k11;
+
+    const auto mean = (p + r) / 2;
+
+    const auto spread = std::hypot((p - r) / 2, q);
+
+    ///
+
+    radiusX = std::sqrt(mean + spread);
+
+    radiusY = std::sqrt(std::max(0.0, mean - spread));
+
+    rotationDegrees = 0.5 * std::atan2(2 * q, p - r) * 180.0 / std::numbers::pi;
+
+    if (a * d - b * c < 0) {
+
+        sweep = !sweep;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+// path geometry
+
+// An SVG elliptical arc in centre parameterisation: points are
+// center + cos(t) * radiusX * axisX + sin(t) * radiusY * axisY
+// for t from startAngle to startAngle + sweepAngle.
+
+struct PathEllipse {
+    double centerX;
+    double centerY;
+    double radiusX;
+    double radiusY;
+    double cosRotation;
+    double sinRotation;
+    double startAngle;
+    double sweepAngle;
+};
+
+class PathGeometry final {
+public:
+    // Converts the endpoint form used by the `A` command (SVG 1.1 F.6.5), scaling
+    // radii up when they are too small to reach `to`. Returns std::nullopt for arcs
+    // that SVG renders as a straight line (zero radius or coincident endpoints).
+
+    static const std::optional<PathEllipse> centerArc(
+        double fromX,
+        double fromY,
+        double radiusX,
+        double radiusY,
+        double rotationDegrees,
+        bool largeArc,
+        bool sweep,
+        double toX,
+        double toY);
+
+    static void pointOnEllipse(
+        const PathEllipse& ellipse,
+        double angle,
+        double& x,
+        double& y);
+
+    static void tangentOnEllipse(
+        const PathEllipse& ellipse,
+        double angle,
+        double& x,
+        double& y);
+
+    // Appends the control points (c1, c2, end) of one cubic per quarter turn or
+    // less; the start point is the arc's own start and is not repeated.
+
+    static const int arcToCubics(
+        const PathEllipse& ellipse,
+        std::vector<double>& controlPoints);
+
+    // Radii, rotation and sweep of the ellipse after the linear map
+    // [a c; b d] (column-major, as in PathMatrix).
+
+    static void transformArcParameters(
+        double a,
+        double b,
+        double c,
+        double d,
+        double& radiusX,
+        double& radiusY,
+        double& rotationDegrees,
+        bool& sweep);
+};
@@ -0,0 +1,95 @@
+#include "PathHash.h"
+
+#include <cstring>
+
+// path hashing
+
+namespace {
+
+constexpr uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+
+class Hasher {
+public:
+    // eight bytes per step, the tail zero-padded; lengths are mixed in by the
+    // caller so that padding cannot collide
+
+    void addBytes(
+        const void* data,
+        size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+
+        for (; size >= 8; size -= 8, bytes += 8) {
+
+            uint64_t word;
+
+            std::memcpy(&word, bytes, 8);
+
+            addWord(word);
+        }
+
+        if (size > 0) {
+
+            uint64_t word = 0;
+
+            std::memcpy(&word, bytes, size);
+
+            addWord(word);
+        }
+    }
+
+    void addWord(
+        uint64_t word)
+    {
+        m_state = (m_state ^ word) * multiplier;
+
+        m_state ^= m_state >> 29;
+    }
+
+    const uint64_t finish() const
+    {
+        auto state = m_state;
+
+        state ^= state >> 33;
+
+        state *= 0xff51afd7ed558ccdull;
+
+        state ^= state >> 33;
+
+        state *= 0xc4ceb9fe1a85ec53ull;
+
+        state ^= state >> 33;
+
+        return state;
+    }
+
+private:
+    uint64_t m_state = 0xcbf29ce484222325ull;
+};
+
+}
+
+const uint64_t PathHash::compute(
+    const PathBuffer& buffer)
+{
+    Hasher hasher;
+
+    hasher.addWord(buffer.verbs.size());
+
+    hasher.addBytes(buffer.verbs.data(), buffer.verbs.size());
+
+    hasher.addWord(buffer.coordinates.size());
+
+    hasher.addBytes(buffer.coordinates.data(), buffer.coordinates.size() * sizeof(float));
+
+    for (const auto& arc : buffer.arcs) {
+
+        const float values[] = { arc.radiusX, arc.radiusY, arc.rotation };
+
+        hasher.addBytes(values, sizeof(values));
+
+        hasher.addWord((arc.largeArc ? 1 : 0) | (arc.sweep ? 2 : 0));
+    }
+
+    return hasher.finish();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+#include "PathBuffer.h"
+
+// path hashing
+
+class PathHash final {
+public:
+    // A 64-bit hash of a buffer's verbs, coordinates and arc parameters, for
+    // keying caches by path content. Equal buffers hash equally; coordinates are
+    // compared bit for bit, so 0 and -0 differ.
+
+    static const uint64_t compute(
+        const PathBuffer& buffer);
+};
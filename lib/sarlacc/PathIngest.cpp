@@ -0,0 +1,889 @@
+#include "PathIngest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "SvgScanner.h"
+
+// bulk ingestion
+
+namespace {
+
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(
+        size_t capacity)
+        : m_capacity(std::max(size_t(1), capacity))
+    {
+    }
+
+    // Waits for room; false once the queue is closed.
+
+    bool push(
+        T value)
+    {
+        std::unique_lock lock(m_mutex);
+
+        m_notFull.wait(lock, [&]() { return m_closed || m_items.size() < m_capacity; });
+
+        if (m_closed) {
+
+            return false;
+        }
+
+        m_items.push_back(std::move(value));
+
+        m_notEmpty.notify_one();
+
+        return true;
+    }
+
+    // Waits for an item; nothing once the queue is closed and drained.
+
+    std::optional<T> pop()
+    {
+        std::unique_lock lock(m_mutex);
+
+        m_notEmpty.wait(lock, [&]() { return m_closed || !m_items.empty(); });
+
+        return take();
+    }
+
+    std::optional<T> tryPop()
+    {
+        std::unique_lock lock(m_mutex);
+
+        return take();
+    }
+
+    // Closing lets consumers drain what is queued; cancelling drops it too.
+
+    void close(
+        bool discard = false)
+    {
+        std::unique_lock lock(m_mutex);
+
+        m_closed = true;
+
+        if (discard) {
+
+            m_items.clear();
+        }
+
+        m_notEmpty.notify_all();
+
+        m_notFull.notify_all();
+    }
+
+private:
+    std::optional<T> take()
+    {
+        if (m_items.empty()) {
+
+            return std::nullopt;
+        }
+
+        auto value = std::move(m_items.front());
+
+        m_items.pop_front();
+
+        m_notFull.notify_one();
+
+        return value;
+    }
+
+    const size_t m_capacity;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_notEmpty;
+
+    std::condition_variable m_notFull;
+
+    std::deque<T> m_items;
+
+    bool m_closed = false;
+};
+
+// A file's bytes, in a pool buffer or, for files too large for one, owned.
+
+struct ReadJob {
+    size_t fileIndex;
+    int64_t slot;
+    size_t length;
+    std::string owned;
+    std::optional<Error> error;
+};
+
+const ReadJob failedJob(
+    size_t fileIndex,
+    const std::string& what,
+    int error)
+{
+    return { fileIndex, -1, 0, { }, Error(ErrorType::Unknown, ErrorCode::Io, what + ": " + std::strerror(error)) };
+}
+
+// pread until `length` bytes or end of file; the count read, or -errno
+
+int64_t readAll(
+    int fd,
+    char* destination,
+    size_t length)
+{
+    size_t done = 0;
+
+    while (done < length) {
+
+        const auto count = ::pread(fd, destination + done, length - done, off_t(done));
+
+        if (count < 0 && errno == EINTR) {
+
+            continue;
+        }
+
+        if (count < 0) {
+
+            return -errno;
+        }
+
+        if (count == 0) {
+
+            break;
+        }
+
+        done += size_t(count);
+    }
+
+    return int64_t(done);
+}
+
+///
+
+#if defined(__linux__)
+
+// Just enough of io_uring over the raw system calls: one ring, reads in, results
+// out. The library does not depend on liburing.
+
+class IoUring {
+public:
+    IoUring() = default;
+
+    IoUring(const IoUring&) = delete;
+
+    IoUring& operator=(const IoUring&) = delete;
+
+    ~IoUring()
+    {
+        if (m_sqes != nullptr) {
+
+            ::munmap(m_sqes, m_sqesSize);
+        }
+
+        if (m_cq != nullptr && m_cq != m_sq) {
+
+            ::munmap(m_cq, m_cqSize);
+        }
+
+        if (m_sq != nullptr) {
+
+            ::munmap(m_sq, m_sqSize);
+        }
+
+        if (m_fd >= 0) {
+
+            ::close(m_fd);
+        }
+    }
+
+    bool setup(
+        unsigned entries)
+    {
+        io_uring_params params;
+
+        std::memset(&params, 0, sizeof(params));
+
+        m_fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+
+        if (m_fd < 0) {
+
+            return false;
+        }
+
+        m_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+
+        m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        const auto single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (single) {
+
+            m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+        }
+
+        m_sq = map(m_sqSize, IORING_OFF_SQ_RING);
+
+        m_cq = single ? m_sq : map(m_cqSize, IORING_OFF_CQ_RING);
+
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        m_sqes = static_cast<io_uring_sqe*>(map(m_sqesSize, IORING_OFF_SQES));
+
+        if (m_sq == nullptr || m_cq == nullptr || m_sqes == nullptr) {
+
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(m_sq);
+
+        auto* cq = static_cast<char*>(m_cq);
+
+        m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+
+        m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+
+        m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        m_sqEntries = params.sq_entries;
+
+        m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+
+        m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        return true;
+    }
+
+    // Pins the pool so reads can skip mapping it each time; may fail under a
+    // low RLIMIT_MEMLOCK, in which case plain reads are used.
+
+    bool registerBuffers(
+        const std::vector<iovec>& buffers)
+    {
+        m_fixed = ::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers.data(), unsigned(buffers.size())) == 0;
+
+        return m_fixed;
+    }
+
+    void read(
+        int fd,
+        char* destination,
+        unsigned length,
+        uint64_t offset,
+        uint16_t bufferIndex,
+        uint64_t userData)
+    {
+        // the reader never queues more than the ring holds
+
+        const auto tail = *m_sqTail + m_pending;
+
+        const auto index = tail & m_sqMask;
+
+        auto& sqe = m_sqes[index];
+
+        std::memset(&sqe, 0, sizeof(sqe));
+
+        sqe.opcode = m_fixed ? IORING_OP_READ_FIXED : IORING_OP_READV;
+
+        sqe.fd = fd;
+
+        sqe.off = offset;
+
+        sqe.user_data = userData;
+
+        if (m_fixed) {
+
+            sqe.addr = uint64_t(uintptr_t(destination));
+
+            sqe.len = length;
+
+            sqe.buf_index = bufferIndex;
+        } else {
+
+            // READV is the oldest read; one iovec per ring entry
+
+            if (m_iovecs.size() < m_sqEntries) {
+
+                m_iovecs.resize(m_sqEntries);
+            }
+
+            m_iovecs[index] = { destination, length };
+
+            sqe.addr = uint64_t(uintptr_t(&m_iovecs[index]));
+
+            sqe.len = 1;
+        }
+
+        m_sqArray[index] = index;
+
+        ++m_pending;
+    }
+
+    // Submits queued reads and waits for at least `wait` completions.
+
+    bool submit(
+        unsigned wait)
+    {
+        __atomic_store_n(m_sqTail, *m_sqTail + m_pending, __ATOMIC_RELEASE);
+
+        auto toSubmit = m_pending;
+
+        m_pending = 0;
+
+        while (true) {
+
+            const auto result = ::syscall(__NR_io_uring_enter, m_fd, toSubmit, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+            if (result >= 0) {
+
+                toSubmit -= unsigned(result);
+
+                if (toSubmit == 0 || wait > 0) {
+
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+
+                return false;
+            }
+        }
+    }
+
+    template <typename Body>
+    void reap(
+        const Body& body)
+    {
+        auto head = *m_cqHead;
+
+        const auto tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+        while (head != tail) {
+
+            const auto& cqe = m_cqes[head & m_cqMask];
+
+            const auto userData = cqe.user_data;
+
+            const auto result = cqe.res;
+
+            __atomic_store_n(m_cqHead, ++head, __ATOMIC_RELEASE);
+
+            body(userData, result);
+        }
+    }
+
+private:
+    void* map(
+        size_t size,
+        uint64_t offset)
+    {
+        auto* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, off_t(offset));
+
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+    int m_fd = -1;
+
+    void* m_sq = nullptr;
+
+    void* m_cq = nullptr;
+
+    io_uring_sqe* m_sqes = nullptr;
+
+    size_t m_sqSize = 0;
+
+    size_t m_cqSize = 0;
+
+    size_t m_sqesSize = 0;
+
+    unsigned* m_sqTail = nullptr;
+
+    unsigned* m_sqArray = nullptr;
+
+    unsigned m_sqMask = 0;
+
+    unsigned m_sqEntries = 0;
+
+    unsigned* m_cqHead = nullptr;
+
+    unsigned* m_cqTail = nullptr;
+
+    unsigned m_cqMask = 0;
+
+    io_uring_cqe* m_cqes = nullptr;
+
+    unsigned m_pending = 0;
+
+    bool m_fixed = false;
+
+    std::vector<iovec> m_iovecs;
+};
+
+#endif
+
+}
+
+struct PathIngestState {
+    PathIngestState(
+        std::vector<std::string>&& files,
+        const PathIngestOptions& options)
+        : files(std::move(files))
+        , depth(std::max(size_t(1), std::min(options.queueDepth, size_t(4096))))
+        , bufferSize(std::max(size_t(1), options.bufferSize))
+        , pool(new char[depth * bufferSize])
+        , freeSlots(depth)
+        , jobs(depth)
+        , results(options.resultCapacity)
+    {
+    }
+
+    const std::vector<std::string> files;
+
+    const size_t depth;
+
+    const size_t bufferSize;
+
+    const std::unique_ptr<char[]> pool;
+
+    BoundedQueue<int64_t> freeSlots;
+
+    BoundedQueue<ReadJob> jobs;
+
+    BoundedQueue<PathIngestResult> results;
+
+    std::atomic<bool> cancelled = false;
+
+    std::atomic<size_t> parsersRunning = 0;
+
+#if defined(__linux__)
+    std::unique_ptr<IoUring> ring;
+#endif
+
+    std::thread reader;
+
+    std::vector<std::thread> parsers;
+
+    ///
+
+    char* slot(
+        int64_t index) const
+    {
+        return pool.get() + size_t(index) * bufferSize;
+    }
+
+    // Opens a file for the pool; a file too large for a buffer, or one that
+    // cannot be opened, becomes a finished job straight away.
+
+    std::optional<ReadJob> open(
+        size_t fileIndex,
+        int& fd,
+        size_t& length) const
+    {
+        fd = ::open(files[fileIndex].c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0) {
+
+            return failedJob(fileIndex, "cannot open " + files[fileIndex], errno);
+        }
+
+        struct stat status;
+
+        if (::fstat(fd, &status) != 0) {
+
+            const auto error = errno;
+
+            ::close(fd);
+
+            return failedJob(fileIndex, "cannot stat " + files[fileIndex], error);
+        }
+
+        length = size_t(status.st_size);
+
+        if (length <= bufferSize) {
+
+            return std::nullopt;
+        }
+
+        std::string owned(length, '\0');
+
+        const auto count = readAll(fd, owned.data(), length);
+
+        ::close(fd);
+
+        if (count < 0) {
+
+            return failedJob(fileIndex, "cannot read " + files[fileIndex], int(-count));
+        }
+
+        owned.resize(size_t(count));
+
+        return ReadJob { fileIndex, -1, owned.size(), std::move(owned), std::nullopt };
+    }
+
+    void readBlocking()
+    {
+        for (size_t file = 0; file < files.size() && !cancelled; ++file) {
+
+            int fd;
+
+            size_t length;
+
+            if (auto finished = open(file, fd, length)) {
+
+                jobs.push(std::move(*finished));
+
+                continue;
+            }
+
+            const auto slot = freeSlots.pop();
+
+            if (!slot) {
+
+                ::close(fd);
+
+                break;
+            }
+
+            const auto count = readAll(fd, this->slot(*slot), length);
+
+            ::close(fd);
+
+            if (count < 0) {
+
+                freeSlots.push(*slot);
+
+                jobs.push(failedJob(file, "cannot read " + files[file], int(-count)));
+
+                continue;
+            }
+
+            jobs.push({ file, *slot, size_t(count), { }, std::nullopt });
+        }
+    }
+
+#if defined(__linux__)
+    void readRing()
+    {
+        struct Request {
+            int fd;
+            size_t fileIndex;
+            int64_t slot;
+            size_t length;
+            size_t done;
+        };
+
+        std::vector<Request> requests(depth);
+
+        std::vector<size_t> freeRequests;
+
+        for (size_t i = depth; i-- > 0;) {
+
+            freeRequests.push_back(i);
+        }
+
+        const auto submitRead = [&](size_t id) {
+            const auto& request = requests[id];
+
+            ring->read(request.fd, slot(request.slot) + request.done, unsigned(request.length - request.done), request.done, uint16_t(request.slot), id);
+        };
+
+        size_t nextFile = 0, inFlight = 0;
+
+        while (inFlight > 0 || (nextFile < files.size() && !cancelled)) {
+
+            while (nextFile < files.size() && !cancelled && !freeRequests.empty()) {
+
+                int fd;
+
+                size_t length;
+
+                const auto file = nextFile;
+
+                // with nothing in flight there is nothing to wait for but a
+                // buffer coming back from the parsers
+
+                const auto slot = inFlight == 0 ? freeSlots.pop() : freeSlots.tryPop();
+
+                if (!slot) {
+
+                    break;
+                }
+
+                ++nextFile;
+
+                if (auto finished = open(file, fd, length)) {
+
+                    freeSlots.push(*slot);
+
+                    jobs.push(std::move(*finished));
+
+                    continue;
+                }
+
+                if (length == 0) {
+
+                    ::close(fd);
+
+                    jobs.push({ file, *slot, 0, { }, std::nullopt });
+
+                    continue;
+                }
+
+                const auto id = freeRequests.back();
+
+                freeRequests.pop_back();
+
+                requests[id] = { fd, file, *slot, length, 0 };
+
+                submitRead(id);
+
+                ++inFlight;
+            }
+
+            if (inFlight == 0) {
+
+                continue;
+            }
+
+            if (!ring->submit(1)) {
+
+                // the ring is unusable; what is in flight can never complete
+
+                cancelled = true;
+
+                jobs.close(true);
+
+                return;
+            }
+
+            ring->reap([&](uint64_t id, int result) {
+                auto& request = requests[id];
+
+                // a short read of a regular file only happens when it is
+                // truncated or interrupted; ask for the rest
+
+                if (result > 0 && request.done + size_t(result) < request.length) {
+
+                    request.done += size_t(result);
+
+                    submitRead(id);
+
+                    return;
+                }
+
+                ::close(request.fd);
+
+                --inFlight;
+
+                freeRequests.push_back(id);
+
+                if (result < 0) {
+
+                    freeSlots.push(request.slot);
+
+                    jobs.push(failedJob(request.fileIndex, "cannot read " + files[request.fileIndex], -result));
+
+                    return;
+                }
+
+                jobs.push({ request.fileIndex, request.slot, request.done + size_t(result), { }, std::nullopt });
+            });
+        }
+    }
+#endif
+
+    void read()
+    {
+#if defined(__linux__)
+        if (ring) {
+
+            readRing();
+        } else {
+
+            readBlocking();
+        }
+#else
+        readBlocking();
+#endif
+
+        jobs.close();
+    }
+
+    ///
+
+    const PathIngestResult parse(
+        const ReadJob& job) const
+    {
+        std::vector<std::vector<std::vector<PathCommand>>> paths;
+
+        std::optional<Error> error;
+
+        const auto bytes = job.slot >= 0 ? std::string_view(slot(job.slot), job.length) : std::string_view(job.owned);
+
+        // the first failure is reported; later paths still parse
+
+        const auto parsePath = [&](std::string_view data) {
+            auto [subPaths, parseError] = PathParser::parsePathFromSource(data);
+
+            if (parseError && !error) {
+
+                error.emplace(*parseError);
+            }
+
+            paths.push_back(subPaths ? std::move(*subPaths) : std::vector<std::vector<PathCommand>> { });
+        };
+
+        if (files[job.fileIndex].ends_with(".svg")) {
+
+            const auto scanError = SvgScanner::scanDocument(bytes, [&](const SvgPathElement& element) {
+                parsePath(element.data);
+            });
+
+            if (scanError && !error) {
+
+                error.emplace(*scanError);
+            }
+        } else {
+
+            parsePath(bytes);
+        }
+
+        return { job.fileIndex, std::move(paths), std::move(error) };
+    }
+
+    void parseJobs()
+    {
+        while (auto job = jobs.pop()) {
+
+            if (job->error) {
+
+                if (!results.push({ job->fileIndex, { }, std::move(job->error) })) {
+
+                    break;
+                }
+
+                continue;
+            }
+
+            auto result = parse(*job);
+
+            if (job->slot >= 0) {
+
+                freeSlots.push(job->slot);
+            }
+
+            if (!results.push(std::move(result))) {
+
+                break;
+            }
+        }
+
+        if (parsersRunning.fetch_sub(1) == 1) {
+
+            results.close();
+        }
+    }
+};
+
+///
+
+PathIngest::PathIngest(
+    std::vector<std::string> files,
+    const PathIngestOptions& options)
+    : m_state(std::make_unique<PathIngestState>(std::move(files), options))
+{
+    auto& state = *m_state;
+
+    for (size_t i = 0; i < state.depth; ++i) {
+
+        state.freeSlots.push(int64_t(i));
+    }
+
+#if defined(__linux__)
+    auto ring = std::make_unique<IoUring>();
+
+    if (ring->setup(unsigned(state.depth))) {
+
+        std::vector<iovec> buffers(state.depth);
+
+        for (size_t i = 0; i < state.depth; ++i) {
+
+            buffers[i] = { state.slot(int64_t(i)), state.bufferSize };
+        }
+
+        ring->registerBuffers(buffers);
+
+        state.ring = std::move(ring);
+    }
+#endif
+
+    const auto parserCount = options.parserThreads > 0 ? options.parserThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    state.parsersRunning = parserCount;
+
+    state.reader = std::thread([&state]() { state.read(); });
+
+    for (size_t i = 0; i < parserCount; ++i) {
+
+        state.parsers.emplace_back([&state]() { state.parseJobs(); });
+    }
+}
+
+PathIngest::~PathIngest()
+{
+    auto& state = *m_state;
+
+    state.cancelled = true;
+
+    // unblock every stage; the reader still waits out its reads in flight
+
+    state.results.close(true);
+
+    state.freeSlots.close(true);
+
+    state.jobs.close(true);
+
+    state.reader.join();
+
+    for (auto& parser : state.parsers) {
+
+        parser.join();
+    }
+}
+
+std::optional<PathIngestResult> PathIngest::next()
+{
+    return m_state->results.pop();
+}
+
+const bool PathIngest::usesIoUring() const
+{
+#if defined(__linux__)
+    return m_state->ring != nullptr;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Error.h"
+#include "Path.h"
+
+// bulk ingestion
+
+struct PathIngestOptions {
+    // reads in flight at once, and buffers in the pool
+    size_t queueDepth = 64;
+
+    // bytes per pool buffer; larger files are read on their own
+    size_t bufferSize = 256 * 1024;
+
+    // 0 for one per hardware thread
+    size_t parserThreads = 0;
+
+    // parsed files waiting for `next` before parsers stop
+    size_t resultCapacity = 256;
+};
+
+struct PathIngestResult {
+    size_t fileIndex;
+    // one per path: a bare path file has one, an SVG document one per <path>
+    std::vector<std::vector<std::vector<PathCommand>>> paths;
+    std::optional<Error> error;
+};
+
+struct PathIngestState;
+
+// Reads and parses a list of files as a pipeline. A reader thread keeps up to
+// `queueDepth` reads in flight into a fixed pool of buffers: on Linux as one
+// io_uring with the pool registered for fixed-buffer reads, elsewhere (or where
+// io_uring is unavailable) with pread. Parser threads take filled buffers, hand
+// them back once parsed, and queue the results for `next`.
+//
+// Each stage waits on the next when it falls behind: a full result queue stops
+// the parsers, which stops buffers coming back, which stops new reads. Memory
+// is bounded by the pool and the result queue whatever the corpus size.
+//
+// Files ending in ".svg" are scanned for path elements; anything else is parsed
+// as path data whole. Results arrive in completion order, tagged with the index
+// of their file.
+
+class PathIngest final {
+public:
+    PathIngest(
+        std::vector<std::string> files,
+        const PathIngestOptions& options = { });
+
+    // Stops reading and parsing early if results are still pending.
+
+    ~PathIngest();
+
+    PathIngest(const PathIngest&) = delete;
+
+    PathIngest& operator=(const PathIngest&) = delete;
+
+    ///
+
+    // Blocks for the next parsed file; nothing once every file has been returned.
+
+    std::optional<PathIngestResult> next();
+
+    const bool usesIoUring() const;
+
+private:
+    std::unique_ptr<PathIngestState> m_state;
+};
@@ -0,0 +1,365 @@
+#include "PathMaskCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "PathHash.h"
+#include "PathRasterizer.h"
+
+// mask caching
+
+namespace {
+
+// 2x2 terms are keyed in steps of 1/4096: a 256 pixel icon drifts by at most
+// 1/16 pixel between transforms that share a mask
+
+constexpr double linearSteps = 4096;
+
+constexpr double perspectiveSteps = 1 << 20;
+
+constexpr size_t slabSize = 256 << 10;
+
+constexpr size_t smallestBlock = 64;
+
+constexpr int sizeClasses = 13;
+
+const int sizeClassFor(
+    size_t size)
+{
+    auto sizeClass = 0;
+
+    while (sizeClass < sizeClasses && (smallestBlock << sizeClass) < size) {
+
+        ++sizeClass;
+    }
+
+    return sizeClass < sizeClasses ? sizeClass : -1;
+}
+
+const size_t blockBytes(
+    size_t size)
+{
+    const auto sizeClass = sizeClassFor(size);
+
+    return size == 0 ? 0 : sizeClass < 0 ? size : smallestBlock << sizeClass;
+}
+
+int32_t quantize(
+    double value,
+    double steps)
+{
+    return int32_t(std::clamp(std::round(value * steps), double(std::numeric_limits<int32_t>::min()), double(std::numeric_limits<int32_t>::max())));
+}
+
+}
+
+size_t PathMaskCache::KeyHash::operator()(
+    const Key& key) const
+{
+    auto hash = key.contentHash;
+
+    for (const auto term : key.terms) {
+
+        hash = (hash ^ uint32_t(term)) * 0x9e3779b97f4a7c15ull;
+    }
+
+    hash ^= (key.projective ? 2 : 0) | (key.fillRule == PathFillRule::EvenOdd ? 1 : 0);
+
+    return size_t(hash ^ (hash >> 32));
+}
+
+///
+
+PathMaskCache::PathMaskCache(
+    size_t byteBudget,
+    int subpixelSteps)
+    : m_byteBudget(byteBudget)
+    , m_subpixelSteps(std::max(1, subpixelSteps))
+    , m_freeBlocks(sizeClasses)
+{
+}
+
+const PathMask PathMaskCache::lookup(
+    const PathBuffer& buffer,
+    const PathMatrix& transform,
+    PathFillRule fillRule)
+{
+    return lookup(buffer, PathHash::compute(buffer), transform, fillRule);
+}
+
+const PathMask PathMaskCache::lookup(
+    const PathBuffer& buffer,
+    uint64_t contentHash,
+    const PathMatrix& transform,
+    PathFillRule fillRule)
+{
+    Key key {};
+
+    key.contentHash = contentHash;
+
+    key.fillRule = fillRule;
+
+    key.projective = !transform.isAffine();
+
+    // the transform actually rasterized, rebuilt from the key so that every
+    // lookup sharing a mask would have drawn exactly that mask; homogeneous
+    // coordinates are scale invariant, so projective ones are compared with w = 1
+
+    auto local = transform;
+
+    if (key.projective && transform.columns[2][2] != 0) {
+
+        for (auto column = 0; column < 3; ++column) {
+
+            for (auto row = 0; row < 3; ++row) {
+
+                local.columns[column][row] = transform.columns[column][row] / transform.columns[2][2];
+            }
+        }
+    }
+
+    for (auto i = 0; i < 4; ++i) {
+
+        key.terms[i] = quantize(local.columns[i / 2][i % 2], linearSteps);
+
+        local.columns[i / 2][i % 2] = key.terms[i] / linearSteps;
+    }
+
+    auto offsetX = 0, offsetY = 0;
+
+    if (key.projective) {
+
+        key.terms[4] = quantize(local.columns[2][0], m_subpixelSteps);
+
+        key.terms[5] = quantize(local.columns[2][1], m_subpixelSteps);
+
+        key.terms[6] = quantize(local.columns[0][2], perspectiveSteps);
+
+        key.terms[7] = quantize(local.columns[1][2], perspectiveSteps);
+
+        local.columns[0][2] = key.terms[6] / perspectiveSteps;
+
+        local.columns[1][2] = key.terms[7] / perspectiveSteps;
+
+        local.columns[2][2] = 1;
+    } else {
+
+        // whole pixels move the mask instead of changing it
+
+        const auto phaseX = quantize(local.columns[2][0] - std::floor(local.columns[2][0]), m_subpixelSteps);
+
+        const auto phaseY = quantize(local.columns[2][1] - std::floor(local.columns[2][1]), m_subpixelSteps);
+
+        offsetX = int(std::floor(local.columns[2][0])) + phaseX / m_subpixelSteps;
+
+        offsetY = int(std::floor(local.columns[2][1])) + phaseY / m_subpixelSteps;
+
+        key.terms[4] = phaseX % m_subpixelSteps;
+
+        key.terms[5] = phaseY % m_subpixelSteps;
+    }
+
+    local.columns[2][0] = key.terms[4] / double(m_subpixelSteps);
+
+    local.columns[2][1] = key.terms[5] / double(m_subpixelSteps);
+
+    ///
+
+    auto found = m_index.find(key);
+
+    if (found != m_index.end()) {
+
+        ++m_stats.hits;
+
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+    } else {
+
+        ++m_stats.misses;
+
+        Entry entry {};
+
+        entry.key = key;
+
+        entry.sizeClass = -1;
+
+        rasterize(buffer, local, fillRule, entry);
+
+        m_entries.push_front(std::move(entry));
+
+        m_index.emplace(key, m_entries.begin());
+    }
+
+    ///
+
+    const auto& entry = m_entries.front();
+
+    return PathMask {
+        offsetX + entry.left,
+        offsetY + entry.top,
+        entry.width,
+        entry.height,
+        entry.coverage,
+    };
+}
+
+void PathMaskCache::clear()
+{
+    m_index.clear();
+
+    m_entries.clear();
+
+    m_slabs.clear();
+
+    for (auto& blocks : m_freeBlocks) {
+
+        blocks.clear();
+    }
+
+    m_stats.bytes = 0;
+}
+
+const PathMaskCacheStats PathMaskCache::stats() const
+{
+    auto stats = m_stats;
+
+    stats.entries = m_entries.size();
+
+    return stats;
+}
+
+///
+
+void PathMaskCache::rasterize(
+    const PathBuffer& buffer,
+    const PathMatrix& transform,
+    PathFillRule fillRule,
+    Entry& entry)
+{
+    m_transformed = buffer;
+
+    PathTransform::transform(m_transformed, transform);
+
+    PathFlattener::flatten(m_transformed, 0.25f, m_polylines);
+
+    if (m_polylines.pointCount() == 0) {
+
+        evict(0);
+
+        return;
+    }
+
+    // the pixels the polylines touch; they are what gets rasterized
+
+    auto minX = std::numeric_limits<float>::infinity(), minY = minX;
+
+    auto maxX = -minX, maxY = -minX;
+
+    for (size_t point = 0; point < m_polylines.pointCount(); ++point) {
+
+        minX = std::min(minX, m_polylines.points[point * 2]);
+
+        maxX = std::max(maxX, m_polylines.points[point * 2]);
+
+        minY = std::min(minY, m_polylines.points[point * 2 + 1]);
+
+        maxY = std::max(maxY, m_polylines.points[point * 2 + 1]);
+    }
+
+    entry.left = int(std::floor(minX));
+
+    entry.top = int(std::floor(minY));
+
+    entry.width = std::max(1, int(std::ceil(maxX)) - entry.left);
+
+    entry.height = std::max(1, int(std::ceil(maxY)) - entry.top);
+
+    for (size_t point = 0; point < m_polylines.pointCount(); ++point) {
+
+        m_polylines.points[point * 2] -= float(entry.left);
+
+        m_polylines.points[point * 2 + 1] -= float(entry.top);
+    }
+
+    ///
+
+    const auto size = size_t(entry.width) * entry.height;
+
+    evict(blockBytes(size));
+
+    allocate(size, entry);
+
+    PathRasterizer::rasterize(m_polylines, fillRule, entry.width, entry.height, entry.coverage, entry.width, m_accumulation);
+}
+
+void PathMaskCache::allocate(
+    size_t size,
+    Entry& entry)
+{
+    entry.sizeClass = sizeClassFor(size);
+
+    entry.bytes = blockBytes(size);
+
+    m_stats.bytes += entry.bytes;
+
+    if (entry.sizeClass < 0) {
+
+        entry.large = std::make_unique<uint8_t[]>(size);
+
+        entry.coverage = entry.large.get();
+
+        return;
+    }
+
+    ///
+
+    auto& blocks = m_freeBlocks[entry.sizeClass];
+
+    if (blocks.empty()) {
+
+        const auto block = smallestBlock << entry.sizeClass;
+
+        m_slabs.push_back(std::make_unique<uint8_t[]>(slabSize));
+
+        for (size_t offset = 0; offset + block <= slabSize; offset += block) {
+
+            blocks.push_back(m_slabs.back().get() + offset);
+        }
+    }
+
+    entry.coverage = blocks.back();
+
+    blocks.pop_back();
+}
+
+void PathMaskCache::release(
+    Entry& entry)
+{
+    if (entry.sizeClass >= 0) {
+
+        m_freeBlocks[entry.sizeClass].push_back(entry.coverage);
+    }
+
+    entry.large.reset();
+
+    entry.coverage = nullptr;
+
+    m_stats.bytes -= entry.bytes;
+}
+
+void PathMaskCache::evict(
+    size_t incoming)
+{
+    while (!m_entries.empty() && m_stats.bytes + incoming > m_byteBudget) {
+
+        auto& entry = m_entries.back();
+
+        release(entry);
+
+        m_index.erase(entry.key);
+
+        m_entries.pop_back();
+
+        ++m_stats.evictions;
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "PathBuffer.h"
+#include "PathFlattener.h"
+#include "PathTransform.h"
+
+// mask caching
+
+// An 8-bit coverage mask placed in device pixels: row `r` of `coverage` covers
+// pixels (x, y + r) to (x + width - 1, y + r).
+
+struct PathMask {
+    int x;
+    int y;
+    int width;
+    int height;
+    const uint8_t* coverage;
+};
+
+struct PathMaskCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t bytes;
+    size_t entries;
+};
+
+// Rasterized masks keyed by (path content hash, quantized transform, fill rule).
+// Affine transforms are split into their 2x2 part, the integer part of the
+// translation and a subpixel phase; only the first and last are keyed, so a path
+// moved by whole pixels reuses its mask, and phases are snapped to
+// `subpixelSteps` per pixel (a quarter pixel by default) where the difference does
+// not show. Projective transforms key every term.
+//
+// Masks live in fixed-size blocks carved out of large slabs, one free list per
+// power-of-two size class, so once warm the pool recycles evicted blocks instead
+// of allocating. The least recently used masks are evicted to keep the blocks in
+// use within `byteBudget`.
+//
+// Not thread safe. A returned mask stays valid until the next `lookup` or `clear`.
+
+class PathMaskCache final {
+public:
+    PathMaskCache(
+        size_t byteBudget = 16 << 20,
+        int subpixelSteps = 4);
+
+    const PathMask lookup(
+        const PathBuffer& buffer,
+        const PathMatrix& transform,
+        PathFillRule fillRule);
+
+    // for callers that already keep the buffer's `PathHash::compute`
+
+    const PathMask lookup(
+        const PathBuffer& buffer,
+        uint64_t contentHash,
+        const PathMatrix& transform,
+        PathFillRule fillRule);
+
+    void clear();
+
+    const PathMaskCacheStats stats() const;
+
+private:
+    struct Key {
+        uint64_t contentHash;
+        int32_t terms[8];
+        bool projective;
+        PathFillRule fillRule;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Key key;
+        // relative to the integer translation the mask was keyed without
+        int left;
+        int top;
+        int width;
+        int height;
+        uint8_t* coverage;
+        int sizeClass;
+        size_t bytes;
+        std::unique_ptr<uint8_t[]> large;
+    };
+
+    void rasterize(
+        const PathBuffer& buffer,
+        const PathMatrix& transform,
+        PathFillRule fillRule,
+        Entry& entry);
+
+    void allocate(
+        size_t size,
+        Entry& entry);
+
+    void release(
+        Entry& entry);
+
+    void evict(
+        size_t incoming);
+
+    const size_t m_byteBudget;
+
+    const int m_subpixelSteps;
+
+    // most recently used first
+    std::list<Entry> m_entries;
+
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+
+    std::vector<std::unique_ptr<uint8_t[]>> m_slabs;
+
+    std::vector<std::vector<uint8_t*>> m_freeBlocks;
+
+    PathBuffer m_transformed;
+
+    PathPolylines m_polylines;
+
+    std::vector<float> m_accumulation;
+
+    PathMaskCacheStats m_stats {};
+};
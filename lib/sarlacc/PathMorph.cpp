@@ -0,0 +1,507 @@
+#include "PathMorph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include "Simd.h"
+
+// morphing
+
+namespace {
+
+// A closed contour of cubics: the start point, then (c1, c2, end) per segment,
+// the last end being the start again.
+
+struct CubicContour {
+    std::vector<double> points;
+    double area;
+    double centroidX;
+    double centroidY;
+
+    const size_t segmentCount() const { return (points.size() - 2) / 6; }
+
+    const double* segment(
+        size_t index) const
+    {
+        return points.data() + index * 6;
+    }
+};
+
+void measure(
+    CubicContour& contour)
+{
+    // area and centroid of the polygon through a few points per cubic, which is
+    // all pairing needs
+
+    constexpr int samples = 8;
+
+    auto twiceArea = 0.0, sumX = 0.0, sumY = 0.0;
+
+    auto previousX = contour.points[0], previousY = contour.points[1];
+
+    for (size_t segment = 0; segment < contour.segmentCount(); ++segment) {
+
+        const auto* p = contour.segment(segment);
+
+        for (auto i = 1; i <= samples; ++i) {
+
+            const auto t = double(i) / samples, u = 1 - t;
+
+            const auto x = u * u * u * p[0] + 3 * u * u * t * p[2] + 3 * u * t * t * p[4] + t * t * t * p[6];
+
+            const auto y = u * u * u * p[1] + 3 * u * u * t * p[3] + 3 * u * t * t * p[5] + t * t * t * p[7];
+
+            const auto cross = previousX * y - x * previousY;
+
+            twiceArea += cross;
+
+            sumX += (previousX + x) * cross;
+
+            sumY += (previousY + y) * cross;
+
+            previousX = x;
+
+            previousY = y;
+        }
+    }
+
+    contour.area = twiceArea / 2;
+
+    if (std::abs(twiceArea) > 1e-12) {
+
+        contour.centroidX = sumX / (3 * twiceArea);
+
+        contour.centroidY = sumY / (3 * twiceArea);
+    } else {
+
+        contour.centroidX = contour.points[0];
+
+        contour.centroidY = contour.points[1];
+    }
+}
+
+const std::vector<CubicContour> toCubicContours(
+    const PathBuffer& source)
+{
+    const auto buffer = PathBufferBuilder::withArcsAsCubics(source);
+
+    std::vector<CubicContour> contours;
+
+    const auto finish = [&]() {
+        if (contours.empty()) {
+
+            return;
+        }
+
+        auto& points = contours.back().points;
+
+        const auto startX = points[0], startY = points[1];
+
+        const auto endX = points[points.size() - 2], endY = points[points.size() - 1];
+
+        if (endX != startX || endY != startY) {
+
+            points.insert(points.end(), { endX + (startX - endX) / 3, endY + (startY - endY) / 3, endX + (startX - endX) * 2 / 3, endY + (startY - endY) * 2 / 3, startX, startY });
+        }
+
+        if (points.size() < 8) {
+
+            contours.pop_back();
+
+            return;
+        }
+
+        measure(contours.back());
+    };
+
+    size_t coordinate = 0;
+
+    for (const auto verb : buffer.verbs) {
+
+        const auto* p = buffer.coordinates.data() + coordinate;
+
+        coordinate += PathVerbs::pointCount(verb) * 2;
+
+        if (verb == PathVerb::MoveTo) {
+
+            finish();
+
+            contours.push_back({ { p[0], p[1] }, 0, 0, 0 });
+
+            continue;
+        }
+
+        if (verb == PathVerb::ClosePath || contours.empty()) {
+
+            continue;
+        }
+
+        auto& points = contours.back().points;
+
+        const auto x = points[points.size() - 2], y = points[points.size() - 1];
+
+        switch (verb) {
+        case PathVerb::LineTo:
+            points.insert(points.end(), { x + (p[0] - x) / 3, y + (p[1] - y) / 3, x + (p[0] - x) * 2 / 3, y + (p[1] - y) * 2 / 3, p[0], p[1] });
+            break;
+
+        case PathVerb::QuadraticTo:
+            points.insert(points.end(), { x + (p[0] - x) * 2 / 3, y + (p[1] - y) * 2 / 3, p[2] + (p[0] - p[2]) * 2 / 3, p[3] + (p[1] - p[3]) * 2 / 3, p[2], p[3] });
+            break;
+
+        case PathVerb::CubicTo:
+            points.insert(points.end(), { p[0], p[1], p[2], p[3], p[4], p[5] });
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    finish();
+
+    return contours;
+}
+
+// n segments that all sit at one point, for a contour with no partner
+
+const CubicContour collapsed(
+    double x,
+    double y,
+    size_t segmentCount)
+{
+    CubicContour contour { std::vector<double>(2 + segmentCount * 6), 0, x, y };
+
+    for (size_t i = 0; i < contour.points.size(); i += 2) {
+
+        contour.points[i] = x;
+
+        contour.points[i + 1] = y;
+    }
+
+    return contour;
+}
+
+// halves the longest segment, by control polygon, until there are `count`
+
+void subdivideTo(
+    CubicContour& contour,
+    size_t count)
+{
+    while (contour.segmentCount() < count) {
+
+        size_t longest = 0;
+
+        auto longestLength = -1.0;
+
+        for (size_t segment = 0; segment < contour.segmentCount(); ++segment) {
+
+            const auto* p = contour.segment(segment);
+
+            const auto length = std::hypot(p[2] - p[0], p[3] - p[1]) + std::hypot(p[4] - p[2], p[5] - p[3]) + std::hypot(p[6] - p[4], p[7] - p[5]);
+
+            if (length > longestLength) {
+
+                longest = segment;
+
+                longestLength = length;
+            }
+        }
+
+        ///
+
+        const auto* p = contour.segment(longest);
+
+        double halves[12];
+
+        for (auto axis = 0; axis < 2; ++axis) {
+
+            const auto ab = (p[axis] + p[2 + axis]) / 2, bc = (p[2 + axis] + p[4 + axis]) / 2, cd = (p[4 + axis] + p[6 + axis]) / 2;
+
+            const auto abc = (ab + bc) / 2, bcd = (bc + cd) / 2;
+
+            const auto middle = (abc + bcd) / 2;
+
+            halves[axis] = ab;
+
+            halves[2 + axis] = abc;
+
+            halves[4 + axis] = middle;
+
+            halves[6 + axis] = bcd;
+
+            halves[8 + axis] = cd;
+
+            halves[10 + axis] = p[6 + axis];
+        }
+
+        const auto at = contour.points.begin() + 2 + longest * 6;
+
+        std::copy(halves, halves + 6, at);
+
+        contour.points.insert(at + 6, halves + 6, halves + 12);
+    }
+}
+
+void reverse(
+    CubicContour& contour)
+{
+    const auto count = contour.segmentCount();
+
+    std::vector<double> points = { contour.points[0], contour.points[1] };
+
+    for (size_t i = count; i-- > 0;) {
+
+        const auto* p = contour.segment(i);
+
+        points.insert(points.end(), { p[4], p[5], p[2], p[3], p[0], p[1] });
+    }
+
+    contour.points.swap(points);
+
+    contour.area = -contour.area;
+}
+
+// starts `contour` at the on-curve point that makes its corners travel least
+
+void alignStart(
+    const CubicContour& reference,
+    CubicContour& contour)
+{
+    const auto count = contour.segmentCount();
+
+    auto best = size_t(0);
+
+    auto bestCost = std::numeric_limits<double>::infinity();
+
+    for (size_t rotation = 0; rotation < count; ++rotation) {
+
+        auto cost = 0.0;
+
+        for (size_t i = 0; i < count && cost < bestCost; ++i) {
+
+            const auto* a = reference.points.data() + i * 6;
+
+            const auto* b = contour.points.data() + ((i + rotation) % count) * 6;
+
+            cost += (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]);
+        }
+
+        if (cost < bestCost) {
+
+            best = rotation;
+
+            bestCost = cost;
+        }
+    }
+
+    if (best == 0) {
+
+        return;
+    }
+
+    std::vector<double> points = { contour.points[best * 6], contour.points[best * 6 + 1] };
+
+    for (size_t i = 0; i < count; ++i) {
+
+        const auto* p = contour.segment((i + best) % count);
+
+        points.insert(points.end(), p + 2, p + 8);
+    }
+
+    contour.points.swap(points);
+}
+
+}
+
+const PathMorph PathMorph::build(
+    const PathBuffer& from,
+    const PathBuffer& to)
+{
+    auto fromContours = toCubicContours(from);
+
+    auto toContours = toCubicContours(to);
+
+    // centroid distances are measured against the size of both paths together
+
+    auto minX = std::numeric_limits<double>::infinity(), minY = minX, maxX = -minX, maxY = -minX;
+
+    for (const auto* contours : { &fromContours, &toContours }) {
+
+        for (const auto& contour : *contours) {
+
+            for (size_t i = 0; i < contour.points.size(); i += 2) {
+
+                minX = std::min(minX, contour.points[i]);
+
+                maxX = std::max(maxX, contour.points[i]);
+
+                minY = std::min(minY, contour.points[i + 1]);
+
+                maxY = std::max(maxY, contour.points[i + 1]);
+            }
+        }
+    }
+
+    const auto diagonal = std::max(std::hypot(maxX - minX, maxY - minY), 1e-12);
+
+    ///
+
+    std::vector<std::tuple<double, size_t, size_t>> candidates;
+
+    for (size_t i = 0; i < fromContours.size(); ++i) {
+
+        for (size_t j = 0; j < toContours.size(); ++j) {
+
+            const auto& a = fromContours[i];
+
+            const auto& b = toContours[j];
+
+            const auto distance = std::hypot(a.centroidX - b.centroidX, a.centroidY - b.centroidY) / diagonal;
+
+            // relative area counts for less: a shape that grows in place should
+            // keep its partner over a same-sized one elsewhere
+
+            const auto larger = std::max({ std::abs(a.area), std::abs(b.area), 1e-12 });
+
+            const auto areaDifference = std::abs(std::abs(a.area) - std::abs(b.area)) / larger;
+
+            candidates.emplace_back(distance + areaDifference / 4, i, j);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<std::pair<CubicContour, CubicContour>> pairs;
+
+    std::vector<uint8_t> fromUsed(fromContours.size(), 0), toUsed(toContours.size(), 0);
+
+    for (const auto& [cost, i, j] : candidates) {
+
+        if (fromUsed[i] || toUsed[j]) {
+
+            continue;
+        }
+
+        fromUsed[i] = toUsed[j] = 1;
+
+        pairs.emplace_back(fromContours[i], toContours[j]);
+    }
+
+    for (size_t i = 0; i < fromContours.size(); ++i) {
+
+        if (!fromUsed[i]) {
+
+            const auto& a = fromContours[i];
+
+            pairs.emplace_back(a, collapsed(a.centroidX, a.centroidY, a.segmentCount()));
+        }
+    }
+
+    for (size_t j = 0; j < toContours.size(); ++j) {
+
+        if (!toUsed[j]) {
+
+            const auto& b = toContours[j];
+
+            pairs.emplace_back(collapsed(b.centroidX, b.centroidY, b.segmentCount()), b);
+        }
+    }
+
+    ///
+
+    PathMorph morph;
+
+    std::vector<float> target;
+
+    for (auto& [a, b] : pairs) {
+
+        const auto count = std::max(a.segmentCount(), b.segmentCount());
+
+        subdivideTo(a, count);
+
+        subdivideTo(b, count);
+
+        if (a.area * b.area < 0) {
+
+            reverse(b);
+        }
+
+        alignStart(a, b);
+
+        morph.m_verbs.push_back(PathVerb::MoveTo);
+
+        morph.m_verbs.insert(morph.m_verbs.end(), count, PathVerb::CubicTo);
+
+        morph.m_verbs.push_back(PathVerb::ClosePath);
+
+        // the closing point is implied by ClosePath
+
+        morph.m_from.insert(morph.m_from.end(), a.points.begin(), a.points.end());
+
+        target.insert(target.end(), b.points.begin(), b.points.end());
+    }
+
+    morph.m_delta.resize(target.size());
+
+    for (size_t i = 0; i < target.size(); ++i) {
+
+        morph.m_delta[i] = target[i] - morph.m_from[i];
+    }
+
+    return morph;
+}
+
+const PathMorph PathMorph::build(
+    const std::vector<std::vector<PathCommand>>& from,
+    const std::vector<std::vector<PathCommand>>& to)
+{
+    return PathMorph::build(PathBufferBuilder::fromSubPaths(from), PathBufferBuilder::fromSubPaths(to));
+}
+
+///
+
+void PathMorph::interpolate(
+    float t,
+    float* coordinates) const
+{
+    const auto count = m_from.size();
+
+    const auto* from = m_from.data();
+
+    const auto* delta = m_delta.data();
+
+    const auto factor = simdSplat(t);
+
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+
+        simdStore(coordinates + i, simdLoad(from + i) + simdLoad(delta + i) * factor);
+
+        simdStore(coordinates + i + 4, simdLoad(from + i + 4) + simdLoad(delta + i + 4) * factor);
+    }
+
+    for (; i < count; ++i) {
+
+        coordinates[i] = from[i] + delta[i] * t;
+    }
+}
+
+void PathMorph::interpolate(
+    float t,
+    PathBuffer& buffer) const
+{
+    if (buffer.verbs != m_verbs) {
+
+        buffer.verbs = m_verbs;
+    }
+
+    buffer.coordinates.resize(m_from.size());
+
+    buffer.arcs.clear();
+
+    interpolate(t, buffer.coordinates.data());
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Path.h"
+#include "PathBuffer.h"
+
+// morphing
+
+// Two paths brought to the same shape, so that every frame of an animation
+// between them is a straight interpolation of one coordinate array.
+//
+// Both paths are normalised to closed contours of cubics (lines and quadratics
+// are raised, arcs converted). Contours are paired greedily by how close their
+// centroids and areas are; a contour left without a partner morphs to or from a
+// point at its own centroid. Within a pair the shorter contour has its longest
+// segments halved until the counts match, the target is reversed if it winds the
+// other way, and its starting segment is rotated to the one that travels least.
+
+class PathMorph final {
+public:
+    static const PathMorph build(
+        const PathBuffer& from,
+        const PathBuffer& to);
+
+    static const PathMorph build(
+        const std::vector<std::vector<PathCommand>>& from,
+        const std::vector<std::vector<PathCommand>>& to);
+
+    ///
+
+    const std::vector<PathVerb>& verbs() const { return m_verbs; }
+
+    const size_t coordinateCount() const { return m_from.size(); }
+
+    // Writes `coordinateCount()` floats: from + (to - from) * t, four lanes at a
+    // time. `t` outside [0, 1] extrapolates, for overshooting easing curves.
+
+    void interpolate(
+        float t,
+        float* coordinates) const;
+
+    // Fills `buffer` with the path at `t`; once the buffer has been through one
+    // call it is reused without allocating.
+
+    void interpolate(
+        float t,
+        PathBuffer& buffer) const;
+
+private:
+    std::vector<PathVerb> m_verbs;
+
+    std::vector<float> m_from;
+
+    std::vector<float> m_delta;
+};
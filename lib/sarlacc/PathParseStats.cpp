@@ -0,0 +1,189 @@
+#include "PathParseStats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <iterator>
+#include <tuple>
+
+// parse statistics
+
+namespace {
+
+thread_local PathParseStats* currentStats = nullptr;
+
+// small stable ids read better in a trace than hashed thread ids
+
+uint32_t threadId()
+{
+    static std::atomic<uint32_t> next = 1;
+
+    thread_local const auto id = next.fetch_add(1, std::memory_order_relaxed);
+
+    return id;
+}
+
+constexpr const char* commandNames[] = {
+    "MoveTo",
+    "LineTo",
+    "HorizontalLineTo",
+    "VerticalLineTo",
+    "ClosePath",
+    "CurveTo",
+    "SmoothCurveTo",
+    "QuadraticBezierCurveTo",
+    "SmoothQuadraticBezierCurveTo",
+    "EllipticalArc",
+};
+
+constexpr const char* tokenNames[] = {
+    "Command",
+    "Number",
+    "Punc",
+    "Unknown",
+    "Eof",
+};
+
+static_assert(std::size(commandNames) == std::tuple_size_v<decltype(PathParseStats::commandCounts)>);
+
+static_assert(std::size(tokenNames) == std::tuple_size_v<decltype(PathParseStats::tokenCounts)>);
+
+void appendMicroseconds(
+    std::string& json,
+    uint64_t nanoseconds)
+{
+    char buffer[32];
+
+    std::snprintf(buffer, sizeof(buffer), "%.3f", double(nanoseconds) / 1000);
+
+    json += buffer;
+}
+
+}
+
+void PathParseStats::merge(
+    const PathParseStats& other)
+{
+    bytesLexed += other.bytesLexed;
+
+    for (size_t i = 0; i < tokenCounts.size(); ++i) {
+
+        tokenCounts[i] += other.tokenCounts[i];
+    }
+
+    for (size_t i = 0; i < commandCounts.size(); ++i) {
+
+        commandCounts[i] += other.commandCounts[i];
+
+        commandNanoseconds[i] += other.commandNanoseconds[i];
+    }
+
+    lexNanoseconds += other.lexNanoseconds;
+
+    parseNanoseconds += other.parseNanoseconds;
+
+    events.insert(events.end(), other.events.begin(), other.events.end());
+}
+
+const std::string PathParseStats::toChromeTrace() const
+{
+    std::string json = "{\"traceEvents\":[";
+
+    for (const auto& event : events) {
+
+        json += "{\"name\":\"";
+
+        json += event.name;
+
+        json += "\",\"cat\":\"sarlacc\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+
+        json += std::to_string(event.thread);
+
+        json += ",\"ts\":";
+
+        appendMicroseconds(json, event.startNanoseconds);
+
+        json += ",\"dur\":";
+
+        appendMicroseconds(json, event.durationNanoseconds);
+
+        json += "},";
+    }
+
+    ///
+
+    json += "{\"name\":\"totals\",\"ph\":\"i\",\"s\":\"g\",\"ts\":0,\"pid\":1,\"tid\":0,\"args\":{\"bytesLexed\":";
+
+    json += std::to_string(bytesLexed);
+
+    json += ",\"lexNanoseconds\":" + std::to_string(lexNanoseconds);
+
+    json += ",\"parseNanoseconds\":" + std::to_string(parseNanoseconds);
+
+    for (size_t i = 0; i < tokenCounts.size(); ++i) {
+
+        json += ",\"tokens." + std::string(tokenNames[i]) + "\":" + std::to_string(tokenCounts[i]);
+    }
+
+    for (size_t i = 0; i < commandCounts.size(); ++i) {
+
+        json += ",\"commands." + std::string(commandNames[i]) + "\":" + std::to_string(commandCounts[i]);
+
+        json += ",\"commandNanoseconds." + std::string(commandNames[i]) + "\":" + std::to_string(commandNanoseconds[i]);
+    }
+
+    json += "}}],\"displayTimeUnit\":\"ns\"}";
+
+    return json;
+}
+
+PathParseStats* PathParseStats::current()
+{
+    return currentStats;
+}
+
+const char* PathParseStats::commandName(
+    size_t commandType)
+{
+    return commandType < std::size(commandNames) ? commandNames[commandType] : "Unknown";
+}
+
+///
+
+PathParseStatsScope::PathParseStatsScope(
+    PathParseStats& stats)
+    : m_previous(currentStats)
+{
+    currentStats = &stats;
+}
+
+PathParseStatsScope::~PathParseStatsScope()
+{
+    currentStats = m_previous;
+}
+
+PathParseStatsTimer::~PathParseStatsTimer()
+{
+    if (m_stats == nullptr) {
+
+        return;
+    }
+
+    const auto duration = now() - m_start;
+
+    if (m_total != nullptr) {
+
+        m_stats->*m_total += duration;
+    }
+
+    if (m_command < m_stats->commandCounts.size()) {
+
+        m_stats->commandCounts[m_command] += 1;
+
+        m_stats->commandNanoseconds[m_command] += duration;
+    }
+
+    if (m_stats->recordEvents) {
+
+        m_stats->events.push_back({ m_name, m_start, duration, threadId() });
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// parse statistics
+
+// One span of parsing work, as a Chrome trace "complete" event. Names are
+// static strings.
+
+struct PathTraceEvent {
+    const char* name;
+    uint64_t startNanoseconds;
+    uint64_t durationNanoseconds;
+    uint32_t thread;
+};
+
+struct PathParseStats {
+    uint64_t bytesLexed = 0;
+
+    // indexed by PathTokenType
+    std::array<uint64_t, 5> tokenCounts { };
+
+    // indexed by PathCommandType
+    std::array<uint64_t, 10> commandCounts { };
+
+    std::array<uint64_t, 10> commandNanoseconds { };
+
+    uint64_t lexNanoseconds = 0;
+
+    uint64_t parseNanoseconds = 0;
+
+    // events are only kept when asked for, since there is one per command
+    bool recordEvents = false;
+
+    std::vector<PathTraceEvent> events;
+
+    void merge(
+        const PathParseStats& other);
+
+    // The events as trace-event JSON for chrome://tracing or Perfetto, with the
+    // totals attached to a global instant event.
+
+    const std::string toChromeTrace() const;
+
+    ///
+
+    // The stats the calling thread is collecting into, if any.
+
+    static PathParseStats* current();
+
+    static const char* commandName(
+        size_t commandType);
+};
+
+// Collects into `stats` on this thread until destroyed; scopes nest.
+
+class PathParseStatsScope final {
+public:
+    explicit PathParseStatsScope(
+        PathParseStats& stats);
+
+    ~PathParseStatsScope();
+
+    PathParseStatsScope(const PathParseStatsScope&) = delete;
+
+    PathParseStatsScope& operator=(const PathParseStatsScope&) = delete;
+
+private:
+    PathParseStats* m_previous;
+};
+
+// Times a phase or a command into the current stats, if there are any.
+
+class PathParseStatsTimer final {
+public:
+    PathParseStatsTimer(
+        const char* name,
+        uint64_t PathParseStats::*total)
+        : m_stats(PathParseStats::current())
+        , m_name(name)
+        , m_total(total)
+    {
+        if (m_stats != nullptr) {
+
+            m_start = now();
+        }
+    }
+
+    PathParseStatsTimer(
+        size_t commandType)
+        : PathParseStatsTimer(PathParseStats::commandName(commandType), nullptr)
+    {
+        m_command = commandType;
+    }
+
+    ~PathParseStatsTimer();
+
+    PathParseStatsTimer(const PathParseStatsTimer&) = delete;
+
+    PathParseStatsTimer& operator=(const PathParseStatsTimer&) = delete;
+
+    static uint64_t now()
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    PathParseStats* m_stats;
+
+    const char* m_name;
+
+    uint64_t PathParseStats::*m_total;
+
+    size_t m_command = SIZE_MAX;
+
+    uint64_t m_start = 0;
+};
+
+///
+
+// Instrumentation hooks for the lexer and parser. Configure with
+// SARLACC_PARSE_STATS to compile them in; otherwise they expand to nothing.
+
+#if defined(SARLACC_PARSE_STATS)
+
+#define SARLACC_STATS_PHASE(name, total) \
+    PathParseStatsTimer sarlaccStatsPhase(name, &PathParseStats::total)
+
+#define SARLACC_STATS_COMMAND(type) \
+    PathParseStatsTimer sarlaccStatsCommand(size_t(type))
+
+#define SARLACC_STATS_ADD(field, amount)                           \
+    do {                                                           \
+        if (auto* sarlaccStats = PathParseStats::current()) {      \
+            sarlaccStats->field += (amount);                       \
+        }                                                          \
+    } while (false)
+
+#define SARLACC_STATS_COUNT(counts, index) \
+    SARLACC_STATS_ADD(counts[size_t(index)], 1)
+
+#else
+
+#define SARLACC_STATS_PHASE(name, total)
+
+#define SARLACC_STATS_COMMAND(type)
+
+#define SARLACC_STATS_ADD(field, amount)
+
+#define SARLACC_STATS_COUNT(counts, index)
+
+#endif
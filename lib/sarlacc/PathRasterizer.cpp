@@ -0,0 +1,248 @@
+#include "PathRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// rasterization
+
+namespace {
+
+// Rows of the accumulation buffer carry two spare cells: a line touching the
+// right edge writes one cell past the last pixel, and its neighbour one further.
+
+constexpr int rowPadding = 2;
+
+void accumulateLine(
+    float* cells,
+    int width,
+    int height,
+    float x0,
+    float y0,
+    float x1,
+    float y1)
+{
+    if (y0 == y1) {
+
+        return;
+    }
+
+    auto direction = 1.0f;
+
+    if (y0 > y1) {
+
+        std::swap(x0, x1);
+
+        std::swap(y0, y1);
+
+        direction = -1.0f;
+    }
+
+    const auto dxdy = (x1 - x0) / (y1 - y0);
+
+    auto x = x0;
+
+    if (y0 < 0) {
+
+        x -= y0 * dxdy;
+    }
+
+    const auto rowBegin = std::max(0, int(std::floor(y0)));
+
+    const auto rowEnd = std::min(height, int(std::ceil(y1)));
+
+    const auto stride = width + rowPadding;
+
+    ///
+
+    for (auto row = rowBegin; row < rowEnd; ++row) {
+
+        auto* line = cells + size_t(row) * stride;
+
+        const auto dy = std::min(float(row + 1), y1) - std::max(float(row), y0);
+
+        const auto next = x + dxdy * dy;
+
+        const auto d = dy * direction;
+
+        const auto left = std::min(x, next);
+
+        const auto right = std::max(x, next);
+
+        const auto leftFloor = std::floor(left);
+
+        const auto leftCell = int(leftFloor);
+
+        const auto rightCell = int(std::ceil(right));
+
+        if (rightCell <= leftCell + 1) {
+
+            // within one pixel: split by the trapezoid's mean x
+
+            const auto mean = 0.5f * (x + next) - leftFloor;
+
+            line[leftCell] += d - d * mean;
+
+            line[leftCell + 1] += d * mean;
+        } else {
+
+            const auto slope = 1 / (right - left);
+
+            const auto leftFraction = left - leftFloor;
+
+            const auto first = 0.5f * slope * (1 - leftFraction) * (1 - leftFraction);
+
+            const auto rightFraction = right - float(rightCell) + 1;
+
+            const auto last = 0.5f * slope * rightFraction * rightFraction;
+
+            line[leftCell] += d * first;
+
+            if (rightCell == leftCell + 2) {
+
+                line[leftCell + 1] += d * (1 - first - last);
+            } else {
+
+                const auto second = slope * (1.5f - leftFraction);
+
+                line[leftCell + 1] += d * (second - first);
+
+                for (auto cell = leftCell + 2; cell < rightCell - 1; ++cell) {
+
+                    line[cell] += d * slope;
+                }
+
+                const auto penultimate = second + float(rightCell - leftCell - 3) * slope;
+
+                line[rightCell - 1] += d * (1 - penultimate - last);
+            }
+
+            line[rightCell] += d * last;
+        }
+
+        x = next;
+    }
+}
+
+// Pieces left of the target are moved onto its left edge, where the row sum still
+// counts their winding; pieces right of it land in the spare cells. A line is
+// split where it crosses either edge so that only whole pieces are moved.
+
+void clipLine(
+    float* cells,
+    int width,
+    int height,
+    float x0,
+    float y0,
+    float x1,
+    float y1)
+{
+    const auto right = float(width);
+
+    float splits[4] = { 0, 1, 1, 1 };
+
+    auto count = 1;
+
+    for (const auto edge : { 0.0f, right }) {
+
+        if ((x0 < edge) != (x1 < edge)) {
+
+            splits[count++] = (edge - x0) / (x1 - x0);
+        }
+    }
+
+    splits[count++] = 1;
+
+    if (count == 4 && splits[1] > splits[2]) {
+
+        std::swap(splits[1], splits[2]);
+    }
+
+    auto fromX = x0, fromY = y0;
+
+    for (auto i = 1; i < count; ++i) {
+
+        const auto t = splits[i];
+
+        const auto toX = i + 1 == count ? x1 : x0 + t * (x1 - x0);
+
+        const auto toY = i + 1 == count ? y1 : y0 + t * (y1 - y0);
+
+        accumulateLine(cells, width, height, std::clamp(fromX, 0.0f, right), fromY, std::clamp(toX, 0.0f, right), toY);
+
+        fromX = toX;
+
+        fromY = toY;
+    }
+}
+
+}
+
+void PathRasterizer::rasterize(
+    const PathPolylines& polylines,
+    PathFillRule fillRule,
+    int width,
+    int height,
+    uint8_t* coverage,
+    size_t stride,
+    std::vector<float>& accumulation)
+{
+    if (width <= 0 || height <= 0) {
+
+        return;
+    }
+
+    const auto cellStride = size_t(width + rowPadding);
+
+    accumulation.assign(cellStride * height, 0.0f);
+
+    ///
+
+    const auto& p = polylines.points;
+
+    for (size_t contour = 0; contour < polylines.contourCount(); ++contour) {
+
+        const auto start = polylines.contourStart(contour);
+
+        const auto end = polylines.contourEnds[contour];
+
+        for (auto i = start + 1; i < end; ++i) {
+
+            clipLine(accumulation.data(), width, height, p[i * 2 - 2], p[i * 2 - 1], p[i * 2], p[i * 2 + 1]);
+        }
+
+        if (!polylines.contourClosed[contour]) {
+
+            clipLine(accumulation.data(), width, height, p[end * 2 - 2], p[end * 2 - 1], p[start * 2], p[start * 2 + 1]);
+        }
+    }
+
+    ///
+
+    for (auto row = 0; row < height; ++row) {
+
+        const auto* cells = accumulation.data() + row * cellStride;
+
+        auto* out = coverage + row * stride;
+
+        auto winding = 0.0f;
+
+        for (auto column = 0; column < width; ++column) {
+
+            winding += cells[column];
+
+            auto value = std::abs(winding);
+
+            if (fillRule == PathFillRule::EvenOdd) {
+
+                value = std::fmod(value, 2.0f);
+
+                value = value > 1 ? 2 - value : value;
+            } else {
+
+                value = std::min(value, 1.0f);
+            }
+
+            out[column] = uint8_t(value * 255 + 0.5f);
+        }
+    }
+}
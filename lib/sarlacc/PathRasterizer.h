@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PathBuffer.h"
+#include "PathFlattener.h"
+
+// rasterization
+
+class PathRasterizer final {
+public:
+    // Anti-aliased coverage of flattened contours already in pixel space (y down).
+    // Every edge adds its exact signed area to an accumulation buffer, and a
+    // running sum along each row turns that into winding coverage, so the cost is
+    // proportional to the outline's length plus the pixel count. Contours are
+    // closed as for filling, and geometry outside the target is clipped.
+    //
+    // `accumulation` is scratch space that callers can reuse between calls.
+
+    static void rasterize(
+        const PathPolylines& polylines,
+        PathFillRule fillRule,
+        int width,
+        int height,
+        uint8_t* coverage,
+        size_t stride,
+        std::vector<float>& accumulation);
+};
@@ -0,0 +1,311 @@
+#include "PathScalar.h"
+
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+// scalar conversion
+
+namespace {
+
+constexpr uint64_t maxExactMantissa = 1000000000000000000ull;
+
+constexpr int maxExponent = 100000;
+
+constexpr float exactFloatPowersOfTen[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+constexpr double exactDoublePowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool isDecimalDigit(
+    const char& c)
+{
+    return c >= '0' && c <= '9';
+}
+
+template <typename T, typename Convert>
+const std::optional<T> fromCharsSlow(
+    std::string_view source,
+    Convert convert)
+{
+    // the rare literals that fall off the exact fast path go through the C library,
+    // which needs a terminated copy
+
+    char buffer[64];
+
+    if (source.size() < sizeof(buffer)) {
+
+        source.copy(buffer, source.size());
+
+        buffer[source.size()] = '\0';
+
+        return convert(buffer);
+    }
+
+    const std::string copy(source);
+
+    return convert(copy.c_str());
+}
+
+}
+
+const std::optional<PathDecimal> PathDecimalScanner::scan(
+    std::string_view source)
+{
+    PathDecimal decimal { 0, 0, false, false };
+
+    size_t i = 0;
+
+    if (i < source.size() && (source[i] == '-' || source[i] == '+')) {
+
+        decimal.negative = source[i] == '-';
+
+        ++i;
+    }
+
+    ///
+
+    auto digits = 0;
+
+    for (; i < source.size() && isDecimalDigit(source[i]); ++i, ++digits) {
+
+        const auto digit = source[i] - '0';
+
+        if (decimal.mantissa < maxExactMantissa) {
+
+            decimal.mantissa = decimal.mantissa * 10 + digit;
+        } else {
+
+            decimal.exponent += 1;
+
+            decimal.inexact |= digit != 0;
+        }
+    }
+
+    if (i < source.size() && source[i] == '.') {
+
+        ++i;
+
+        for (; i < source.size() && isDecimalDigit(source[i]); ++i, ++digits) {
+
+            const auto digit = source[i] - '0';
+
+            if (decimal.mantissa < maxExactMantissa) {
+
+                decimal.mantissa = decimal.mantissa * 10 + digit;
+
+                decimal.exponent -= 1;
+            } else {
+
+                decimal.inexact |= digit != 0;
+            }
+        }
+    }
+
+    if (digits == 0) {
+
+        return std::nullopt;
+    }
+
+    ///
+
+    if (i < source.size() && (source[i] == 'e' || source[i] == 'E')) {
+
+        auto j = i + 1;
+
+        auto negativeExponent = false;
+
+        if (j < source.size() && (source[j] == '-' || source[j] == '+')) {
+
+            negativeExponent = source[j] == '-';
+
+            ++j;
+        }
+
+        if (j < source.size() && isDecimalDigit(source[j])) {
+
+            auto exponent = 0;
+
+            for (; j < source.size() && isDecimalDigit(source[j]); ++j) {
+
+                if (exponent < maxExponent) {
+
+                    exponent = exponent * 10 + (source[j] - '0');
+                }
+            }
+
+            decimal.exponent += negativeExponent ? -exponent : exponent;
+        }
+    }
+
+    ///
+
+    return decimal;
+}
+
+///
+
+const std::optional<float> PathScalar<float>::fromChars(
+    std::string_view source)
+{
+    const auto decimal = PathDecimalScanner::scan(source);
+
+    if (!decimal.has_value()) {
+
+        return std::nullopt;
+    }
+
+    ///
+
+    const auto& d = decimal.value();
+
+    if (d.mantissa == 0) {
+
+        return d.negative ? -0.0f : 0.0f;
+    }
+
+    // both operands are exact in single precision, so one multiply or divide
+    // rounds correctly
+
+    if (!d.inexact
+        && d.mantissa <= (uint64_t(1) << 24)
+        && d.exponent >= -10
+        && d.exponent <= 10) {
+
+        const auto mantissa = float(d.mantissa);
+
+        const auto value = d.exponent >= 0
+            ? mantissa * exactFloatPowersOfTen[d.exponent]
+            : mantissa / exactFloatPowersOfTen[-d.exponent];
+
+        return d.negative ? -value : value;
+    }
+
+    ///
+
+    return fromCharsSlow<float>(source, [](const char* terminated) {
+        return std::strtof(terminated, nullptr);
+    });
+}
+
+const std::optional<double> PathScalar<double>::fromChars(
+    std::string_view source)
+{
+    const auto decimal = PathDecimalScanner::scan(source);
+
+    if (!decimal.has_value()) {
+
+        return std::nullopt;
+    }
+
+    ///
+
+    const auto& d = decimal.value();
+
+    if (d.mantissa == 0) {
+
+        return d.negative ? -0.0 : 0.0;
+    }
+
+    if (!d.inexact
+        && d.mantissa <= (uint64_t(1) << 53)
+        && d.exponent >= -22
+        && d.exponent <= 22) {
+
+        const auto mantissa = double(d.mantissa);
+
+        const auto value = d.exponent >= 0
+            ? mantissa * exactDoublePowersOfTen[d.exponent]
+            : mantissa / exactDoublePowersOfTen[-d.exponent];
+
+        return d.negative ? -value : value;
+    }
+
+    ///
+
+    return fromCharsSlow<double>(source, [](const char* terminated) {
+        return std::strtod(terminated, nullptr);
+    });
+}
+
+template <int FractionBits>
+const std::optional<Fixed<FractionBits>> PathScalar<Fixed<FractionBits>>::fromChars(
+    std::string_view source)
+{
+    const auto decimal = PathDecimalScanner::scan(source);
+
+    if (!decimal.has_value()) {
+
+        return std::nullopt;
+    }
+
+    ///
+
+    // fixed point is rounded straight from the decimal digits with integer
+    // arithmetic, without an intermediate float
+
+    const auto& d = decimal.value();
+
+    using Wide = unsigned __int128;
+
+    const auto limit = Wide(std::numeric_limits<int32_t>::max()) + (d.negative ? 1 : 0);
+
+    Wide raw = 0;
+
+    if (d.mantissa == 0) {
+
+        raw = 0;
+    } else if (d.exponent >= 0) {
+
+        // checked as it grows, since a large enough exponent would otherwise
+        // wrap even 128 bits back into range
+
+        raw = d.mantissa;
+
+        for (auto i = 0; i < d.exponent; ++i) {
+
+            if (raw > limit) {
+
+                return std::nullopt;
+            }
+
+            raw *= 10;
+        }
+
+        if (raw > (limit >> FractionBits)) {
+
+            return std::nullopt;
+        }
+
+        raw <<= FractionBits;
+    } else if (d.exponent >= -38) {
+
+        Wide divisor = 1;
+
+        for (auto i = 0; i < -d.exponent; ++i) {
+
+            divisor *= 10;
+        }
+
+        raw = ((Wide(d.mantissa) << FractionBits) + divisor / 2) / divisor;
+    }
+
+    if (raw > limit) {
+
+        return std::nullopt;
+    }
+
+    ///
+
+    const auto magnitude = int64_t(raw);
+
+    return Fixed<FractionBits>::fromRaw(int32_t(d.negative ? -magnitude : magnitude));
+}
+
+template struct PathScalar<Fixed16_16>;
+
+template struct PathScalar<Fixed24_8>;
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// fixed point
+
+template <int FractionBits>
+class Fixed {
+public:
+    static_assert(FractionBits > 0 && FractionBits < 31, "fraction bits must leave room for sign and integer bits");
+
+    static constexpr int fractionBits = FractionBits;
+
+    static constexpr int32_t one = int32_t(1) << FractionBits;
+
+    ///
+
+    constexpr Fixed() = default;
+
+    static constexpr Fixed fromRaw(
+        int32_t raw)
+    {
+        Fixed fixed;
+
+        fixed.m_raw = raw;
+
+        return fixed;
+    }
+
+    // Saturates values out of range, and takes NaN as zero, rather than
+    // leave the conversion undefined.
+
+    static constexpr Fixed fromDouble(
+        double value)
+    {
+        const auto scaled = value * double(one);
+
+        if (scaled != scaled) {
+            return fromRaw(0);
+        }
+
+        if (scaled >= double(INT32_MAX)) {
+            return fromRaw(INT32_MAX);
+        }
+
+        if (scaled <= double(INT32_MIN)) {
+            return fromRaw(INT32_MIN);
+        }
+
+        return fromRaw(int32_t(scaled < 0 ? scaled - 0.5 : scaled + 0.5));
+    }
+
+    ///
+
+    constexpr int32_t raw() const { return m_raw; }
+
+    constexpr float toFloat() const { return float(m_raw) / float(one); }
+
+    constexpr double toDouble() const { return double(m_raw) / double(one); }
+
+    ///
+
+    // Arithmetic is done in 64 bits and saturates to the representable range
+    // rather than wrap, as conversion does.
+
+    constexpr Fixed operator-() const { return saturated(-int64_t(m_raw)); }
+
+    constexpr Fixed operator+(Fixed other) const { return saturated(int64_t(m_raw) + other.m_raw); }
+
+    constexpr Fixed operator-(Fixed other) const { return saturated(int64_t(m_raw) - other.m_raw); }
+
+    constexpr Fixed operator*(Fixed other) const
+    {
+        return saturated((int64_t(m_raw) * other.m_raw) >> FractionBits);
+    }
+
+    // Dividing by zero gives the largest value with the dividend's sign, as a
+    // float's infinity would.
+
+    constexpr Fixed operator/(Fixed other) const
+    {
+        if (other.m_raw == 0) {
+            return fromRaw(m_raw < 0 ? INT32_MIN : INT32_MAX);
+        }
+
+        return saturated((int64_t(m_raw) * one) / other.m_raw);
+    }
+
+    constexpr bool operator==(const Fixed&) const = default;
+
+    constexpr auto operator<=>(const Fixed&) const = default;
+
+private:
+    static constexpr Fixed saturated(
+        int64_t raw)
+    {
+        return fromRaw(int32_t(std::clamp<int64_t>(raw, INT32_MIN, INT32_MAX)));
+    }
+
+    int32_t m_raw = 0;
+};
+
+using Fixed16_16 = Fixed<16>;
+
+using Fixed24_8 = Fixed<8>;
+
+///
+
+// scalar conversion
+
+// A decimal literal split into an exact integer mantissa and a power of ten, so
+// every coordinate type can round it once, from the digits, with its own rules.
+
+struct PathDecimal {
+    uint64_t mantissa;
+    int exponent;
+    bool negative;
+    bool inexact;
+};
+
+class PathDecimalScanner final {
+public:
+    // Scans the longest decimal prefix of `source` (matching `std::stof`), returning
+    // std::nullopt when there is no leading digit to convert.
+
+    static const std::optional<PathDecimal> scan(
+        std::string_view source);
+};
+
+///
+
+template <typename T>
+struct PathScalar;
+
+template <>
+struct PathScalar<float> {
+    static const std::optional<float> fromChars(
+        std::string_view source);
+
+    static double toDouble(float value) { return value; }
+
+    static float fromDouble(double value) { return float(value); }
+};
+
+template <>
+struct PathScalar<double> {
+    static const std::optional<double> fromChars(
+        std::string_view source);
+
+    static double toDouble(double value) { return value; }
+
+    static double fromDouble(double value) { return value; }
+};
+
+template <int FractionBits>
+struct PathScalar<Fixed<FractionBits>> {
+    static const std::optional<Fixed<FractionBits>> fromChars(
+        std::string_view source);
+
+    static double toDouble(Fixed<FractionBits> value) { return value.toDouble(); }
+
+    static Fixed<FractionBits> fromDouble(double value) { return Fixed<FractionBits>::fromDouble(value); }
+};
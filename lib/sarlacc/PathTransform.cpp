@@ -0,0 +1,332 @@
+#include "PathTransform.h"
+
+#include <cmath>
+#include <type_traits>
+
+#include "PathGeometry.h"
+#include "Simd.h"
+
+// path matrices
+
+const PathMatrix PathMatrix::makeIdentity()
+{
+    return PathMatrix { {
+        { 1, 0, 0 },
+        { 0, 1, 0 },
+        { 0, 0, 1 },
+    } };
+}
+
+const PathMatrix PathMatrix::makeTranslate(
+    double x,
+    double y)
+{
+    return PathMatrix { {
+        { 1, 0, 0 },
+        { 0, 1, 0 },
+        { x, y, 1 },
+    } };
+}
+
+const PathMatrix PathMatrix::makeScale(
+    double x,
+    double y)
+{
+    return PathMatrix { {
+        { x, 0, 0 },
+        { 0, y, 0 },
+        { 0, 0, 1 },
+    } };
+}
+
+const PathMatrix PathMatrix::makeZRotate(
+    double angleRadians)
+{
+    const auto c = std::cos(angleRadians);
+
+    const auto s = std::sin(angleRadians);
+
+    // rows { c, s }, { -s, c } as in math::makeZRotate
+
+    return PathMatrix { {
+        { c, -s, 0 },
+        { s, c, 0 },
+        { 0, 0, 1 },
+    } };
+}
+
+const PathMatrix PathMatrix::fromMatrix4x4(
+    const float* columns)
+{
+    constexpr int axes[] = { 0, 1, 3 };
+
+    PathMatrix matrix;
+
+    for (auto column = 0; column < 3; ++column) {
+
+        for (auto row = 0; row < 3; ++row) {
+
+            matrix.columns[column][row] = columns[axes[column] * 4 + axes[row]];
+        }
+    }
+
+    return matrix;
+}
+
+const PathMatrix PathMatrix::operator*(
+    const PathMatrix& other) const
+{
+    PathMatrix result;
+
+    for (auto column = 0; column < 3; ++column) {
+
+        for (auto row = 0; row < 3; ++row) {
+
+            result.columns[column][row] = columns[0][row] * other.columns[column][0]
+                + columns[1][row] * other.columns[column][1]
+                + columns[2][row] * other.columns[column][2];
+        }
+    }
+
+    return result;
+}
+
+const bool PathMatrix::isAffine() const
+{
+    return columns[0][2] == 0 && columns[1][2] == 0 && columns[2][2] == 1;
+}
+
+///
+
+// path transforms
+
+namespace {
+
+// Interleaved pairs are transformed two lanes at a time: with v = (x, y) and
+// swap(v) = (y, x), the affine image is (a, d) * v + (c, b) * swap(v) + (e, f),
+// which keeps the kernel free of shuffles beyond one pair swap per vector.
+
+void transformPointsFloat(
+    const float* source,
+    float* destination,
+    size_t pointCount,
+    const PathMatrix& m)
+{
+    const auto a = float(m.columns[0][0]);
+    const auto b = float(m.columns[0][1]);
+    const auto c = float(m.columns[1][0]);
+    const auto d = float(m.columns[1][1]);
+    const auto e = float(m.columns[2][0]);
+    const auto f = float(m.columns[2][1]);
+
+    const auto count = pointCount * 2;
+
+    size_t i = 0;
+
+    ///
+
+    const SimdFloat4 diagonal = { a, d, a, d };
+
+    const SimdFloat4 cross = { c, b, c, b };
+
+    const SimdFloat4 translation = { e, f, e, f };
+
+    if (m.isAffine()) {
+
+        for (; i + 8 <= count; i += 8) {
+
+            const auto v0 = simdLoad(source + i);
+
+            const auto v1 = simdLoad(source + i + 4);
+
+            simdStore(destination + i, diagonal * v0 + cross * simdSwapPairs(v0) + translation);
+
+            simdStore(destination + i + 4, diagonal * v1 + cross * simdSwapPairs(v1) + translation);
+        }
+
+        for (; i < count; i += 2) {
+
+            const auto x = source[i];
+
+            const auto y = source[i + 1];
+
+            destination[i] = a * x + c * y + e;
+
+            destination[i + 1] = b * x + d * y + f;
+        }
+
+        return;
+    }
+
+    ///
+
+    const auto g = float(m.columns[0][2]);
+    const auto h = float(m.columns[1][2]);
+    const auto w = float(m.columns[2][2]);
+
+    const SimdFloat4 weightDiagonal = { g, h, g, h };
+
+    const SimdFloat4 weightCross = { h, g, h, g };
+
+    const auto weightOffset = simdSplat(w);
+
+    for (; i + 4 <= count; i += 4) {
+
+        const auto v = simdLoad(source + i);
+
+        const auto swapped = simdSwapPairs(v);
+
+        const auto weight = weightDiagonal * v + weightCross * swapped + weightOffset;
+
+        simdStore(destination + i, (diagonal * v + cross * swapped + translation) / weight);
+    }
+
+    for (; i < count; i += 2) {
+
+        const auto x = source[i];
+
+        const auto y = source[i + 1];
+
+        const auto weight = g * x + h * y + w;
+
+        destination[i] = (a * x + c * y + e) / weight;
+
+        destination[i + 1] = (b * x + d * y + f) / weight;
+    }
+}
+
+void transformPointsDouble(
+    const double* source,
+    double* destination,
+    size_t pointCount,
+    const PathMatrix& m)
+{
+    const auto& columns = m.columns;
+
+    const SimdDouble2 diagonal = { columns[0][0], columns[1][1] };
+
+    const SimdDouble2 cross = { columns[1][0], columns[0][1] };
+
+    const SimdDouble2 translation = { columns[2][0], columns[2][1] };
+
+    const SimdDouble2 weightDiagonal = { columns[0][2], columns[1][2] };
+
+    const SimdDouble2 weightCross = { columns[1][2], columns[0][2] };
+
+    const SimdDouble2 weightOffset = { columns[2][2], columns[2][2] };
+
+    const auto affine = m.isAffine();
+
+    ///
+
+    for (size_t i = 0; i < pointCount * 2; i += 2) {
+
+        const auto v = simdLoad(source + i);
+
+        const auto swapped = simdSwapPairs(v);
+
+        auto result = diagonal * v + cross * swapped + translation;
+
+        if (!affine) {
+
+            result /= weightDiagonal * v + weightCross * swapped + weightOffset;
+        }
+
+        simdStore(destination + i, result);
+    }
+}
+
+}
+
+template <typename T>
+void BasicPathTransform<T>::transformPoints(
+    const T* source,
+    T* destination,
+    size_t pointCount,
+    const PathMatrix& matrix)
+{
+    if constexpr (std::is_same_v<T, float>) {
+
+        transformPointsFloat(source, destination, pointCount, matrix);
+    } else if constexpr (std::is_same_v<T, double>) {
+
+        transformPointsDouble(source, destination, pointCount, matrix);
+    } else {
+
+        // fixed point goes through double so large translations cannot overflow
+        // the intermediate products
+
+        const auto& m = matrix.columns;
+
+        for (size_t i = 0; i < pointCount * 2; i += 2) {
+
+            const auto x = PathScalar<T>::toDouble(source[i]);
+
+            const auto y = PathScalar<T>::toDouble(source[i + 1]);
+
+            const auto weight = m[0][2] * x + m[1][2] * y + m[2][2];
+
+            destination[i] = PathScalar<T>::fromDouble((m[0][0] * x + m[1][0] * y + m[2][0]) / weight);
+
+            destination[i + 1] = PathScalar<T>::fromDouble((m[0][1] * x + m[1][1] * y + m[2][1]) / weight);
+        }
+    }
+}
+
+template <typename T>
+void BasicPathTransform<T>::transform(
+    BasicPathBuffer<T>& buffer,
+    const PathMatrix& matrix)
+{
+    if (!matrix.isAffine() && !buffer.arcs.empty()) {
+
+        buffer = BasicPathBufferBuilder<T>::withArcsAsCubics(buffer);
+    }
+
+    ///
+
+    BasicPathTransform<T>::transformPoints(
+        buffer.coordinates.data(),
+        buffer.coordinates.data(),
+        buffer.coordinates.size() / 2,
+        matrix);
+
+    ///
+
+    const auto& m = matrix.columns;
+
+    for (auto& arc : buffer.arcs) {
+
+        auto radiusX = PathScalar<T>::toDouble(arc.radiusX);
+
+        auto radiusY = PathScalar<T>::toDouble(arc.radiusY);
+
+        auto rotation = PathScalar<T>::toDouble(arc.rotation);
+
+        PathGeometry::transformArcParameters(
+            m[0][0],
+            m[0][1],
+            m[1][0],
+            m[1][1],
+            radiusX,
+            radiusY,
+            rotation,
+            arc.sweep);
+
+        arc.radiusX = PathScalar<T>::fromDouble(radiusX);
+
+        arc.radiusY = PathScalar<T>::fromDouble(radiusY);
+
+        arc.rotation = PathScalar<T>::fromDouble(rotation);
+    }
+}
+
+///
+
+template class BasicPathTransform<float>;
+
+template class BasicPathTransform<double>;
+
+template class BasicPathTransform<Fixed16_16>;
+
+template class BasicPathTransform<Fixed24_8>;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+
+#include "PathBuffer.h"
+
+// path transforms
+
+// A 2D homogeneous transform stored column-major like `simd::float3x3`, acting on
+// column vectors (x, y, 1). The factories follow the samples' `math::` helpers:
+// `makeZRotate` uses the same rows { cos, sin }, { -sin, cos }, and `a * b`
+// applies `b` first.
+
+struct PathMatrix {
+    double columns[3][3];
+
+    static const PathMatrix makeIdentity();
+
+    static const PathMatrix makeTranslate(
+        double x,
+        double y);
+
+    static const PathMatrix makeScale(
+        double x,
+        double y);
+
+    static const PathMatrix makeZRotate(
+        double angleRadians);
+
+    // The x, y and w rows and columns of a column-major 4x4 such as the
+    // `simd::float4x4` built by the samples' `math::` helpers.
+
+    static const PathMatrix fromMatrix4x4(
+        const float* columns);
+
+    const PathMatrix operator*(
+        const PathMatrix& other) const;
+
+    const bool isAffine() const;
+};
+
+///
+
+template <typename T>
+class BasicPathTransform final {
+public:
+    // Transforms `pointCount` interleaved (x, y) pairs; `source` and `destination`
+    // may alias.
+
+    static void transformPoints(
+        const T* source,
+        T* destination,
+        size_t pointCount,
+        const PathMatrix& matrix);
+
+    // Transforms a whole buffer in place. Under an affine matrix arcs keep their
+    // verb with radii, x-axis rotation and sweep recomputed; a projective matrix
+    // first converts arcs to cubics since the image of an ellipse is no longer an
+    // SVG arc.
+
+    static void transform(
+        BasicPathBuffer<T>& buffer,
+        const PathMatrix& matrix);
+};
+
+using PathTransform = BasicPathTransform<float>;
+
+extern template class BasicPathTransform<float>;
+
+extern template class BasicPathTransform<double>;
+
+extern template class BasicPathTransform<Fixed16_16>;
+
+extern template class BasicPathTransform<Fixed24_8>;
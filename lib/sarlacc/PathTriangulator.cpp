@@ -0,0 +1,686 @@
+#include "PathTriangulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+// triangulation
+
+namespace {
+
+struct Node {
+    uint32_t index;
+    double x;
+    double y;
+    Node* previous;
+    Node* next;
+    bool steiner;
+};
+
+// positive when (p, q, r) turns clockwise in a y-up frame, as in earcut
+
+double area(
+    const Node* p,
+    const Node* q,
+    const Node* r)
+{
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+bool equals(
+    const Node* a,
+    const Node* b)
+{
+    return a->x == b->x && a->y == b->y;
+}
+
+bool pointInTriangle(
+    double ax,
+    double ay,
+    double bx,
+    double by,
+    double cx,
+    double cy,
+    double px,
+    double py)
+{
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+        && (ax - px) * (by - py) >= (bx - px) * (ay - py)
+        && (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+int sign(
+    double value)
+{
+    return value > 0 ? 1 : value < 0 ? -1 : 0;
+}
+
+bool onSegment(
+    const Node* p,
+    const Node* q,
+    const Node* r)
+{
+    return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) && q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+}
+
+bool intersects(
+    const Node* p1,
+    const Node* q1,
+    const Node* p2,
+    const Node* q2)
+{
+    const auto o1 = sign(area(p1, q1, p2));
+
+    const auto o2 = sign(area(p1, q1, q2));
+
+    const auto o3 = sign(area(p2, q2, p1));
+
+    const auto o4 = sign(area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4) {
+
+        return true;
+    }
+
+    return (o1 == 0 && onSegment(p1, p2, q1))
+        || (o2 == 0 && onSegment(p1, q2, q1))
+        || (o3 == 0 && onSegment(p2, p1, q2))
+        || (o4 == 0 && onSegment(p2, q1, q2));
+}
+
+bool intersectsPolygon(
+    const Node* a,
+    const Node* b)
+{
+    auto* p = a;
+
+    do {
+
+        if (p->index != a->index && p->next->index != a->index && p->index != b->index && p->next->index != b->index
+            && intersects(p, p->next, a, b)) {
+
+            return true;
+        }
+
+        p = p->next;
+    } while (p != a);
+
+    return false;
+}
+
+bool locallyInside(
+    const Node* a,
+    const Node* b)
+{
+    return area(a->previous, a, a->next) < 0
+        ? area(a, b, a->next) >= 0 && area(a, a->previous, b) >= 0
+        : area(a, b, a->previous) < 0 || area(a, a->next, b) < 0;
+}
+
+bool middleInside(
+    const Node* a,
+    const Node* b)
+{
+    auto* p = a;
+
+    auto inside = false;
+
+    const auto px = (a->x + b->x) / 2, py = (a->y + b->y) / 2;
+
+    do {
+
+        if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y
+            && (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+
+            inside = !inside;
+        }
+
+        p = p->next;
+    } while (p != a);
+
+    return inside;
+}
+
+bool sectorContainsSector(
+    const Node* m,
+    const Node* p)
+{
+    return area(m->previous, m, p->previous) < 0 && area(p->next, m, m->next) < 0;
+}
+
+bool isValidDiagonal(
+    const Node* a,
+    const Node* b)
+{
+    return a->next->index != b->index && a->previous->index != b->index && !intersectsPolygon(a, b)
+        && ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+                && (area(a->previous, a, b->previous) != 0 || area(a, b->previous, b) != 0))
+            || (equals(a, b) && area(a->previous, a, a->next) > 0 && area(b->previous, b, b->next) > 0));
+}
+
+class EarClipper {
+public:
+    EarClipper(
+        const std::vector<float>& points,
+        std::vector<uint32_t>& indices)
+        : m_points(points)
+        , m_indices(indices)
+    {
+    }
+
+    void run(
+        const std::vector<uint32_t>& ringEnds)
+    {
+        auto* outer = ring(0, ringEnds[0], true);
+
+        if (outer == nullptr || outer->next == outer->previous) {
+
+            return;
+        }
+
+        ///
+
+        std::vector<Node*> holes;
+
+        for (size_t i = 1; i < ringEnds.size(); ++i) {
+
+            auto* hole = ring(ringEnds[i - 1], ringEnds[i], false);
+
+            if (hole == nullptr) {
+
+                continue;
+            }
+
+            if (hole == hole->next) {
+
+                hole->steiner = true;
+            }
+
+            holes.push_back(leftmost(hole));
+        }
+
+        std::sort(holes.begin(), holes.end(), [](const Node* a, const Node* b) {
+            return a->x < b->x;
+        });
+
+        for (auto* hole : holes) {
+
+            outer = eliminateHole(hole, outer);
+        }
+
+        clip(outer, 0);
+    }
+
+private:
+    Node* insert(
+        uint32_t index,
+        Node* last)
+    {
+        m_nodes.push_back({ index, m_points[index * 2], m_points[index * 2 + 1], nullptr, nullptr, false });
+
+        auto* node = &m_nodes.back();
+
+        if (last == nullptr) {
+
+            node->previous = node;
+
+            node->next = node;
+        } else {
+
+            node->next = last->next;
+
+            node->previous = last;
+
+            last->next->previous = node;
+
+            last->next = node;
+        }
+
+        return node;
+    }
+
+    void remove(
+        Node* node)
+    {
+        node->next->previous = node->previous;
+
+        node->previous->next = node->next;
+    }
+
+    // a circular list of the ring in earcut's clockwise sense, or the reverse
+
+    Node* ring(
+        uint32_t begin,
+        uint32_t end,
+        bool clockwise)
+    {
+        if (end <= begin) {
+
+            return nullptr;
+        }
+
+        auto sum = 0.0;
+
+        for (auto i = begin, j = end - 1; i < end; j = i++) {
+
+            sum += (double(m_points[j * 2]) - m_points[i * 2]) * (double(m_points[i * 2 + 1]) + m_points[j * 2 + 1]);
+        }
+
+        Node* last = nullptr;
+
+        if (clockwise == (sum > 0)) {
+
+            for (auto i = begin; i < end; ++i) {
+
+                last = insert(i, last);
+            }
+        } else {
+
+            for (auto i = end; i-- > begin;) {
+
+                last = insert(i, last);
+            }
+        }
+
+        if (last != nullptr && equals(last, last->next)) {
+
+            remove(last);
+
+            last = last->next;
+        }
+
+        return last;
+    }
+
+    // drops repeated and collinear points
+
+    Node* filter(
+        Node* start,
+        Node* end = nullptr)
+    {
+        if (start == nullptr) {
+
+            return start;
+        }
+
+        if (end == nullptr) {
+
+            end = start;
+        }
+
+        auto* p = start;
+
+        auto again = false;
+
+        do {
+
+            again = false;
+
+            if (!p->steiner && (equals(p, p->next) || area(p->previous, p, p->next) == 0)) {
+
+                remove(p);
+
+                p = end = p->previous;
+
+                if (p == p->next) {
+
+                    break;
+                }
+
+                again = true;
+            } else {
+
+                p = p->next;
+            }
+        } while (again || p != end);
+
+        return end;
+    }
+
+    void emit(
+        const Node* a,
+        const Node* b,
+        const Node* c)
+    {
+        m_indices.insert(m_indices.end(), { a->index, b->index, c->index });
+    }
+
+    ///
+
+    void clip(
+        Node* ear,
+        int pass)
+    {
+        if (ear == nullptr) {
+
+            return;
+        }
+
+        auto* stop = ear;
+
+        while (ear->previous != ear->next) {
+
+            auto* previous = ear->previous;
+
+            auto* next = ear->next;
+
+            if (isEar(ear)) {
+
+                emit(previous, ear, next);
+
+                remove(ear);
+
+                ear = next->next;
+
+                stop = next->next;
+
+                continue;
+            }
+
+            ear = next;
+
+            if (ear == stop) {
+
+                if (pass == 0) {
+
+                    clip(filter(ear), 1);
+                } else if (pass == 1) {
+
+                    clip(cureLocalIntersections(filter(ear)), 2);
+                } else {
+
+                    split(ear);
+                }
+
+                break;
+            }
+        }
+    }
+
+    bool isEar(
+        const Node* ear) const
+    {
+        const auto* a = ear->previous;
+
+        const auto* b = ear;
+
+        const auto* c = ear->next;
+
+        if (area(a, b, c) >= 0) {
+
+            return false;
+        }
+
+        const auto minX = std::min({ a->x, b->x, c->x }), maxX = std::max({ a->x, b->x, c->x });
+
+        const auto minY = std::min({ a->y, b->y, c->y }), maxY = std::max({ a->y, b->y, c->y });
+
+        for (auto* p = c->next; p != a; p = p->next) {
+
+            if (p->x >= minX && p->x <= maxX && p->y >= minY && p->y <= maxY
+                && pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+                && area(p->previous, p, p->next) >= 0) {
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    Node* cureLocalIntersections(
+        Node* start)
+    {
+        auto* p = start;
+
+        do {
+
+            auto* a = p->previous;
+
+            auto* b = p->next->next;
+
+            if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+
+                emit(a, p, b);
+
+                remove(p);
+
+                remove(p->next);
+
+                p = start = b;
+            }
+
+            p = p->next;
+        } while (p != start);
+
+        return filter(p);
+    }
+
+    void split(
+        Node* start)
+    {
+        auto* a = start;
+
+        do {
+
+            for (auto* b = a->next->next; b != a->previous; b = b->next) {
+
+                if (a->index != b->index && isValidDiagonal(a, b)) {
+
+                    auto* c = splitPolygon(a, b);
+
+                    a = filter(a, a->next);
+
+                    c = filter(c, c->next);
+
+                    clip(a, 0);
+
+                    clip(c, 0);
+
+                    return;
+                }
+            }
+
+            a = a->next;
+        } while (a != start);
+    }
+
+    // links a to b with a doubled edge, returning b's copy in the other half
+
+    Node* splitPolygon(
+        Node* a,
+        Node* b)
+    {
+        m_nodes.push_back({ a->index, a->x, a->y, nullptr, nullptr, false });
+
+        auto* a2 = &m_nodes.back();
+
+        m_nodes.push_back({ b->index, b->x, b->y, nullptr, nullptr, false });
+
+        auto* b2 = &m_nodes.back();
+
+        auto* an = a->next;
+
+        auto* bp = b->previous;
+
+        a->next = b;
+
+        b->previous = a;
+
+        a2->next = an;
+
+        an->previous = a2;
+
+        b2->next = a2;
+
+        a2->previous = b2;
+
+        bp->next = b2;
+
+        b2->previous = bp;
+
+        return b2;
+    }
+
+    ///
+
+    Node* leftmost(
+        Node* start) const
+    {
+        auto* p = start;
+
+        auto* result = start;
+
+        do {
+
+            if (p->x < result->x || (p->x == result->x && p->y < result->y)) {
+
+                result = p;
+            }
+
+            p = p->next;
+        } while (p != start);
+
+        return result;
+    }
+
+    Node* eliminateHole(
+        Node* hole,
+        Node* outer)
+    {
+        auto* bridge = findHoleBridge(hole, outer);
+
+        if (bridge == nullptr) {
+
+            return outer;
+        }
+
+        auto* bridgeReverse = splitPolygon(bridge, hole);
+
+        filter(bridgeReverse, bridgeReverse->next);
+
+        return filter(bridge, bridge->next);
+    }
+
+    // the outline point a hole's leftmost point can see by a ray to the left
+
+    Node* findHoleBridge(
+        Node* hole,
+        Node* outer) const
+    {
+        auto* p = outer;
+
+        const auto hx = hole->x, hy = hole->y;
+
+        auto qx = -std::numeric_limits<double>::infinity();
+
+        Node* m = nullptr;
+
+        do {
+
+            if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+
+                const auto x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+
+                if (x <= hx && x > qx) {
+
+                    qx = x;
+
+                    m = p->x < p->next->x ? p : p->next;
+
+                    if (x == hx) {
+
+                        return m;
+                    }
+                }
+            }
+
+            p = p->next;
+        } while (p != outer);
+
+        if (m == nullptr) {
+
+            return nullptr;
+        }
+
+        ///
+
+        auto* stop = m;
+
+        const auto mx = m->x, my = m->y;
+
+        auto tanMin = std::numeric_limits<double>::infinity();
+
+        p = m;
+
+        do {
+
+            if (hx >= p->x && p->x >= mx && hx != p->x
+                && pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+
+                const auto tan = std::abs(hy - p->y) / (hx - p->x);
+
+                if (locallyInside(p, hole)
+                    && (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p)))))) {
+
+                    m = p;
+
+                    tanMin = tan;
+                }
+            }
+
+            p = p->next;
+        } while (p != stop);
+
+        return m;
+    }
+
+    const std::vector<float>& m_points;
+
+    std::vector<uint32_t>& m_indices;
+
+    // stable addresses as nodes are added
+    std::deque<Node> m_nodes;
+};
+
+}
+
+void PathTriangulator::triangulate(
+    const std::vector<float>& points,
+    const std::vector<uint32_t>& ringEnds,
+    std::vector<uint32_t>& indices)
+{
+    if (ringEnds.empty()) {
+
+        return;
+    }
+
+    const auto first = indices.size();
+
+    EarClipper clipper(points, indices);
+
+    clipper.run(ringEnds);
+
+    // earcut winds its triangles one way; match the outline instead
+
+    auto outline = 0.0;
+
+    for (uint32_t i = 0, j = ringEnds[0] - 1; i < ringEnds[0]; j = i++) {
+
+        outline += double(points[j * 2]) * points[i * 2 + 1] - double(points[i * 2]) * points[j * 2 + 1];
+    }
+
+    for (auto i = first; i < indices.size(); i += 3) {
+
+        const auto a = indices[i], b = indices[i + 1], c = indices[i + 2];
+
+        const auto triangle = (double(points[b * 2]) - points[a * 2]) * (double(points[c * 2 + 1]) - points[a * 2 + 1])
+            - (double(points[b * 2 + 1]) - points[a * 2 + 1]) * (double(points[c * 2]) - points[a * 2]);
+
+        if ((triangle < 0) != (outline < 0)) {
+
+            std::swap(indices[i + 1], indices[i + 2]);
+        }
+    }
+}
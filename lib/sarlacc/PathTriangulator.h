@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// triangulation
+
+class PathTriangulator final {
+public:
+    // Ear clipping after mapbox/earcut. `points` holds interleaved (x, y) pairs
+    // and `ringEnds` the end of each ring within them: the first ring is the
+    // outline and any further rings are holes inside it, in either orientation,
+    // without repeating their first point. Holes are bridged into the outline,
+    // then ears are clipped, falling back to curing small self-intersections and
+    // to splitting the polygon when no ear is left.
+    //
+    // Appends triangles as indices into `points`, wound the same way as the
+    // outline.
+
+    static void triangulate(
+        const std::vector<float>& points,
+        const std::vector<uint32_t>& ringEnds,
+        std::vector<uint32_t>& indices);
+};
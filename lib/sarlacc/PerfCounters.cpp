@@ -0,0 +1,264 @@
+#include "PerfCounters.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+// hardware performance counters
+
+namespace {
+
+constexpr const char* counterNames[] = {
+    "cycles",
+    "instructions",
+    "branch-misses",
+    "L1d-misses",
+    "LLC-misses",
+};
+
+static_assert(std::size(counterNames) == perfCounterCount);
+
+#if defined(__linux__)
+
+int openCounter(
+    PerfCounter counter)
+{
+    perf_event_attr attributes;
+
+    std::memset(&attributes, 0, sizeof(attributes));
+
+    attributes.size = sizeof(attributes);
+
+    attributes.type = PERF_TYPE_HARDWARE;
+
+    switch (counter) {
+    case PerfCounter::Cycles:
+        attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+
+    case PerfCounter::Instructions:
+        attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+
+    case PerfCounter::BranchMisses:
+        attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+
+    case PerfCounter::L1DataMisses:
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.config = PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+
+    case PerfCounter::LastLevelMisses:
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    }
+
+    // user space only, which an unprivileged process may count at the default
+    // paranoia level
+
+    attributes.exclude_kernel = 1;
+
+    attributes.exclude_hv = 1;
+
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const auto fd = ::syscall(__NR_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+
+    return fd < 0 ? -1 : int(fd);
+}
+
+#endif
+
+}
+
+///
+
+const std::optional<double> PerfCounterSample::perByte(
+    PerfCounter counter,
+    uint64_t bytes) const
+{
+    const auto value = get(counter);
+
+    if (!value || bytes == 0) {
+
+        return std::nullopt;
+    }
+
+    return double(*value) / double(bytes);
+}
+
+const std::optional<double> PerfCounterSample::instructionsPerCycle() const
+{
+    const auto cycles = get(PerfCounter::Cycles);
+
+    const auto instructions = get(PerfCounter::Instructions);
+
+    if (!cycles || !instructions || *cycles == 0) {
+
+        return std::nullopt;
+    }
+
+    return double(*instructions) / double(*cycles);
+}
+
+void PerfCounterSample::merge(
+    const PerfCounterSample& other)
+{
+    for (size_t i = 0; i < perfCounterCount; ++i) {
+
+        if (other.values[i]) {
+
+            values[i] = values[i].value_or(0) + *other.values[i];
+        }
+    }
+}
+
+const std::string PerfCounterSample::summary(
+    uint64_t bytes) const
+{
+    std::string out;
+
+    for (size_t i = 0; i < perfCounterCount; ++i) {
+
+        char buffer[64];
+
+        const auto value = perByte(PerfCounter(i), bytes);
+
+        if (value) {
+
+            std::snprintf(buffer, sizeof(buffer), "%s%s %.3f/B", i > 0 ? "  " : "", counterNames[i], *value);
+        } else {
+
+            std::snprintf(buffer, sizeof(buffer), "%s%s n/a", i > 0 ? "  " : "", counterNames[i]);
+        }
+
+        out += buffer;
+    }
+
+    return out;
+}
+
+///
+
+PerfCounters::PerfCounters()
+{
+    m_fds.fill(-1);
+
+#if defined(__linux__)
+    for (size_t i = 0; i < perfCounterCount; ++i) {
+
+        m_fds[i] = openCounter(PerfCounter(i));
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (const auto fd : m_fds) {
+
+        if (fd >= 0) {
+
+            ::close(fd);
+        }
+    }
+}
+
+bool PerfCounters::available() const
+{
+    for (const auto fd : m_fds) {
+
+        if (fd >= 0) {
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PerfCounters::has(
+    PerfCounter counter) const
+{
+    return m_fds[size_t(counter)] >= 0;
+}
+
+const PerfCounterSample PerfCounters::read() const
+{
+    PerfCounterSample sample;
+
+    for (size_t i = 0; i < perfCounterCount; ++i) {
+
+        if (m_fds[i] < 0) {
+
+            continue;
+        }
+
+        // value, time enabled, time running
+
+        uint64_t data[3];
+
+        if (::read(m_fds[i], data, sizeof(data)) != ssize_t(sizeof(data))) {
+
+            continue;
+        }
+
+        // a counter that never got onto the PMU has nothing to scale
+
+        if (data[2] == 0) {
+
+            continue;
+        }
+
+        sample.values[i] = data[2] < data[1]
+            ? uint64_t(double(data[0]) * double(data[1]) / double(data[2]))
+            : data[0];
+    }
+
+    return sample;
+}
+
+const char* PerfCounters::name(
+    PerfCounter counter)
+{
+    return counterNames[size_t(counter)];
+}
+
+///
+
+PerfCounterScope::PerfCounterScope(
+    const PerfCounters& counters,
+    PerfCounterSample& into)
+    : m_counters(counters)
+    , m_into(into)
+    , m_start(counters.read())
+{
+}
+
+PerfCounterScope::~PerfCounterScope()
+{
+    const auto end = m_counters.read();
+
+    PerfCounterSample delta;
+
+    for (size_t i = 0; i < perfCounterCount; ++i) {
+
+        // scaled counts can step back slightly when multiplexing changes
+
+        if (m_start.values[i] && end.values[i]) {
+
+            delta.values[i] = *end.values[i] > *m_start.values[i] ? *end.values[i] - *m_start.values[i] : 0;
+        }
+    }
+
+    m_into.merge(delta);
+}
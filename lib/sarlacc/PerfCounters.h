@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// hardware performance counters
+
+enum class PerfCounter {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    // level 1 data cache read misses
+    L1DataMisses,
+    // last level cache misses
+    LastLevelMisses,
+};
+
+constexpr size_t perfCounterCount = 5;
+
+// Counts for a span of work. A counter the kernel or the hardware would not
+// provide has no value.
+
+struct PerfCounterSample {
+    std::array<std::optional<uint64_t>, perfCounterCount> values { };
+
+    const std::optional<uint64_t> get(
+        PerfCounter counter) const
+    {
+        return values[size_t(counter)];
+    }
+
+    const std::optional<double> perByte(
+        PerfCounter counter,
+        uint64_t bytes) const;
+
+    // Instructions per cycle, when both were counted.
+
+    const std::optional<double> instructionsPerCycle() const;
+
+    // Adds `other`'s counts into this sample's, so an empty sample can
+    // accumulate.
+
+    void merge(
+        const PerfCounterSample& other);
+
+    // One line of "name value/byte" pairs, with "n/a" for missing counters.
+
+    const std::string summary(
+        uint64_t bytes) const;
+};
+
+// Counters for the calling thread, user space only, running from construction.
+// Each counter is opened on its own, so one the machine lacks or a multiplexed
+// PMU does not take the rest with it; counts are scaled up when the kernel had
+// to time-share them.
+//
+// Off Linux, in containers without perf access, or with a restrictive
+// perf_event_paranoid, nothing opens and every read comes back empty, so
+// callers need no guards of their own. Reading is a few system calls, cheap
+// enough to sample a fraction of production parses.
+
+class PerfCounters final {
+public:
+    PerfCounters();
+
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;
+
+    bool has(
+        PerfCounter counter) const;
+
+    // Totals since construction; differences of two reads measure the work in
+    // between, on this thread only.
+
+    const PerfCounterSample read() const;
+
+    static const char* name(
+        PerfCounter counter);
+
+private:
+    std::array<int, perfCounterCount> m_fds;
+};
+
+// Adds the counts over its lifetime into `into`.
+
+class PerfCounterScope final {
+public:
+    PerfCounterScope(
+        const PerfCounters& counters,
+        PerfCounterSample& into);
+
+    ~PerfCounterScope();
+
+    PerfCounterScope(const PerfCounterScope&) = delete;
+
+    PerfCounterScope& operator=(const PerfCounterScope&) = delete;
+
+private:
+    const PerfCounters& m_counters;
+
+    PerfCounterSample& m_into;
+
+    PerfCounterSample m_start;
+};
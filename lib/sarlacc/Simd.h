@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Portable 128-bit vectors using the GCC/Clang vector extensions, which lower to
+// SSE on x86-64 and NEON on Apple silicon without per-architecture intrinsics.
+
+typedef float SimdFloat4 __attribute__((vector_size(16)));
+
+typedef double SimdDouble2 __attribute__((vector_size(16)));
+
+typedef int SimdInt4 __attribute__((vector_size(16)));
+
+typedef signed char SimdByte16 __attribute__((vector_size(16)));
+
+///
+
+inline SimdFloat4 simdLoad(
+    const float* source)
+{
+    SimdFloat4 value;
+
+    std::memcpy(&value, source, sizeof(value));
+
+    return value;
+}
+
+inline SimdDouble2 simdLoad(
+    const double* source)
+{
+    SimdDouble2 value;
+
+    std::memcpy(&value, source, sizeof(value));
+
+    return value;
+}
+
+inline SimdByte16 simdLoad(
+    const char* source)
+{
+    SimdByte16 value;
+
+    std::memcpy(&value, source, sizeof(value));
+
+    return value;
+}
+
+inline void simdStore(
+    float* destination,
+    const SimdFloat4& value)
+{
+    std::memcpy(destination, &value, sizeof(value));
+}
+
+inline void simdStore(
+    double* destination,
+    const SimdDouble2& value)
+{
+    std::memcpy(destination, &value, sizeof(value));
+}
+
+///
+
+inline SimdFloat4 simdSplat(
+    float value)
+{
+    return SimdFloat4 { value, value, value, value };
+}
+
+inline SimdByte16 simdSplatByte(
+    char value)
+{
+    const auto lane = static_cast<signed char>(value);
+
+    return SimdByte16 { lane, lane, lane, lane, lane, lane, lane, lane, lane, lane, lane, lane, lane, lane, lane, lane };
+}
+
+// The index of the first lane of a comparison result that is set, or 16 when
+// none is. Both targets are little-endian, so the lowest set byte of each half
+// is its first lane.
+
+inline int simdFirstSet(
+    const SimdByte16& mask)
+{
+    uint64_t halves[2];
+
+    std::memcpy(halves, &mask, sizeof(halves));
+
+    if (halves[0] != 0) {
+
+        return __builtin_ctzll(halves[0]) / 8;
+    }
+
+    if (halves[1] != 0) {
+
+        return 8 + __builtin_ctzll(halves[1]) / 8;
+    }
+
+    return 16;
+}
+
+// One bit per lane of a comparison result, lane 0 in the lowest bit, like
+// SSE's movemask. Each half's lane tops are gathered into its top byte by a
+// multiply, since NEON has no single instruction for it.
+
+inline uint32_t simdLaneBits(
+    const SimdByte16& mask)
+{
+    uint64_t halves[2];
+
+    std::memcpy(halves, &mask, sizeof(halves));
+
+    const auto gather = [](uint64_t half) {
+        return uint32_t(((half & 0x8080808080808080ull) * 0x0002040810204081ull) >> 56);
+    };
+
+    return gather(halves[0]) | (gather(halves[1]) << 8);
+}
+
+// (x0, y0, x1, y1) -> (y0, x0, y1, x1)
+
+inline SimdFloat4 simdSwapPairs(
+    const SimdFloat4& value)
+{
+    return SimdFloat4 { value[1], value[0], value[3], value[2] };
+}
+
+inline SimdDouble2 simdSwapPairs(
+    const SimdDouble2& value)
+{
+    return SimdDouble2 { value[1], value[0] };
+}
+
+inline SimdFloat4 simdMin(
+    const SimdFloat4& a,
+    const SimdFloat4& b)
+{
+    return a < b ? a : b;
+}
+
+inline SimdFloat4 simdMax(
+    const SimdFloat4& a,
+    const SimdFloat4& b)
+{
+    return a > b ? a : b;
+}
+
+inline SimdFloat4 simdSqrt(
+    const SimdFloat4& value)
+{
+    return SimdFloat4 {
+        __builtin_sqrtf(value[0]),
+        __builtin_sqrtf(value[1]),
+        __builtin_sqrtf(value[2]),
+        __builtin_sqrtf(value[3]),
+    };
+}
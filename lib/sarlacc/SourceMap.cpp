@@ -0,0 +1,134 @@
+#include "SourceMap.h"
+
+#include <algorithm>
+
+#include "Error.h"
+#include "Simd.h"
+
+// source maps
+
+SourceMap::SourceMap(
+    std::string_view source)
+    : m_source(source)
+{
+}
+
+const std::vector<uint32_t>& SourceMap::lineStarts() const
+{
+    std::call_once(m_built, [this]() {
+        const auto* data = m_source.data();
+
+        const auto size = m_source.size();
+
+        m_lineStarts.reserve(size / 32 + 1);
+
+        m_lineStarts.push_back(0);
+
+        const auto needle = simdSplatByte('\n');
+
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16) {
+
+            auto bits = simdLaneBits(simdLoad(data + i) == needle);
+
+            while (bits != 0) {
+
+                m_lineStarts.push_back(uint32_t(i + __builtin_ctz(bits) + 1));
+
+                bits &= bits - 1;
+            }
+        }
+
+        for (; i < size; ++i) {
+
+            if (data[i] == '\n') {
+
+                m_lineStarts.push_back(uint32_t(i + 1));
+            }
+        }
+    });
+
+    return m_lineStarts;
+}
+
+const SourcePosition SourceMap::position(
+    int offset) const
+{
+    const auto& starts = lineStarts();
+
+    const auto clamped = uint32_t(std::clamp(offset, 0, int(m_source.size())));
+
+    // the last line starting at or before the offset
+
+    const auto line = std::upper_bound(starts.begin(), starts.end(), clamped) - starts.begin();
+
+    return { int(line), int(clamped - starts[line - 1]) + 1 };
+}
+
+const std::string_view SourceMap::line(
+    int line) const
+{
+    const auto& starts = lineStarts();
+
+    if (line < 1 || size_t(line) > starts.size()) {
+
+        return { };
+    }
+
+    const auto start = size_t(starts[line - 1]);
+
+    auto end = size_t(line) < starts.size() ? size_t(starts[line]) - 1 : m_source.size();
+
+    if (end > start && m_source[end - 1] == '\r') {
+
+        --end;
+    }
+
+    return m_source.substr(start, end - start);
+}
+
+const int SourceMap::lineCount() const
+{
+    return int(lineStarts().size());
+}
+
+///
+
+const std::string SourceMap::describe(
+    const SourceLocation& location) const
+{
+    const auto start = position(location.start);
+
+    auto out = std::to_string(start.line) + ":" + std::to_string(start.column);
+
+    // locations end one past their last character
+
+    if (location.end > location.start + 1) {
+
+        const auto end = position(location.end - 1);
+
+        out += "-" + std::to_string(end.line) + ":" + std::to_string(end.column);
+    }
+
+    return out;
+}
+
+const std::string SourceMap::describe(
+    const Error& error) const
+{
+    const auto& location = error.location();
+
+    if (!location) {
+
+        return std::string(error.message());
+    }
+
+    auto out = describe(*location);
+
+    out += ": ";
+
+    out += error.message();
+
+    return out;
+}
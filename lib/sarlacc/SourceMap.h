@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SourceLocation.h"
+
+// source maps
+
+class Error;
+
+// Both 1-based; columns count bytes.
+
+struct SourcePosition {
+    int line;
+    int column;
+};
+
+// Maps byte offsets in a source to lines and columns. The table of line
+// starts is built on the first query, in one vectorised pass over the source,
+// and each query after that is a binary search, so reporting many errors in a
+// large input costs one scan rather than one per error. Sources that never
+// fail are never scanned.
+//
+// Queries may come from any number of threads. A map views its source, which
+// must outlive it; lexers, parsers and errors share one through a shared_ptr.
+
+class SourceMap final {
+public:
+    explicit SourceMap(
+        std::string_view source);
+
+    SourceMap(const SourceMap&) = delete;
+
+    SourceMap& operator=(const SourceMap&) = delete;
+
+    ///
+
+    // Offsets past the end map to just after the last character.
+
+    const SourcePosition position(
+        int offset) const;
+
+    // The text of `line`, without its line break; empty past the last line.
+
+    const std::string_view line(
+        int line) const;
+
+    const int lineCount() const;
+
+    ///
+
+    // "line:column", or "line:column-line:column" for a range.
+
+    const std::string describe(
+        const SourceLocation& location) const;
+
+    // "line:column: message", or just the message for errors without a
+    // location.
+
+    const std::string describe(
+        const Error& error) const;
+
+    const std::string_view source() const { return m_source; }
+
+private:
+    const std::vector<uint32_t>& lineStarts() const;
+
+    const std::string_view m_source;
+
+    mutable std::once_flag m_built;
+
+    mutable std::vector<uint32_t> m_lineStarts;
+};
@@ -0,0 +1,605 @@
+#include "SvgScanner.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "Simd.h"
+
+// svg scanning
+
+namespace {
+
+const char* findByte(
+    const char* p,
+    const char* end,
+    char value)
+{
+    const auto needle = simdSplatByte(value);
+
+    for (; p + 16 <= end; p += 16) {
+
+        const auto lane = simdFirstSet(simdLoad(p) == needle);
+
+        if (lane < 16) {
+
+            return p + lane;
+        }
+    }
+
+    for (; p < end; ++p) {
+
+        if (*p == value) {
+
+            return p;
+        }
+    }
+
+    return nullptr;
+}
+
+const char* findSequence(
+    const char* p,
+    const char* end,
+    std::string_view sequence)
+{
+    while ((p = findByte(p, end, sequence[0])) != nullptr) {
+
+        if (size_t(end - p) < sequence.size()) {
+
+            return nullptr;
+        }
+
+        if (std::string_view(p, sequence.size()) == sequence) {
+
+            return p;
+        }
+
+        ++p;
+    }
+
+    return nullptr;
+}
+
+// 1 when [p, end) starts with `prefix`, 0 when it cannot, -1 when it is too short
+// to tell
+
+int startsWith(
+    const char* p,
+    const char* end,
+    std::string_view prefix)
+{
+    const auto available = std::min(size_t(end - p), prefix.size());
+
+    if (std::string_view(p, available) != prefix.substr(0, available)) {
+
+        return 0;
+    }
+
+    return available == prefix.size() ? 1 : -1;
+}
+
+bool isSpace(
+    char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+const char* skipSpace(
+    const char* p,
+    const char* end)
+{
+    while (p < end && isSpace(*p)) {
+
+        ++p;
+    }
+
+    return p;
+}
+
+std::string_view trim(
+    std::string_view value)
+{
+    while (!value.empty() && isSpace(value.front())) {
+
+        value.remove_prefix(1);
+    }
+
+    while (!value.empty() && isSpace(value.back())) {
+
+        value.remove_suffix(1);
+    }
+
+    return value;
+}
+
+// the value of `fill-rule` within a style declaration list, if it has one
+
+std::optional<std::string_view> styleFillRule(
+    std::string_view style)
+{
+    for (size_t at = style.find("fill-rule"); at != std::string_view::npos; at = style.find("fill-rule", at + 1)) {
+
+        auto rest = style.substr(at + 9);
+
+        const auto colon = rest.find_first_not_of(" \t\n\r");
+
+        if (colon == std::string_view::npos || rest[colon] != ':') {
+
+            continue;
+        }
+
+        rest = rest.substr(colon + 1);
+
+        return trim(rest.substr(0, rest.find(';')));
+    }
+
+    return std::nullopt;
+}
+
+///
+
+// Steps over the markup starting at the '<' at `p`, reporting it if it is a path
+// element. Returns the byte after it, or null when it does not end before `end`.
+
+const char* scanMarkup(
+    const char* p,
+    const char* end,
+    uint64_t offset,
+    const SvgScanner::Callback& callback)
+{
+    auto* q = p + 1;
+
+    if (q >= end) {
+
+        return nullptr;
+    }
+
+    if (*q == '!') {
+
+        const auto comment = startsWith(q, end, "!--");
+
+        const auto cdata = startsWith(q, end, "![CDATA[");
+
+        if (comment < 0 || cdata < 0) {
+
+            return nullptr;
+        }
+
+        if (comment > 0) {
+
+            const auto* close = findSequence(q + 3, end, "-->");
+
+            return close != nullptr ? close + 3 : nullptr;
+        }
+
+        if (cdata > 0) {
+
+            const auto* close = findSequence(q + 8, end, "]]>");
+
+            return close != nullptr ? close + 3 : nullptr;
+        }
+
+        // a declaration, whose internal subset may hold quoted '>' of its own
+
+        auto depth = 0;
+
+        for (++q; q < end; ++q) {
+
+            if (*q == '"' || *q == '\'') {
+
+                q = findByte(q + 1, end, *q);
+
+                if (q == nullptr) {
+
+                    return nullptr;
+                }
+            } else if (*q == '[') {
+
+                ++depth;
+            } else if (*q == ']') {
+
+                --depth;
+            } else if (*q == '>' && depth <= 0) {
+
+                return q + 1;
+            }
+        }
+
+        return nullptr;
+    }
+
+    if (*q == '?') {
+
+        const auto* close = findSequence(q + 1, end, "?>");
+
+        return close != nullptr ? close + 2 : nullptr;
+    }
+
+    if (*q == '/') {
+
+        const auto* close = findByte(q + 1, end, '>');
+
+        return close != nullptr ? close + 1 : nullptr;
+    }
+
+    ///
+
+    const auto* name = q;
+
+    while (q < end && !isSpace(*q) && *q != '/' && *q != '>') {
+
+        ++q;
+    }
+
+    if (q >= end) {
+
+        return nullptr;
+    }
+
+    const auto tag = std::string_view(name, q - name);
+
+    const auto isPath = tag == "path" || (tag.size() > 5 && tag.ends_with(":path"));
+
+    std::optional<std::string_view> data;
+
+    std::string_view transform, fillRule, style;
+
+    while (true) {
+
+        q = skipSpace(q, end);
+
+        if (q >= end) {
+
+            return nullptr;
+        }
+
+        if (*q == '>') {
+
+            ++q;
+
+            break;
+        }
+
+        if (*q == '/') {
+
+            ++q;
+
+            continue;
+        }
+
+        const auto* attribute = q;
+
+        while (q < end && *q != '=' && !isSpace(*q) && *q != '>' && *q != '/') {
+
+            ++q;
+        }
+
+        const auto key = std::string_view(attribute, q - attribute);
+
+        q = skipSpace(q, end);
+
+        if (q >= end) {
+
+            return nullptr;
+        }
+
+        if (*q != '=') {
+
+            continue;
+        }
+
+        q = skipSpace(q + 1, end);
+
+        if (q >= end) {
+
+            return nullptr;
+        }
+
+        std::string_view value;
+
+        if (*q == '"' || *q == '\'') {
+
+            const auto* close = findByte(q + 1, end, *q);
+
+            if (close == nullptr) {
+
+                return nullptr;
+            }
+
+            value = std::string_view(q + 1, close - q - 1);
+
+            q = close + 1;
+        } else {
+
+            // not XML, but cheap to tolerate
+
+            const auto* start = q;
+
+            while (q < end && !isSpace(*q) && *q != '>') {
+
+                ++q;
+            }
+
+            value = std::string_view(start, q - start);
+        }
+
+        if (!isPath) {
+
+            continue;
+        }
+
+        if (key == "d") {
+
+            data = value;
+        } else if (key == "transform") {
+
+            transform = value;
+        } else if (key == "fill-rule") {
+
+            fillRule = value;
+        } else if (key == "style") {
+
+            style = value;
+        }
+    }
+
+    if (isPath && data) {
+
+        // a style declaration outranks the presentation attribute
+
+        const auto rule = styleFillRule(style).value_or(fillRule);
+
+        callback({ *data, transform, SvgScanner::parseFillRule(rule), offset });
+    }
+
+    return q;
+}
+
+}
+
+SvgScanner::SvgScanner(
+    Callback callback)
+    : m_callback(std::move(callback))
+{
+}
+
+void SvgScanner::scan(
+    std::string_view chunk)
+{
+    const auto* p = chunk.data();
+
+    const auto* end = p + chunk.size();
+
+    // finish a tag left open by the last chunk, a '>' at a time, since only a
+    // '>' can end one
+
+    if (!m_pending.empty()) {
+
+        while (true) {
+
+            const auto* close = findByte(p, end, '>');
+
+            if (close == nullptr) {
+
+                m_pending.append(p, end);
+
+                m_offset += chunk.size();
+
+                return;
+            }
+
+            m_pending.append(p, close + 1);
+
+            p = close + 1;
+
+            const auto* pending = m_pending.data();
+
+            if (scanMarkup(pending, pending + m_pending.size(), m_pendingOffset, m_callback) != nullptr) {
+
+                break;
+            }
+        }
+
+        m_pending.clear();
+    }
+
+    ///
+
+    while (p < end) {
+
+        const auto* open = findByte(p, end, '<');
+
+        if (open == nullptr) {
+
+            break;
+        }
+
+        const auto offset = m_offset + uint64_t(open - chunk.data());
+
+        const auto* next = scanMarkup(open, end, offset, m_callback);
+
+        if (next == nullptr) {
+
+            m_pending.assign(open, end);
+
+            m_pendingOffset = offset;
+
+            break;
+        }
+
+        p = next;
+    }
+
+    m_offset += chunk.size();
+}
+
+const std::optional<Error> SvgScanner::finish()
+{
+    if (m_pending.empty()) {
+
+        return std::nullopt;
+    }
+
+    m_pending.clear();
+
+    return Error(ErrorType::Parser, ErrorCode::UnexpectedEof, "SVG ends inside the tag at byte " + std::to_string(m_pendingOffset));
+}
+
+const std::optional<Error> SvgScanner::scanDocument(
+    std::string_view document,
+    const Callback& callback)
+{
+    SvgScanner scanner(callback);
+
+    scanner.scan(document);
+
+    return scanner.finish();
+}
+
+///
+
+const PathFillRule SvgScanner::parseFillRule(
+    std::string_view value)
+{
+    return trim(value) == "evenodd" ? PathFillRule::EvenOdd : PathFillRule::NonZero;
+}
+
+namespace {
+
+const PathMatrix affine(
+    double a,
+    double b,
+    double c,
+    double d,
+    double e,
+    double f)
+{
+    return PathMatrix { {
+        { a, b, 0 },
+        { c, d, 0 },
+        { e, f, 1 },
+    } };
+}
+
+}
+
+const std::optional<PathMatrix> SvgScanner::parseTransform(
+    std::string_view value)
+{
+    auto matrix = PathMatrix::makeIdentity();
+
+    const auto* p = value.data();
+
+    const auto* end = p + value.size();
+
+    std::vector<double> arguments;
+
+    while (true) {
+
+        while (p < end && (isSpace(*p) || *p == ',')) {
+
+            ++p;
+        }
+
+        if (p >= end) {
+
+            return matrix;
+        }
+
+        const auto* name = p;
+
+        while (p < end && std::isalpha(static_cast<unsigned char>(*p))) {
+
+            ++p;
+        }
+
+        const auto function = std::string_view(name, p - name);
+
+        p = skipSpace(p, end);
+
+        if (p >= end || *p != '(') {
+
+            return std::nullopt;
+        }
+
+        ++p;
+
+        arguments.clear();
+
+        while (true) {
+
+            while (p < end && (isSpace(*p) || *p == ',')) {
+
+                ++p;
+            }
+
+            if (p >= end) {
+
+                return std::nullopt;
+            }
+
+            if (*p == ')') {
+
+                ++p;
+
+                break;
+            }
+
+            // from_chars takes no leading '+'
+
+            const auto* start = p < end && *p == '+' ? p + 1 : p;
+
+            double number;
+
+            const auto [next, error] = std::from_chars(start, end, number);
+
+            if (error != std::errc()) {
+
+                return std::nullopt;
+            }
+
+            arguments.push_back(number);
+
+            p = next;
+        }
+
+        ///
+
+        const auto count = arguments.size();
+
+        const auto radians = [](double degrees) { return degrees * std::numbers::pi / 180; };
+
+        if (function == "matrix" && count == 6) {
+
+            matrix = matrix * affine(arguments[0], arguments[1], arguments[2], arguments[3], arguments[4], arguments[5]);
+        } else if (function == "translate" && (count == 1 || count == 2)) {
+
+            matrix = matrix * PathMatrix::makeTranslate(arguments[0], count == 2 ? arguments[1] : 0);
+        } else if (function == "scale" && (count == 1 || count == 2)) {
+
+            matrix = matrix * PathMatrix::makeScale(arguments[0], count == 2 ? arguments[1] : arguments[0]);
+        } else if (function == "rotate" && (count == 1 || count == 3)) {
+
+            // SVG turns +x towards +y, the opposite of makeZRotate
+
+            const auto c = std::cos(radians(arguments[0])), s = std::sin(radians(arguments[0]));
+
+            const auto cx = count == 3 ? arguments[1] : 0, cy = count == 3 ? arguments[2] : 0;
+
+            matrix = matrix * affine(c, s, -s, c, cx - c * cx + s * cy, cy - s * cx - c * cy);
+        } else if (function == "skewX" && count == 1) {
+
+            matrix = matrix * affine(1, 0, std::tan(radians(arguments[0])), 1, 0, 0);
+        } else if (function == "skewY" && count == 1) {
+
+            matrix = matrix * affine(1, std::tan(radians(arguments[0])), 0, 1, 0, 0);
+        } else {
+
+            return std::nullopt;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Error.h"
+#include "PathBuffer.h"
+#include "PathTransform.h"
+
+// svg scanning
+
+// The attributes of one `<path>` element, as views of the scanned bytes. They
+// are only valid during the callback: for a document scanned in one piece they
+// point into the caller's memory, for a stream they may point into the scanner's
+// own carry-over buffer. Attribute values are raw bytes, without entities
+// decoded, and only the element's own attributes are seen, not those it would
+// inherit from enclosing groups.
+
+struct SvgPathElement {
+    std::string_view data;
+    std::string_view transform;
+    PathFillRule fillRule;
+    // of the element's '<' from the start of the stream
+    uint64_t offset;
+};
+
+// Finds path elements without building a tree. Text between tags is skipped
+// sixteen bytes at a time looking for '<', and attribute values are skipped the
+// same way looking for their closing quote, so long `d` attributes cost about
+// as much as reading them. Comments, CDATA sections, processing instructions
+// and declarations are stepped over whole.
+//
+// Feed a document in chunks of any size with `scan` and end it with `finish`;
+// only a tag split across two chunks is copied.
+
+class SvgScanner final {
+public:
+    using Callback = std::function<void(const SvgPathElement&)>;
+
+    explicit SvgScanner(
+        Callback callback);
+
+    void scan(
+        std::string_view chunk);
+
+    // Fails when the stream ended inside a tag.
+
+    const std::optional<Error> finish();
+
+    ///
+
+    static const std::optional<Error> scanDocument(
+        std::string_view document,
+        const Callback& callback);
+
+    // `fill-rule` from a `fill-rule` attribute or a `style` declaration;
+    // anything but "evenodd" is the default, nonzero.
+
+    static const PathFillRule parseFillRule(
+        std::string_view value);
+
+    // An SVG transform list: matrix, translate, scale, rotate, skewX and skewY,
+    // applied right to left as in SVG. Returns nothing for malformed lists.
+
+    static const std::optional<PathMatrix> parseTransform(
+        std::string_view value);
+
+private:
+    Callback m_callback;
+
+    std::string m_pending;
+
+    uint64_t m_pendingOffset = 0;
+
+    uint64_t m_offset = 0;
+};